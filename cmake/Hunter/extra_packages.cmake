@@ -18,3 +18,4 @@ hunter_add_package(abseil)
 hunter_add_package(benchmark)
 hunter_add_package(Boost)
 hunter_add_package(CLI11)
+hunter_add_package(lz4)
@@ -0,0 +1,112 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <memory>
+#include <random>
+
+#include <benchmark/benchmark.h>
+#include <boost/endian/conversion.hpp>
+
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/db/buffer.hpp>
+#include <silkworm/db/tables.hpp>
+
+using namespace silkworm;
+
+static constexpr size_t kBatchSize{512 * kMebi};
+static constexpr size_t kAddresses{100'000};
+static constexpr size_t kChangesPerBlock{100};
+
+static evmc::address address_of(uint64_t i) {
+    evmc::address address;
+    boost::endian::store_big_u64(&address.bytes[kAddressLength - 8], i);
+    return address;
+}
+
+static evmc::bytes32 bytes32_of(uint64_t i) {
+    evmc::bytes32 bytes;
+    boost::endian::store_big_u64(&bytes.bytes[kHashLength - 8], i);
+    return bytes;
+}
+
+// Fills the buffer with blocks of account & storage changes, receipts and logs up to kBatchSize
+static void fill_buffer(db::Buffer& buffer, uint64_t& block_number, std::mt19937_64& rng) {
+    std::vector<Receipt> receipts(kChangesPerBlock);
+    for (Receipt& receipt : receipts) {
+        receipt.success = true;
+        receipt.logs.resize(1);
+        receipt.logs[0].topics.resize(2);
+        receipt.logs[0].data.resize(64);
+    }
+
+    while (buffer.current_batch_size() < kBatchSize) {
+        buffer.begin_block(++block_number);
+        for (size_t i{0}; i < kChangesPerBlock; ++i) {
+            const evmc::address address{address_of(rng() % kAddresses)};
+            buffer.update_storage(address, 1, bytes32_of(rng()), {}, bytes32_of(rng()));
+            Account account;
+            account.nonce = block_number;
+            account.incarnation = 1;
+            buffer.update_account(address, std::nullopt, account);
+
+            receipts[i].cumulative_gas_used = 21'000 * (i + 1);
+            receipts[i].logs[0].address = address;
+            receipts[i].logs[0].topics[0] = bytes32_of(rng());
+        }
+        buffer.insert_receipts(block_number, receipts);
+    }
+}
+
+// Latency of writing a kBatchSize batch to the DB and committing it.
+// Unless state.range(0) is set, entries keyed past those of any block keep the batches from being appended.
+static void buffer_commit(benchmark::State& state) {
+    TemporaryDirectory tmp_dir;
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 8 * kGibi};
+    db_config.set_readonly(false);
+    auto env{lmdb::get_env(db_config)};
+
+    auto txn{env->begin_rw_transaction()};
+    db::table::create_all(*txn);
+    if (!state.range(0)) {
+        const Bytes last_key(8, '\xff');
+        txn->open(db::table::kPlainAccountChangeSet)->put(last_key, full_view(address_of(0)));
+        txn->open(db::table::kPlainStorageChangeSet)->put(last_key, full_view(bytes32_of(0)));
+        txn->open(db::table::kBlockReceipts)->put(last_key, {});
+        txn->open(db::table::kLogs)->put(last_key, {});
+    }
+    lmdb::err_handler(txn->commit());
+    txn.reset();
+
+    std::mt19937_64 rng{kBatchSize};
+    uint64_t block_number{0};
+    std::unique_ptr<db::Buffer> buffer;
+    for (auto _ : state) {
+        state.PauseTiming();
+        buffer.reset();
+        txn = env->begin_rw_transaction();
+        buffer = std::make_unique<db::Buffer>(txn.get());
+        fill_buffer(*buffer, block_number, rng);
+        state.ResumeTiming();
+
+        buffer->write_to_db();
+        lmdb::err_handler(txn->commit());
+    }
+    state.counters["blocks"] = static_cast<double>(block_number);
+}
+
+BENCHMARK(buffer_commit)->ArgName("append")->Arg(0)->Arg(1)->Iterations(3)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
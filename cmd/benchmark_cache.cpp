@@ -0,0 +1,158 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <evmone/analysis.hpp>
+
+#include <silkworm/common/base.hpp>
+#include <silkworm/common/clock_cache.hpp>
+#include <silkworm/common/lru_cache.hpp>
+#include <silkworm/execution/analysis_cache.hpp>
+#include <silkworm/execution/state_pool.hpp>
+
+namespace {
+
+using namespace silkworm;
+
+/*
+ * Sequence of code hashes of called contracts : call frequencies of mainnet contracts are heavily
+ * skewed (a few tokens, exchanges and proxies get most of the calls) so contracts are
+ * drawn from a Zipf distribution over a population larger than the cache.
+ */
+const std::vector<evmc::bytes32>& call_trace() {
+    static constexpr size_t kNumContracts{50'000};
+    static constexpr size_t kNumCalls{1'000'000};
+    static constexpr double kSkew{1.0};
+
+    static const std::vector<evmc::bytes32> trace{[] {
+        std::mt19937_64 rng{42};
+
+        std::vector<evmc::bytes32> code_hashes(kNumContracts);
+        for (auto& hash : code_hashes) {
+            for (size_t i{0}; i < kHashLength; i += sizeof(uint64_t)) {
+                const uint64_t word{rng()};
+                std::memcpy(&hash.bytes[i], &word, sizeof(word));
+            }
+        }
+
+        std::vector<double> cdf(kNumContracts);
+        double sum{0};
+        for (size_t i{0}; i < kNumContracts; ++i) {
+            sum += 1.0 / std::pow(static_cast<double>(i + 1), kSkew);
+            cdf[i] = sum;
+        }
+
+        std::uniform_real_distribution<double> uniform{0, sum};
+        std::vector<evmc::bytes32> calls(kNumCalls);
+        for (auto& call : calls) {
+            const auto it{std::lower_bound(cdf.begin(), cdf.end(), uniform(rng))};
+            call = code_hashes[std::min<size_t>(static_cast<size_t>(it - cdf.begin()), kNumContracts - 1)];
+        }
+        return calls;
+    }()};
+
+    return trace;
+}
+
+// Same access pattern as EVM::execute with an AnalysisCache : get and put on miss
+template <class Cache>
+void analysis_cache_trace(benchmark::State& state) {
+    const auto& trace{call_trace()};
+    const auto value{std::make_shared<int>(0)};
+
+    size_t hits{0};
+    for (auto _ : state) {
+        Cache cache(static_cast<size_t>(state.range(0)));
+        for (const auto& code_hash : trace) {
+            if (cache.get(code_hash)) {
+                ++hits;
+            } else {
+                cache.put(code_hash, value);
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * trace.size()));
+    state.counters["hit_rate"] = static_cast<double>(hits) / static_cast<double>(state.iterations() * trace.size());
+}
+
+void lru_cache_trace(benchmark::State& state) {
+    analysis_cache_trace<lru_cache<evmc::bytes32, std::shared_ptr<int>>>(state);
+}
+
+void clock_cache_trace(benchmark::State& state) {
+    analysis_cache_trace<ClockCache<evmc::bytes32, std::shared_ptr<int>>>(state);
+}
+
+// Threads replaying (different parts of) the same trace against a shared AnalysisCache
+void shared_analysis_cache_trace(benchmark::State& state) {
+    static AnalysisCache cache;
+    const auto& trace{call_trace()};
+    const auto value{std::make_shared<evmone::AdvancedCodeAnalysis>()};
+    const size_t offset{trace.size() / static_cast<size_t>(state.threads) * static_cast<size_t>(state.thread_index)};
+
+    size_t hits{0};
+    for (auto _ : state) {
+        for (size_t i{0}; i < trace.size(); ++i) {
+            const evmc::bytes32& code_hash{trace[(offset + i) % trace.size()]};
+            if (cache.get(code_hash, EVMC_BERLIN)) {
+                ++hits;
+            } else {
+                cache.put(code_hash, value, EVMC_BERLIN);
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * trace.size()));
+    const double hit_rate{static_cast<double>(hits) / static_cast<double>(state.iterations() * trace.size())};
+    state.counters["hit_rate"] = benchmark::Counter(hit_rate, benchmark::Counter::kAvgThreads);
+}
+
+// Call frames of nested depth state.range(0) acquiring & releasing execution states from a shared pool
+void shared_state_pool(benchmark::State& state) {
+    static ExecutionStatePool pool;
+    const auto depth{static_cast<size_t>(state.range(0))};
+    std::vector<std::unique_ptr<evmone::AdvancedExecutionState>> frames(depth);
+
+    for (auto _ : state) {
+        for (auto& frame : frames) {
+            frame = pool.acquire();
+        }
+        for (auto& frame : frames) {
+            pool.release(std::move(frame));
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * depth));
+}
+
+}  // namespace
+
+BENCHMARK(lru_cache_trace)->Arg(AnalysisCache::kDefaultMaxSize)->Arg(4 * AnalysisCache::kDefaultMaxSize);
+BENCHMARK(clock_cache_trace)->Arg(AnalysisCache::kDefaultMaxSize)->Arg(4 * AnalysisCache::kDefaultMaxSize);
+BENCHMARK(shared_analysis_cache_trace)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
+BENCHMARK(shared_state_pool)->Arg(4)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,123 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include <random>
+
+#include <benchmark/benchmark.h>
+#include <boost/endian/conversion.hpp>
+
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/db/access_layer.hpp>
+#include <silkworm/db/tables.hpp>
+
+using namespace silkworm;
+
+static constexpr size_t kAccounts{100'000};
+static constexpr size_t kLookups{1'000};
+
+static evmc::address address_of(uint64_t i) {
+    evmc::address address;
+    boost::endian::store_big_u64(&address.bytes[kAddressLength - 8], i);
+    return address;
+}
+
+static evmc::bytes32 bytes32_of(uint64_t i) {
+    evmc::bytes32 bytes;
+    boost::endian::store_big_u64(&bytes.bytes[kHashLength - 8], i);
+    return bytes;
+}
+
+// Contracts, each with a storage slot, in the plain state
+class SyntheticDb {
+  public:
+    SyntheticDb() {
+        lmdb::DatabaseConfig db_config{tmp_dir_.path(), 1 * kGibi};
+        db_config.set_readonly(false);
+        env_ = lmdb::get_env(db_config);
+        auto txn{env_->begin_rw_transaction()};
+        db::table::create_all(*txn);
+
+        auto state_table{txn->open(db::table::kPlainState)};
+        for (uint64_t i{0}; i < kAccounts; ++i) {
+            Account account;
+            account.nonce = i;
+            account.incarnation = 1;
+            state_table->put(full_view(address_of(i)), account.encode_for_storage());
+            Bytes data{full_view(bytes32_of(i))};
+            data.push_back(0x01);
+            state_table->put(db::storage_prefix(full_view(address_of(i)), account.incarnation), data);
+        }
+        state_table.reset();
+        lmdb::err_handler(txn->commit());
+    }
+
+    lmdb::Environment& env() { return *env_; }
+
+  private:
+    TemporaryDirectory tmp_dir_;
+    std::shared_ptr<lmdb::Environment> env_;
+};
+
+static SyntheticDb& synthetic_db() {
+    static SyntheticDb db;
+    return db;
+}
+
+// Point reads of accounts & storage as done by db::Buffer during execution,
+// each of which opens the plain state table anew (state.range(0) == 0),
+// against lookups through a single table kept open (state.range(0) == 1).
+// Comparing runs of this benchmark across revisions tells the cost of Transaction::open.
+static void state_point_reads(benchmark::State& state) {
+    const bool single_table{state.range(0) != 0};
+    auto txn{synthetic_db().env().begin_ro_transaction()};
+    auto state_table{txn->open(db::table::kPlainState)};
+
+    std::mt19937_64 rng{kAccounts};
+    for (auto _ : state) {
+        for (size_t i{0}; i < kLookups; ++i) {
+            const uint64_t n{rng() % kAccounts};
+            const evmc::address address{address_of(n)};
+            if (single_table) {
+                benchmark::DoNotOptimize(state_table->get(full_view(address)));
+                benchmark::DoNotOptimize(state_table->get(db::storage_prefix(full_view(address), 1),
+                                                          full_view(bytes32_of(n))));
+            } else {
+                benchmark::DoNotOptimize(db::read_account(*txn, address));
+                benchmark::DoNotOptimize(db::read_storage(*txn, address, 1, bytes32_of(n)));
+            }
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kLookups * 2));
+}
+
+BENCHMARK(state_point_reads)->ArgName("single_table")->Arg(0)->Arg(1);
+
+// Short read only transactions, as served to concurrent readers
+static void short_ro_transactions(benchmark::State& state) {
+    const bool pooled{state.range(0) != 0};
+    lmdb::Environment& env{synthetic_db().env()};
+
+    std::mt19937_64 rng{kAccounts};
+    for (auto _ : state) {
+        auto txn{pooled ? env.begin_pooled_ro_transaction() : env.begin_ro_transaction()};
+        benchmark::DoNotOptimize(db::read_account(*txn, address_of(rng() % kAccounts)));
+    }
+}
+
+BENCHMARK(short_ro_transactions)->ArgName("pooled")->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
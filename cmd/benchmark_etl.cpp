@@ -0,0 +1,154 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <filesystem>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/etl/collector.hpp>
+
+using namespace silkworm;
+
+// Hashed keys as in hashstate & tx_lookup
+static std::vector<etl::Entry> generate_entries(size_t count) {
+    std::mt19937_64 rng{count};
+    std::vector<etl::Entry> entries(count);
+    for (auto& entry : entries) {
+        entry.key.resize(kHashLength);
+        for (size_t i{0}; i < kHashLength; i += sizeof(uint64_t)) {
+            const uint64_t x{rng()};
+            std::memcpy(&entry.key[i], &x, sizeof(x));
+        }
+        entry.value.resize(sizeof(uint64_t));
+        const uint64_t x{rng()};
+        std::memcpy(&entry.value[0], &x, sizeof(x));
+    }
+    return entries;
+}
+
+// Collects and loads (without persisting) 4M entries spilled to disk in 8 runs
+static void etl_collect_and_load(benchmark::State& state) {
+    const bool parallel{state.range(0) != 0};
+    static const auto entries{generate_entries(4'000'000)};
+    const size_t run_size{entries.size() * (kHashLength + sizeof(uint64_t)) / 8};
+
+    for (auto _ : state) {
+        TemporaryDirectory etl_tmp_dir;  // Removed by collector on destruction
+        etl::Collector collector{etl_tmp_dir.path(), run_size, parallel};
+        for (const auto& entry : entries) {
+            collector.collect(entry);
+        }
+        collector.load(/*table=*/nullptr, [](etl::EntryView entry, lmdb::Table*, unsigned) {
+            benchmark::DoNotOptimize(entry.key.data());
+        });
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * entries.size()));
+}
+
+BENCHMARK(etl_collect_and_load)->ArgName("parallel")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Key distributions resembling those of the stages spilling most data
+enum class Distribution { kHashedStorage = 0, kHistoryIndex = 1, kTxLookup = 2 };
+
+static std::vector<etl::Entry> generate_entries(Distribution distribution, size_t count) {
+    std::mt19937_64 rng{count};
+    const auto random_bytes{[&rng](size_t length) {
+        Bytes out(length, '\0');
+        for (auto& b : out) {
+            b = static_cast<uint8_t>(rng());
+        }
+        return out;
+    }};
+
+    // A pool of "hot" accounts which many keys share as prefix
+    std::vector<Bytes> accounts(count / 64 + 1);
+    for (auto& account : accounts) {
+        account = random_bytes(kHashLength + sizeof(uint64_t));
+    }
+
+    std::vector<etl::Entry> entries(count);
+    for (auto& entry : entries) {
+        const Bytes& account{accounts[rng() % accounts.size()]};
+        switch (distribution) {
+            case Distribution::kHashedStorage:
+                // hashed address + incarnation + hashed location -> small value
+                entry.key = account + random_bytes(kHashLength);
+                entry.value = random_bytes(1 + rng() % 8);
+                break;
+            case Distribution::kHistoryIndex:
+                // address + block number -> bitmap-like value with low entropy
+                entry.key = account.substr(0, kAddressLength) + random_bytes(sizeof(uint64_t));
+                entry.value = Bytes(32, '\0');
+                entry.value[rng() % entry.value.size()] = static_cast<uint8_t>(rng());
+                break;
+            case Distribution::kTxLookup:
+                // tx hash -> block number
+                entry.key = random_bytes(kHashLength);
+                entry.value = random_bytes(sizeof(uint64_t));
+                break;
+        }
+    }
+    return entries;
+}
+
+static size_t directory_size(const std::filesystem::path& path) {
+    size_t size{0};
+    for (const auto& file : std::filesystem::directory_iterator(path)) {
+        size += file.file_size();
+    }
+    return size;
+}
+
+// Compares raw vs compressed spill files on 1M entries spilled to disk in 8 runs
+static void etl_file_format(benchmark::State& state) {
+    const auto distribution{static_cast<Distribution>(state.range(0))};
+    const auto file_format{static_cast<etl::FileFormat>(state.range(1))};
+    const auto entries{generate_entries(distribution, 1'000'000)};
+    size_t data_size{0};
+    for (const auto& entry : entries) {
+        data_size += entry.size();
+    }
+
+    size_t spilled_bytes{0};
+    for (auto _ : state) {
+        TemporaryDirectory etl_tmp_dir;  // Removed by collector on destruction
+        etl::Collector collector{etl_tmp_dir.path(), data_size / 8, /*parallel=*/false, file_format};
+        for (const auto& entry : entries) {
+            collector.collect(entry);
+        }
+        spilled_bytes = directory_size(etl_tmp_dir.path());  // all runs but the last one still in memory
+        collector.load(/*table=*/nullptr, [](etl::EntryView entry, lmdb::Table*, unsigned) {
+            benchmark::DoNotOptimize(entry.key.data());
+        });
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * entries.size()));
+    state.counters["spilled_bytes"] = static_cast<double>(spilled_bytes);
+    state.counters["data_bytes"] = static_cast<double>(data_size);
+}
+
+BENCHMARK(etl_file_format)
+    ->ArgNames({"distribution", "compressed"})
+    ->Args({0, 0})
+    ->Args({0, 1})
+    ->Args({1, 0})
+    ->Args({1, 1})
+    ->Args({2, 0})
+    ->Args({2, 1})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
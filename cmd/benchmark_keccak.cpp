@@ -0,0 +1,68 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <silkworm/common/util.hpp>
+
+using namespace silkworm;
+
+static constexpr size_t kInputs{1024};
+
+// kInputs random inputs of state.range(0) bytes:
+// 20 for addresses, 32 for storage locations, ~110 for transactions, 500 for multi-block inputs
+static std::vector<Bytes> random_inputs(const benchmark::State& state) {
+    std::mt19937_64 rng{kInputs};
+    std::vector<Bytes> inputs(kInputs, Bytes(static_cast<size_t>(state.range(0)), '\0'));
+    for (Bytes& input : inputs) {
+        for (auto& byte : input) {
+            byte = static_cast<uint8_t>(rng());
+        }
+    }
+    return inputs;
+}
+
+static void keccak256_one_by_one(benchmark::State& state) {
+    const std::vector<Bytes> data{random_inputs(state)};
+    std::vector<ethash::hash256> hashes(data.size());
+    for (auto _ : state) {
+        for (size_t i{0}; i < data.size(); ++i) {
+            hashes[i] = keccak256(data[i]);
+        }
+        benchmark::DoNotOptimize(hashes.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+
+BENCHMARK(keccak256_one_by_one)->ArgName("size")->Arg(20)->Arg(32)->Arg(110)->Arg(500);
+
+static void keccak256_batched(benchmark::State& state) {
+    const std::vector<Bytes> data{random_inputs(state)};
+    const std::vector<ByteView> inputs(data.begin(), data.end());
+    std::vector<ethash::hash256> hashes(data.size());
+    for (auto _ : state) {
+        keccak256_many(inputs.data(), inputs.size(), hashes.data());
+        benchmark::DoNotOptimize(hashes.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+
+BENCHMARK(keccak256_batched)->ArgName("size")->Arg(20)->Arg(32)->Arg(110)->Arg(500);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,174 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <map>
+#include <random>
+
+#include <benchmark/benchmark.h>
+#include <boost/endian/conversion.hpp>
+
+#include <silkworm/common/cast.hpp>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/db/log_filter.hpp>
+#include <silkworm/db/tables.hpp>
+#include <silkworm/db/util.hpp>
+#include <silkworm/types/log_cbor.hpp>
+
+using namespace silkworm;
+
+static constexpr uint32_t kBlocks{20'000};
+static constexpr size_t kTransactionsPerBlock{8};
+static constexpr size_t kAddresses{2'000};
+static constexpr size_t kEvents{100};
+static constexpr size_t kTopicValues{20'000};
+
+static evmc::address address_of(size_t i) {
+    evmc::address address;
+    boost::endian::store_big_u64(&address.bytes[kAddressLength - 8], i + 1);
+    return address;
+}
+
+static evmc::bytes32 topic_of(size_t i) {
+    evmc::bytes32 topic;
+    boost::endian::store_big_u64(&topic.bytes[kHashLength - 8], i + 1);
+    return topic;
+}
+
+static void write_index(lmdb::Table& table, std::map<Bytes, roaring::Roaring>& bitmaps) {
+    for (auto& [key, bitmap] : bitmaps) {
+        while (bitmap.cardinality() > 0) {
+            roaring::Roaring chunk{db::bitmap::cut_left(bitmap, db::bitmap::kBitmapChunkLimit)};
+            Bytes chunk_key(key);
+            chunk_key.resize(key.length() + sizeof(uint32_t));
+            boost::endian::store_big_u32(&chunk_key[key.length()],
+                                         bitmap.cardinality() == 0 ? UINT32_MAX : chunk.maximum());
+            Bytes value(chunk.getSizeInBytes(), '\0');
+            chunk.write(byte_ptr_cast(value.data()));
+            table.put(chunk_key, value);
+        }
+    }
+}
+
+// Chain-like logs: a few contracts & events are hot (skewed towards low indices), most are not
+class SyntheticDb {
+  public:
+    SyntheticDb() {
+        lmdb::DatabaseConfig db_config{tmp_dir_.path(), 1 * kGibi};
+        db_config.set_readonly(false);
+        env_ = lmdb::get_env(db_config);
+        auto txn{env_->begin_rw_transaction()};
+        db::table::create_all(*txn);
+
+        std::mt19937_64 rng{kBlocks};
+        auto skewed{[&rng](size_t n) { return std::min(rng() % n, rng() % n); }};
+
+        auto log_table{txn->open(db::table::kLogs)};
+        std::map<Bytes, roaring::Roaring> address_bitmaps;
+        std::map<Bytes, roaring::Roaring> topic_bitmaps;
+        for (uint32_t block_number{1}; block_number <= kBlocks; ++block_number) {
+            for (uint32_t i{0}; i < kTransactionsPerBlock; ++i) {
+                std::vector<Log> logs(rng() % 3);
+                for (Log& log : logs) {
+                    log.address = address_of(skewed(kAddresses));
+                    log.topics.push_back(topic_of(skewed(kEvents)));
+                    for (size_t j{rng() % 3}; j > 0; --j) {
+                        log.topics.push_back(topic_of(kEvents + rng() % kTopicValues));
+                    }
+                    log.data.resize(32 * (rng() % 4));
+                    address_bitmaps[Bytes{full_view(log.address)}].add(block_number);
+                    for (const auto& topic : log.topics) {
+                        topic_bitmaps[Bytes{full_view(topic)}].add(block_number);
+                    }
+                }
+                if (!logs.empty()) {
+                    log_table->put(db::log_key(block_number, i), cbor_encode(logs), MDB_APPEND);
+                }
+            }
+        }
+        write_index(*txn->open(db::table::kLogAddressIndex), address_bitmaps);
+        write_index(*txn->open(db::table::kLogTopicIndex), topic_bitmaps);
+        lmdb::err_handler(txn->commit());
+    }
+
+    lmdb::Environment& env() { return *env_; }
+
+  private:
+    TemporaryDirectory tmp_dir_;
+    std::shared_ptr<lmdb::Environment> env_;
+};
+
+static SyntheticDb& synthetic_db() {
+    static SyntheticDb db;
+    return db;
+}
+
+enum class Query { kHotAddress = 0, kColdAddress = 1, kAddressAndEvent = 2, kEventAndTopic = 3, kRangeScan = 4 };
+
+static db::LogFilter make_filter(Query query) {
+    db::LogFilter filter;
+    switch (query) {
+        case Query::kHotAddress:
+            filter.addresses = {address_of(0)};
+            break;
+        case Query::kColdAddress:
+            filter.addresses = {address_of(kAddresses - 1), address_of(kAddresses - 2)};
+            break;
+        case Query::kAddressAndEvent:
+            filter.addresses = {address_of(0), address_of(1)};
+            filter.topics = {{topic_of(0)}};
+            break;
+        case Query::kEventAndTopic:
+            filter.topics = {{topic_of(0), topic_of(1)}, {topic_of(kEvents), topic_of(kEvents + 1)}};
+            break;
+        case Query::kRangeScan:
+            filter.from_block = kBlocks / 2;
+            filter.to_block = kBlocks / 2 + 100;
+            break;
+    }
+    return filter;
+}
+
+static void log_filter(benchmark::State& state) {
+    const db::LogFilter filter{make_filter(static_cast<Query>(state.range(0)))};
+    auto txn{synthetic_db().env().begin_ro_transaction()};
+
+    size_t logs{0};
+    size_t blocks{0};
+    for (auto _ : state) {
+        std::optional<roaring::Roaring> candidates{db::matching_blocks(*txn, filter)};
+        blocks = candidates ? candidates->cardinality() : filter.to_block - filter.from_block + 1;
+        logs = db::get_logs(*txn, filter).size();
+    }
+    state.counters["candidate_blocks"] = static_cast<double>(blocks);
+    state.counters["logs"] = static_cast<double>(logs);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * logs));
+}
+
+BENCHMARK(log_filter)->ArgName("query")->DenseRange(0, 4)->Unit(benchmark::kMicrosecond);
+
+// Index lookup & bitmap operations only
+static void log_filter_matching_blocks(benchmark::State& state) {
+    const db::LogFilter filter{make_filter(static_cast<Query>(state.range(0)))};
+    auto txn{synthetic_db().env().begin_ro_transaction()};
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(db::matching_blocks(*txn, filter));
+    }
+}
+
+BENCHMARK(log_filter_matching_blocks)->ArgName("query")->DenseRange(0, 3)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,89 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <cstring>
+
+#include <benchmark/benchmark.h>
+
+#include <silkworm/state/intra_block_state.hpp>
+#include <silkworm/state/memory_buffer.hpp>
+
+namespace {
+
+using namespace silkworm;
+
+constexpr size_t kNumTransactions{200};
+
+evmc::address address_of(size_t i) {
+    evmc::address address;
+    std::memcpy(address.bytes, &i, sizeof(i));
+    return address;
+}
+
+evmc::bytes32 location_of(size_t i) {
+    evmc::bytes32 location;
+    std::memcpy(location.bytes, &i, sizeof(i));
+    return location;
+}
+
+/*
+ * Journal traffic of a block of storage heavy transactions : each one transfers some value,
+ * makes a nested call writing state.range(0) storage slots (every other call is reverted)
+ * and is finally finalized. Contracts are re-created now and then, wiping their storage.
+ */
+void snapshot_revert_finalize(benchmark::State& state) {
+    const auto num_slots{static_cast<size_t>(state.range(0))};
+
+    MemoryBuffer db;
+    IntraBlockState ibs{db};
+
+    for (auto _ : state) {
+        for (size_t txn{0}; txn < kNumTransactions; ++txn) {
+            const evmc::address sender{address_of(txn % 16)};
+            const evmc::address contract{address_of(1'000 + txn % 8)};
+
+            ibs.access_account(sender);
+            ibs.subtract_from_balance(sender, 1);
+            ibs.set_nonce(sender, ibs.get_nonce(sender) + 1);
+            ibs.add_to_balance(contract, 1);
+            if (txn % 50 == 0) {
+                ibs.create_contract(contract);
+            }
+
+            const IntraBlockState::Snapshot snapshot{ibs.take_snapshot()};
+            for (size_t i{0}; i < num_slots; ++i) {
+                const evmc::bytes32 location{location_of(i)};
+                ibs.access_storage(contract, location);
+                ibs.set_storage(contract, location, location_of(txn + i + 1));
+            }
+            if (txn % 2) {
+                ibs.revert_to_snapshot(snapshot);
+            }
+
+            ibs.finalize_transaction();
+            ibs.clear_journal_and_substate();
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kNumTransactions));
+}
+
+}  // namespace
+
+BENCHMARK(snapshot_revert_finalize)->Arg(4)->Arg(64)->Arg(1'024);
+
+BENCHMARK_MAIN();
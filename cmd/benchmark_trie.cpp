@@ -0,0 +1,91 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <silkworm/common/util.hpp>
+#include <silkworm/trie/hash_builder.hpp>
+
+using namespace silkworm;
+
+static constexpr size_t kMaxKeys{10'000'000};
+
+// Sorted random keys, as hashed state keys are
+static const std::vector<evmc::bytes32>& sorted_keys() {
+    static const std::vector<evmc::bytes32> keys{[] {
+        std::mt19937_64 rng{kMaxKeys};
+        std::vector<evmc::bytes32> out(kMaxKeys);
+        for (evmc::bytes32& key : out) {
+            for (uint8_t& byte : key.bytes) {
+                byte = static_cast<uint8_t>(rng());
+            }
+        }
+        std::sort(out.begin(), out.end(), [](const evmc::bytes32& a, const evmc::bytes32& b) {
+            return std::memcmp(a.bytes, b.bytes, kHashLength) < 0;
+        });
+        return out;
+    }()};
+    return keys;
+}
+
+// Values of account-like sizes
+static std::vector<Bytes> random_values() {
+    std::mt19937_64 rng{0};
+    std::vector<Bytes> values(64);
+    for (Bytes& value : values) {
+        value.resize(1 + rng() % 80);
+        for (uint8_t& byte : value) {
+            byte = static_cast<uint8_t>(rng());
+        }
+    }
+    return values;
+}
+
+// Root hash of state.range(0) keys, collecting the nodes if state.range(1) is set
+static void trie_root(benchmark::State& state) {
+    const auto num_keys{static_cast<size_t>(state.range(0))};
+    const std::vector<evmc::bytes32>& keys{sorted_keys()};
+    const std::vector<Bytes> values{random_values()};
+
+    size_t nodes{0};
+    for (auto _ : state) {
+        trie::HashBuilder hb;
+        if (state.range(1)) {
+            hb.node_collector = [&nodes](ByteView, const trie::Node&) { ++nodes; };
+        }
+        for (size_t i{0}; i < num_keys; ++i) {
+            hb.add(full_view(keys[i]), values[i % values.size()]);
+        }
+        benchmark::DoNotOptimize(hb.root_hash());
+    }
+    state.counters["nodes"] = static_cast<double>(nodes / state.iterations());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * num_keys));
+}
+
+BENCHMARK(trie_root)
+    ->ArgNames({"keys", "collect"})
+    ->Args({1'000'000, 0})
+    ->Args({1'000'000, 1})
+    ->Args({10'000'000, 0})
+    ->Args({10'000'000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -14,10 +14,16 @@
    limitations under the License.
 */
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <csignal>
+#include <deque>
 #include <filesystem>
-#include <queue>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <thread>
 
@@ -25,18 +31,15 @@
 #include <boost/endian.hpp>
 #include <boost/format.hpp>
 #include <boost/interprocess/mapped_region.hpp>
-#include <boost/signals2.hpp>
-#include <ethash/keccak.hpp>
 
 #include <silkworm/chain/config.hpp>
 #include <silkworm/common/log.hpp>
 #include <silkworm/common/magic_enum.hpp>
-#include <silkworm/common/worker.hpp>
-#include <silkworm/crypto/ecdsa.hpp>
 #include <silkworm/db/access_layer.hpp>
+#include <silkworm/db/senders.hpp>
 #include <silkworm/db/stages.hpp>
+#include <silkworm/db/tables.hpp>
 #include <silkworm/db/util.hpp>
-#include <silkworm/etl/collector.hpp>
 #include <silkworm/types/block.hpp>
 
 namespace fs = std::filesystem;
@@ -47,8 +50,8 @@ std::atomic_bool g_should_stop{false};  // Request for stop from user or OS
 struct app_options_t {
     std::string datadir{};                                      // Provided database path
     uint64_t mapsize{0};                                        // Provided lmdb map size
-    uint32_t max_workers{std::thread::hardware_concurrency()};  // Max number of threads
-    size_t batch_size{1'000'000};                               // Number of work packages to serve a worker
+    uint32_t max_workers{std::thread::hardware_concurrency()};  // Number of recovery threads
+    size_t batch_size{50'000};                                  // Number of work packages to serve a worker
     uint32_t block_from{1u};                                    // Initial block number to start from
     uint32_t block_to{UINT32_MAX};                              // Final block number to process
     bool force{false};                                          // Whether to replay already processed blocks
@@ -63,130 +66,65 @@ void sig_handler(int signum) {
 }
 
 /**
- * @brief A thread worker dedicated at recovering public keys from
- * transaction signatures
+ * @brief A bounded blocking queue connecting two stages of the recovery pipeline
  */
-class RecoveryWorker final : public silkworm::Worker {
+template <typename T>
+class BoundedQueue final {
   public:
-    RecoveryWorker(uint32_t id, size_t data_size) : id_(id), data_size_{data_size} {
-        // Try allocate enough memory to store
-        // results output
-        data_ = static_cast<uint8_t*>(std::calloc(1, data_size_));
-        if (!data_) {
-            throw std::runtime_error("Memory allocation failed");
-        }
-    };
-
-    // Recovery package
-    struct package {
-        uint64_t block_num;
-        ethash::hash256 hash;
-        bool odd_y_parity;
-        uint8_t signature[64];
-    };
-
-    enum class Status {
-        Idle = 0,
-        Working = 1,
-        ResultsReady = 2,
-        Error = 3,
-        Aborted = 4,
-    };
+    explicit BoundedQueue(size_t capacity) : capacity_{std::max<size_t>(capacity, 1)} {}
 
-    // Provides a container of packages to process
-    void set_work(uint32_t batch_id, std::unique_ptr<std::vector<package>> batch) {
-        batch_ = std::move(batch);
-        batch_id_ = batch_id;
-        status_.store(Status::Working);
-        Worker::kick();
+    // Waits for room in the queue. Returns false if the queue has been closed
+    bool push(T item) {
+        std::unique_lock lock{mtx_};
+        not_full_.wait(lock, [this]() { return closed_ || queue_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        queue_.push_back(std::move(item));
+        lock.unlock();
+        not_empty_.notify_one();
+        return true;
     }
 
-    uint32_t get_id() const { return id_; };
-    uint32_t get_batch_id() const { return batch_id_; };
-    std::string get_error(void) const { return last_error_; };
-    Status get_status(void) const { return status_.load(); };
-
-    // Pull results from worker
-    bool pull_results(Status status, std::vector<std::pair<uint64_t, MDB_val>>& out) {
-        if (status_.compare_exchange_strong(status, Status::Idle)) {
-            std::swap(out, results_);
-            return true;
-        };
-        return false;
-    };
-
-    // Signal to connected handlers the task has completed
-    boost::signals2::signal<void(RecoveryWorker* sender, uint32_t batch_id)> signal_completed;
-
-  private:
-    const uint32_t id_;                                    // Current worker identifier
-    uint32_t batch_id_{0};                                 // Running batch identifier
-    std::unique_ptr<std::vector<package>> batch_;          // Batch to process
-    size_t data_size_;                                     // Size of the recovery data buffer
-    uint8_t* data_{nullptr};                               // Pointer to data where rsults are stored
-    std::vector<std::pair<uint64_t, MDB_val>> results_{};  // Results per block pointing to data area
-    std::string last_error_{};                             // Description of last error occurrence
-    std::atomic<Status> status_{Status::Idle};             // Status of worker
-
-    // Basic work loop (overrides Worker::work())
-    void work() final {
-        while (wait_for_kick()) {
-            // Prefer swapping with a new vector instead of clear
-            std::vector<std::pair<uint64_t, MDB_val>>().swap(results_);
-
-            uint64_t block_num{(*batch_).front().block_num};
-            size_t block_result_offset{0};
-            size_t block_result_length{0};
-
-            for (auto const& package : (*batch_)) {
-                // On block switching store the results
-                if (block_num != package.block_num) {
-                    MDB_val result{block_result_length, &data_[block_result_offset]};
-                    results_.push_back({block_num, result});
-                    block_result_offset += block_result_length;
-                    block_result_length = 0;
-                    block_num = package.block_num;
-                    if (should_stop()) {
-                        status_.store(Status::Aborted);
-                        break;
-                    }
-                }
-
-                std::optional<Bytes> recovered{
-                    ecdsa::recover(full_view(package.hash.bytes), full_view(package.signature), package.odd_y_parity)};
-
-                if (recovered.has_value() && recovered->at(0) == 4u) {
-                    auto keyHash{ethash::keccak256(recovered->data() + 1, recovered->length() - 1)};
-                    std::memcpy(&data_[block_result_offset + block_result_length],
-                                &keyHash.bytes[sizeof(keyHash) - kAddressLength], kAddressLength);
-                    block_result_length += kAddressLength;
-                } else {
-                    last_error_ = "Public key recovery failed at block #" + std::to_string(package.block_num);
-                    status_.store(Status::Error);
-                    break;  // No need to process other txns
-                }
-            }
-
-            if (status_.load() == Status::Working) {
-                // Store results for last block
-                if (block_result_length) {
-                    MDB_val result{block_result_length, &data_[block_result_offset]};
-                    results_.push_back({block_num, result});
-                }
-                status_.store(Status::ResultsReady);
-            }
+    // Waits for an item. Returns std::nullopt once the queue has been closed and drained
+    std::optional<T> pop() {
+        std::unique_lock lock{mtx_};
+        not_empty_.wait(lock, [this]() { return closed_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return std::nullopt;
+        }
+        T item{std::move(queue_.front())};
+        queue_.pop_front();
+        lock.unlock();
+        not_full_.notify_one();
+        return item;
+    }
 
-            // Raise finished event
-            signal_completed(this, batch_id_);
-            batch_.reset();
+    // No further item can be pushed while pending ones can still be popped
+    void close() {
+        {
+            std::lock_guard lock{mtx_};
+            closed_ = true;
         }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
 
-        std::free(data_);
-    };
+  private:
+    const size_t capacity_;
+    std::mutex mtx_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<T> queue_{};
+    bool closed_{false};
 };
 
 /**
- * @brief An orchestrator of RecoveryWorkers
+ * @brief Recovers senders' addresses through a three stages pipeline :
+ * a db::BlockBatchReader decoding canonical transactions into batches, a db::SenderRecoverer recovering
+ * each batch over max_workers threads and a writer storing recovered senders into the database.
+ * The reader runs ahead of the other two stages through a bounded queue so that memory usage stays bounded;
+ * the time each stage spends working rather than waiting reveals the bottleneck.
  */
 class RecoveryFarm final {
   public:
@@ -194,21 +132,19 @@ class RecoveryFarm final {
 
     /**
      * @brief This class coordinates the recovery of senders' addresses through
-     * multiple threads. May eventually handle the unwinding of already
-     * recovered addresses.
+     * multiple threads and handles the unwinding of already recovered addresses.
      *
+     * @param reader: the reader of block batches, constructed before the transaction began
      * @param transaction: the database transaction we should work on
-     * @param max_workers: max number of recovery threads to spawn
-     * @param max_batch_size: max number of transaction to be sent a worker for recovery
+     * @param max_workers: number of recovery threads (the calling one included)
+     * @param max_batch_size: max number of transactions recovered at once
      */
-    explicit RecoveryFarm(lmdb::Transaction& db_transaction, uint32_t max_workers, size_t max_batch_size,
-                          etl::Collector& collector)
-        : db_transaction_{db_transaction},
+    explicit RecoveryFarm(const db::BlockBatchReader& reader, lmdb::Transaction& db_transaction,
+                          uint32_t max_workers, size_t max_batch_size)
+        : reader_{reader},
+          db_transaction_{db_transaction},
           max_workers_{max_workers},
-          max_batch_size_{max_batch_size},
-          collector_{collector} {
-        workers_.reserve(max_workers);
-    };
+          max_batch_size_{max_batch_size} {};
     ~RecoveryFarm() = default;
 
     enum class Status {
@@ -238,8 +174,6 @@ class RecoveryFarm final {
      * @param height_to   : Upper boundary for blocks to process (included)
      */
     Status recover(uint64_t height_from, uint64_t height_to, bool force) {
-        Status ret{Status::Succeded};
-
         auto config{db::read_chain_config(db_transaction_)};
         if (!config.has_value()) {
             return Status::InvalidChainConfig;
@@ -277,10 +211,9 @@ class RecoveryFarm final {
             }
 
             // Load canonical headers
-            Status ret_status{Status::Succeded};
             uint64_t headers_count{height_to - height_from + 1};
             headers_.reserve(headers_count);
-            ret_status = fill_canonical_headers(height_from, height_to);
+            Status ret_status{fill_canonical_headers(height_from, height_to)};
             if (ret_status != Status::Succeded) {
                 return ret_status;
             }
@@ -291,135 +224,19 @@ class RecoveryFarm final {
                 return Status::HeaderNotFound;
             }
 
-            headers_it_1_ = headers_.begin();
-            headers_it_2_ = headers_.begin();
-
-            // Load block bodies
-            uint64_t block_num{0};                     // Block number being processed
-            uint64_t expected_block_num{height_from};  // Expected block number in sequence
-
-            SILKWORM_LOG(LogLevel::Debug) << "Begin read block bodies ... " << std::endl;
-            auto bodies_table{db_transaction_.open(db::table::kBlockBodies)};
-            auto transactions_table{db_transaction_.open(db::table::kEthTx)};
-
-            // Set to first block and read all in sequence
-            auto block_key{db::block_key(expected_block_num, headers_it_1_->bytes)};
-            MDB_val mdb_key{db::to_mdb_val(block_key)}, mdb_data{};
-            int rc{bodies_table->seek_exact(&mdb_key, &mdb_data)};
-            if (rc) {
-                return Status::BlockNotFound;
-            }
-
-            // Initializes first batch
-            init_batch();
-
-            while (!rc && !should_stop()) {
-                auto key_view{db::from_mdb_val(mdb_key)};
-                block_num = boost::endian::load_big_u64(key_view.data());
-                if (block_num < expected_block_num) {
-                    // The same block height has been recorded
-                    // but is not canonical;
-                    rc = bodies_table->get_next(&mdb_key, &mdb_data);
-                    continue;
-                } else if (block_num > expected_block_num) {
-                    // We surpassed the expected block which means
-                    // either the db misses a block or blocks are not persisted
-                    // in sequence
-                    SILKWORM_LOG(LogLevel::Error) << "Senders' recovery : Bad block sequence expected "
-                                                  << expected_block_num << " got " << block_num << std::endl;
-                    return Status::BadBlockSequence;
-                }
-
-                if (memcmp(&key_view[8], headers_it_1_->bytes, 32) != 0) {
-                    // We stumbled into a non canonical block (not matching header)
-                    // move next and repeat
-                    rc = bodies_table->get_next(&mdb_key, &mdb_data);
-                    continue;
-                }
-
-                // Get the body and its transactions
-                auto body_rlp{db::from_mdb_val(mdb_data)};
-                auto block_body{db::detail::decode_stored_block_body(body_rlp)};
-                std::vector<Transaction> transactions{
-                    db::read_transactions(*transactions_table, block_body.base_txn_id, block_body.txn_count)};
-
-                if (transactions.size()) {
-                    if (((*batch_).size() + transactions.size()) > max_batch_size_) {
-                        ret = dispatch_batch();
-                        if (ret != Status::Succeded) {
-                            throw std::runtime_error("Unable to dispatch work");
-                        }
-                    }
-
-                    ret = fill_batch(*config, block_num, transactions);
-                    if (ret != Status::Succeded) {
-                        throw std::runtime_error("Unable to transform transactions");
-                    }
-                }
-
-                // After processing move to next block number and header
-                if (++headers_it_1_ == headers_.end()) {
-                    // We'd go beyond collected canonical headers
-                    break;
-                }
-
-                expected_block_num++;
-                rc = bodies_table->get_next(&mdb_key, &mdb_data);
-            }
-
-            if (rc && rc != MDB_NOTFOUND) {
-                lmdb::err_handler(rc);
-            } else {
-                ret = dispatch_batch(/* renew = */ false);
-                if (ret != Status::Succeded) {
-                    throw std::runtime_error("Unable to dispatch work");
-                }
+            ret_status = run_pipeline(*config, height_from);
+            if (ret_status == Status::Succeded) {
+                db::stages::set_stage_progress(db_transaction_, db::stages::kSendersKey, height_to);
             }
-
-            SILKWORM_LOG(LogLevel::Debug) << "End   read block bodies ... " << std::endl;
+            return ret_status;
 
         } catch (const lmdb::exception& ex) {
             SILKWORM_LOG(LogLevel::Error) << "Senders' recovery : Database error " << ex.what() << std::endl;
-            ret = Status::DatabaseError;
+            return Status::DatabaseError;
         } catch (const std::exception& ex) {
             SILKWORM_LOG(LogLevel::Error) << "Senders' recovery : " << ex.what() << std::endl;
-            ret = Status::RecoveryError;
-        }
-
-        // If everything ok from previous steps wait for all workers to complete
-        // and bufferize results
-        wait_workers_completion();
-        if (!static_cast<int>(ret)) {
-            bufferize_workers_results();
-            if (collector_.size() && !should_stop()) {
-                try {
-                    // Prepare target table
-                    auto target_table = db_transaction_.open(db::table::kSenders, MDB_CREATE);
-                    SILKWORM_LOG(LogLevel::Info)
-                        << "ETL Load [2/2] : Loading data into " << target_table->get_name() << std::endl;
-                    collector_.load(
-                        target_table.get(), nullptr, MDB_APPEND,
-                        /* log_every_percent = */ (total_recovered_transactions_ <= max_batch_size_ ? 50 : 10));
-
-                    // Get the last processed block and update stage height
-                    MDB_val mdb_key{}, mdb_val{};
-                    lmdb::err_handler(target_table->get_last(&mdb_key, &mdb_val));
-                    ByteView key_view{static_cast<uint8_t*>(mdb_key.mv_data), mdb_key.mv_size};
-                    auto last_processed_block{boost::endian::load_big_u64(&key_view[0])};
-                    db::stages::set_stage_progress(db_transaction_, db::stages::kSendersKey, last_processed_block);
-
-                } catch (const lmdb::exception& ex) {
-                    SILKWORM_LOG(LogLevel::Error) << "Senders' recovery : Database error " << ex.what() << std::endl;
-                    ret = Status::DatabaseError;
-                } catch (const std::exception& ex) {
-                    SILKWORM_LOG(LogLevel::Error) << "Senders' recovery : " << ex.what() << std::endl;
-                    ret = Status::RecoveryError;
-                }
-            }
+            return Status::RecoveryError;
         }
-
-        stop_all_workers(/*wait = */ true);
-        return ret;
     }
 
     /**
@@ -473,241 +290,150 @@ class RecoveryFarm final {
     }
 
   private:
-    /**
-     * @brief Gets whether or not this class should stop working
-     */
-    bool should_stop() { return should_stop_.load() || g_should_stop.load(); }
+    using Clock = std::chrono::steady_clock;
 
-    /**
-     * @brief Forces each worker to stop
-     */
-    void stop_all_workers(bool wait = true) {
-        SILKWORM_LOG(LogLevel::Debug) << "Stopping workers ... " << std::endl;
-        for (const auto& worker : workers_) {
-            worker->stop(wait);
-        }
-    }
+    static constexpr size_t kMaxPendingBatches{2};  // Batches the reader may run ahead of recovery
 
     /**
-     * @brief Waits till every worker has finished or aborted
+     * @brief Gets whether or not this class should stop working
      */
-    void wait_workers_completion() {
-        if (workers_.size()) {
-            uint64_t attempts{0};
-            do {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-                auto it = std::find_if(workers_.begin(), workers_.end(), [](const std::unique_ptr<RecoveryWorker>& w) {
-                    return w->get_status() == RecoveryWorker::Status::Working;
-                });
-                if (it == workers_.end()) {
-                    break;
-                }
-                if (!(++attempts % 60)) {
-                    SILKWORM_LOG(LogLevel::Info) << "Waiting for workers to complete" << std::endl;
-                }
-            } while (true);
-        }
-    }
+    bool should_stop() { return should_stop_.load() || g_should_stop.load(); }
 
     /**
-     * @brief Collects results from worker's completed tasks
+     * @brief Runs the reader against recovery and writer till the whole range is processed or any of them fails.
+     * Recovery and writer run on the calling thread as it's the owner of the read-write transaction.
      */
-    Status bufferize_workers_results() {
-        static std::string fmt_row{"%10u b %12u t"};
+    Status run_pipeline(const ChainConfig& config, uint64_t height_from) {
+        BoundedQueue<db::BlockBatch> to_recover{kMaxPendingBatches};
 
-        Status ret{Status::Succeded};
-        std::vector<std::pair<uint64_t, MDB_val>> worker_results{};
-        do {
-            // Check we have results to pull
-            std::unique_lock l(batches_completed_mtx);
-            if (batches_completed.empty()) {
-                break;
-            }
+        auto target_table{db_transaction_.open(db::table::kSenders, MDB_CREATE)};
 
-            // Pull results
-            auto& item{batches_completed.front()};
-            auto& worker{workers_.at(item.first)};
+        std::optional<uint64_t> last_recorded_block{};
+        MDB_val mdb_key{}, mdb_data{};
+        int rc{target_table->get_last(&mdb_key, &mdb_data)};
+        if (rc != MDB_NOTFOUND) {
+            lmdb::err_handler(rc);
+            last_recorded_block = boost::endian::load_big_u64(static_cast<uint8_t*>(mdb_key.mv_data));
+        }
 
-            SILKWORM_LOG(LogLevel::Debug)
-                << "Collecting  package " << item.second << " worker " << item.first << std::endl;
+        pipeline_start_ = Clock::now();
 
-            batches_completed.pop();
-            l.unlock();
+        Status reader_status{Status::Succeded};
+        std::thread reader{[&]() {
+            reader_status = read_batches(height_from, to_recover);
+            to_recover.close();
+        }};
 
-            auto status = worker->get_status();
-            if (status == RecoveryWorker::Status::Error) {
-                SILKWORM_LOG(LogLevel::Error)
-                    << "Got error from worker id " << worker->get_id() << " : " << worker->get_error() << std::endl;
-                ret = Status::RecoveryError;
-                break;
-            } else if (status == RecoveryWorker::Status::Aborted) {
-                ret = Status::WorkerAborted;
-                break;
-            } else if (status == RecoveryWorker::Status::ResultsReady) {
-                if (!worker->pull_results(status, worker_results)) {
-                    ret = Status::WorkerStatusMismatch;
-                    break;
-                } else {
-                    for (auto& [block_num, mdb_val] : worker_results) {
-                        total_processed_blocks_++;
-                        total_recovered_transactions_ += (mdb_val.mv_size / kAddressLength);
-
-                        auto etl_key{db::block_key(block_num, headers_it_2_->bytes)};
-                        Bytes etl_data(db::from_mdb_val(mdb_val));
-                        etl::Entry entry{etl_key, etl_data};
-                        collector_.collect(entry);  // TODO check for errors (eg. disk full)
-                        headers_it_2_++;
-                    }
-                    SILKWORM_LOG(LogLevel::Info)
-                        << "ETL Load [1/2] : "
-                        << (boost::format(fmt_row) % total_processed_blocks_ % total_recovered_transactions_)
-                        << std::endl;
-                }
-            }
-
-            worker_results.clear();
-
-        } while (!should_stop());
+        Status ret{Status::Succeded};
+        try {
+            ret = recover_batches(config, to_recover, *target_table, height_from, last_recorded_block);
+        } catch (const lmdb::exception& ex) {
+            SILKWORM_LOG(LogLevel::Error) << "Senders' recovery : Database error " << ex.what() << std::endl;
+            ret = Status::DatabaseError;
+        }
 
         if (ret != Status::Succeded) {
+            // Unblock the reader
             should_stop_.store(true);
+            to_recover.close();
         }
+        reader.join();
 
-        return ret;
+        SILKWORM_LOG(LogLevel::Info) << "Pipeline utilization : " << utilization() << std::endl;
+
+        if (reader_status != Status::Succeded) {
+            return reader_status;
+        }
+        return should_stop() ? Status::WorkerAborted : ret;
     }
 
     /**
-     * @brief Transforms transaction into recoverable packages
-     *
-     * @param config       : Chain configuration
-     * @param block_num    : Actual block this transactions belong to
-     * @param transactions : Transactions which have to be recovered for sender address
+     * @brief Reader stage : reads and decodes canonical transactions into batches for recovery.
+     * Works within a read-only transaction of its own on tables published before the read-write one began.
      */
-    Status fill_batch(ChainConfig config, uint64_t block_num, std::vector<Transaction>& transactions) {
-        const evmc_revision rev{config.revision(block_num)};
-        const bool has_homestead{rev >= EVMC_HOMESTEAD};
-        const bool has_spurious_dragon{rev >= EVMC_SPURIOUS_DRAGON};
-
-        for (const auto& transaction : transactions) {
-            if (!silkworm::ecdsa::is_valid_signature(transaction.r, transaction.s, has_homestead)) {
+    Status read_batches(uint64_t height_from, BoundedQueue<db::BlockBatch>& out) {
+        SILKWORM_LOG(LogLevel::Debug) << "Begin read block bodies ... " << std::endl;
+        Status ret{Status::Succeded};
+        try {
+            Clock::time_point start{Clock::now()};
+            std::optional<uint64_t> missing_block{
+                reader_.read(height_from, headers_, [&](db::BlockBatch&& batch) {
+                    reader_busy_us_ += elapsed_us(start);
+                    const bool pushed{!should_stop() && out.push(std::move(batch))};  // Pipeline may be stopping
+                    start = Clock::now();
+                    return pushed;
+                })};
+            reader_busy_us_ += elapsed_us(start);
+
+            if (missing_block) {
                 SILKWORM_LOG(LogLevel::Error)
-                    << "Got invalid signature in transaction for block " << block_num << std::endl;
-                return Status::InvalidTransactionSignature;
+                    << "Senders' recovery : Block " << *missing_block << " not found" << std::endl;
+                ret = Status::BlockNotFound;
             }
 
-            if (transaction.chain_id) {
-                if (!has_spurious_dragon) {
-                    SILKWORM_LOG(LogLevel::Error)
-                        << "EIP-155 signature in transaction before Spurious Dragon for block " << block_num
-                        << std::endl;
-                    return Status::InvalidTransactionSignature;
-                } else if (*transaction.chain_id != config.chain_id) {
-                    SILKWORM_LOG(LogLevel::Error)
-                        << "EIP-155 invalid signature in transaction for block " << block_num << std::endl;
-                    SILKWORM_LOG(LogLevel::Error) << "Expected chain_id " << config.chain_id << " got "
-                                                  << intx::to_string(*transaction.chain_id) << std::endl;
-                    return Status::InvalidTransactionSignature;
-                }
-            }
-
-            Bytes rlp{};
-            rlp::encode(rlp, transaction, /*for_signing=*/true, /*wrap_eip2718_into_array=*/false);
-
-            auto hash{keccak256(rlp)};
-            RecoveryWorker::package package{block_num, hash, transaction.odd_y_parity};
-            intx::be::unsafe::store(package.signature, transaction.r);
-            intx::be::unsafe::store(package.signature + 32, transaction.s);
-            (*batch_).push_back(package);
+        } catch (const lmdb::exception& ex) {
+            SILKWORM_LOG(LogLevel::Error) << "Senders' recovery : Database error " << ex.what() << std::endl;
+            ret = Status::DatabaseError;
+        } catch (const std::exception& ex) {
+            SILKWORM_LOG(LogLevel::Error) << "Senders' recovery : " << ex.what() << std::endl;
+            ret = Status::RecoveryError;
         }
+        SILKWORM_LOG(LogLevel::Debug) << "End   read block bodies ... " << std::endl;
 
-        return Status::Succeded;
+        return ret;
     }
 
     /**
-     * @brief Dispatches the collected batch of data to first available worker.
-     * Eventually creates worksers up to max_workers
+     * @brief Recovery and writer stages : recovers the senders of each batch through a db::SenderRecoverer
+     * and stores them in the same order blocks have been read.
+     * Senders of blocks past the last one recorded in the table are appended.
      */
-    Status dispatch_batch(bool renew = true) {
-        Status ret{Status::Succeded};
-
-        if (should_stop()) {
-            init_batch();  // Empties the batch
-            return Status::WorkerAborted;
-        } else if (!batch_ || !(*batch_).size()) {
-            return Status::Succeded;
-        }
+    Status recover_batches(const ChainConfig& config, BoundedQueue<db::BlockBatch>& in, lmdb::Table& target_table,
+                           uint64_t height_from, std::optional<uint64_t> last_recorded_block) {
+        static std::string fmt_row{"%10u b %12u t"};
 
-        // First worker created
-        if (!workers_.size()) {
-            if (!initialize_new_worker(/*show_error =*/true)) {
-                ret = Status::WorkerInitError;
+        db::SenderRecoverer recoverer{max_batch_size_, max_workers_};
+        while (std::optional<db::BlockBatch> batch{in.pop()}) {
+            if (should_stop()) {
+                return Status::WorkerAborted;
             }
-        }
 
-        // Locate first available worker
-        while (ret == Status::Succeded) {
-            auto it = std::find_if(workers_.begin(), workers_.end(), [](const std::unique_ptr<RecoveryWorker>& w) {
-                return w->get_status() == RecoveryWorker::Status::Idle;
-            });
-
-            if (it != workers_.end()) {
-                SILKWORM_LOG(LogLevel::Debug) << "Dispatching package " << batch_id_ << " worker "
-                                              << (std::distance(workers_.begin(), it)) << std::endl;
-                (*it)->set_work(batch_id_++, std::move(batch_));  // Transfers ownership of batch to worker
-                if (renew) {
-                    init_batch();
-                }
-                break;
-            } else {
-                // Do we have ready results from workers that we need to bufferize ?
-                it = std::find_if(workers_.begin(), workers_.end(), [](const std::unique_ptr<RecoveryWorker>& w) {
-                    auto s = static_cast<int>(w->get_status());
-                    return (s >= 2);
-                });
-                if (it != workers_.end()) {
-                    ret = bufferize_workers_results();
-                    continue;
-                }
-
-                // We don't have a worker available
-                // Maybe we can create a new one if available
-                if (workers_.size() != max_workers_) {
-                    if (!initialize_new_worker()) {
-                        max_workers_ = workers_.size();  // Don't try to spawn new workers. Maybe we're OOM
-                    } else {
-                        continue;
-                    }
+            Clock::time_point start{Clock::now()};
+            for (const auto& [block_num, transactions] : batch->blocks) {
+                if (!recoverer.add_block(block_num, transactions, config)) {
+                    SILKWORM_LOG(LogLevel::Error)
+                        << "Got invalid signature in transaction for block " << block_num << std::endl;
+                    return Status::InvalidTransactionSignature;
                 }
-
-                // No other option than wait a while and retry
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
             }
-        };
-
-        return ret;
-    }
-
-    bool initialize_new_worker(bool show_error = false) {
-        SILKWORM_LOG(LogLevel::Debug) << "Launching worker #" << workers_.size() << std::endl;
+            if (std::optional<uint64_t> failed_block{recoverer.recover()}; failed_block) {
+                SILKWORM_LOG(LogLevel::Error) << "Public key recovery failed at block #" << *failed_block << std::endl;
+                return Status::RecoveryError;
+            }
+            recovery_busy_us_ += elapsed_us(start);
 
-        try {
-            workers_.emplace_back(new RecoveryWorker(workers_.size(), max_batch_size_ * kAddressLength));
-            workers_.back()->signal_completed.connect(
-                boost::bind(&RecoveryFarm::worker_completed_handler, this, _1, _2));
-            workers_.back()->start(/*wait = */ true);
-            return workers_.back()->get_state() == Worker::WorkerState::kStarted;
-        } catch (const std::exception& ex) {
-            if (show_error) {
-                SILKWORM_LOG(LogLevel::Error) << "Unable to initialize recovery worker : " << ex.what() << std::endl;
+            start = Clock::now();
+            for (const db::SenderRecoverer::BlockSenders& block : recoverer.senders()) {
+                auto key{db::block_key(block.block_number, headers_[block.block_number - height_from].bytes)};
+                const bool append{!last_recorded_block || block.block_number > *last_recorded_block};
+                target_table.put(key, block.senders, append ? MDB_APPEND : 0u);
             }
-            return false;
+            recoverer.clear();
+            writer_busy_us_ += elapsed_us(start);
+
+            total_processed_blocks_ += batch->blocks.size();
+            total_recovered_transactions_ += batch->txn_count;
+            SILKWORM_LOG(LogLevel::Info)
+                << "Written " << (boost::format(fmt_row) % total_processed_blocks_ % total_recovered_transactions_)
+                << " up to block " << batch->blocks.back().first << " (" << utilization() << ")" << std::endl;
         }
+
+        return Status::Succeded;
     }
 
     /**
      * @brief Fills a vector of all canonical headers
      *
-     * @param headers     : Storage vector for all headers
      * @param height_from : Lower boundary for canonical headers (included)
      * @param height_to   : Upper boundary for canonical headers (included)
      */
@@ -733,7 +459,7 @@ class RecoveryFarm final {
             }
 
             // Read all headers up to block_to included
-            while (!rc) {
+            while (!rc && expected_block_num <= height_to) {
                 ByteView key_view{static_cast<uint8_t*>(mdb_key.mv_data), mdb_key.mv_size};
                 reached_block_num = boost::endian::load_big_u64(&key_view[0]);
                 if (reached_block_num != expected_block_num) {
@@ -771,60 +497,42 @@ class RecoveryFarm final {
         }
     }
 
-    /**
-     * @brief Gets executed by worker on its work completed
-     */
-    void worker_completed_handler(RecoveryWorker* sender, uint32_t batch_id) {
-        // Ensure worker threads complete batches in the same order they
-        // were launched
-        while (completed_batch_id.load() != batch_id) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
-
-        // Save my ids in the queue of results to
-        // store in db
-        std::lock_guard l(batches_completed_mtx);
-        std::pair<uint32_t, uint32_t> item{sender->get_id(), batch_id};
-        batches_completed.push(item);
-        completed_batch_id++;
+    static uint64_t elapsed_us(Clock::time_point start) {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
     }
 
     /**
-     * @brief Initializes a new batch container
+     * @brief Share of the pipeline's running time each stage has spent working rather than waiting
      */
-    void init_batch() {
-        batch_ = std::make_unique<std::vector<RecoveryWorker::package>>();
-        (*batch_).reserve(max_batch_size_);
+    std::string utilization() const {
+        const double total_us{static_cast<double>(std::max<uint64_t>(elapsed_us(pipeline_start_), 1))};
+        auto percent{[total_us](uint64_t busy_us) {
+            return std::min(100.0, 100.0 * static_cast<double>(busy_us) / total_us);
+        }};
+        return (boost::format("reader %3.0f%% recovery %3.0f%% (x%u) writer %3.0f%%") %
+                percent(reader_busy_us_.load()) % percent(recovery_busy_us_.load()) % max_workers_ %
+                percent(writer_busy_us_.load()))
+            .str();
     }
 
-    friend class RecoveryWorker;
-    lmdb::Transaction& db_transaction_;  // Database transaction
-
-    /* Recovery workers */
-    uint32_t max_workers_;                                    // Max number of workers/threads
-    std::vector<std::unique_ptr<RecoveryWorker>> workers_{};  // Actual collection of recoverers
-
-    /* Canonical headers */
-    std::vector<evmc::bytes32> headers_{};               // Collected canonical headers
-    std::vector<evmc::bytes32>::iterator headers_it_1_;  // For blocks reading
-    std::vector<evmc::bytes32>::iterator headers_it_2_;  // For buffer results
-
-    /* Batches */
-    const size_t max_batch_size_;  // Max number of transaction to be sent a worker for recovery
-    std::unique_ptr<std::vector<RecoveryWorker::package>>
-        batch_;                                  // Collection of transactions to be sent a worker for recovery
-    uint32_t batch_id_{0};                       // Incremental id of launched batches
-    std::atomic_uint32_t completed_batch_id{0};  // Incremental id of completed batches
-    std::queue<std::pair<uint32_t, uint32_t>>
-        batches_completed{};           // Queue of batches completed waiting to be written on disk
-    std::mutex batches_completed_mtx;  // Guards the queue
-    etl::Collector& collector_;
+    const db::BlockBatchReader& reader_;  // Reader of block batches
+    lmdb::Transaction& db_transaction_;   // Database transaction
+
+    const uint32_t max_workers_;   // Number of recovery threads
+    const size_t max_batch_size_;  // Max number of transactions recovered at once
+
+    std::vector<evmc::bytes32> headers_{};  // Collected canonical headers
 
     std::atomic_bool should_stop_{false};
 
     /* Stats */
     uint64_t total_recovered_transactions_{0};
     uint64_t total_processed_blocks_{0};
+    Clock::time_point pipeline_start_{};
+    std::atomic_uint64_t reader_busy_us_{0};
+    std::atomic_uint64_t recovery_busy_us_{0};
+    std::atomic_uint64_t writer_busy_us_{0};
 };
 
 int main(int argc, char* argv[]) {
@@ -839,7 +547,7 @@ int main(int argc, char* argv[]) {
     std::string mapSizeStr{"0"};
     app.add_option("--lmdb.mapSize", mapSizeStr, "Lmdb map size", true);
 
-    app.add_option("--workers", options.max_workers, "Max number of worker threads", true)
+    app.add_option("--workers", options.max_workers, "Number of recovery threads", true)
         ->check(CLI::Range(1u, std::thread::hardware_concurrency()));
 
     app.add_option("--from", options.block_from, "Initial block number to process (inclusive)", true)
@@ -907,17 +615,13 @@ int main(int argc, char* argv[]) {
         db_config.set_readonly(false);
         db_config.map_size = options.mapsize;
 
-        // Compute etl temporary path
-        fs::path etl_path(db_path.parent_path() / fs::path("etl-temp"));
-        fs::create_directories(etl_path);
-        etl::Collector collector(etl_path.string().c_str(), /* flush size */ 512 * kMebi);
-
-        // Open db and transaction
+        // Open db and transaction : the reader must publish the tables it reads before the transaction begins
         auto lmdb_env{lmdb::get_env(db_config)};
+        db::BlockBatchReader reader{*lmdb_env, options.batch_size};
         auto lmdb_txn{lmdb_env->begin_rw_transaction()};
 
         // Create farm instance and do work
-        RecoveryFarm farm(*lmdb_txn, options.max_workers, options.batch_size, collector);
+        RecoveryFarm farm(reader, *lmdb_txn, options.max_workers, options.batch_size);
         RecoveryFarm::Status result{RecoveryFarm::Status::Succeded};
 
         if (app_recover) {
@@ -19,6 +19,7 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -255,6 +256,7 @@ static void check_rlp_err(rlp::DecodingResult err) {
 
 ExecutionStatePool state_pool;
 evmc_vm* evm{nullptr};
+size_t num_threads{1};
 
 // https://ethereum-tests.readthedocs.io/en/latest/test_types/blockchain_tests.html#pre-prestate-section
 void init_pre_state(const nlohmann::json& pre, StateBuffer& state) {
@@ -423,6 +425,11 @@ Status blockchain_test(const nlohmann::json& json_test, std::optional<ChainConfi
     Blockchain blockchain{state, config, genesis_block};
     blockchain.state_pool = &state_pool;
     blockchain.exo_evm = evm;
+    std::unique_ptr<SpeculationPool> speculation_pool;
+    if (num_threads > 1) {
+        speculation_pool = std::make_unique<SpeculationPool>(state, num_threads);
+        blockchain.speculation_pool = speculation_pool.get();
+    }
 
     for (const auto& json_block : json_test["blocks"]) {
         Status status{run_block(json_block, blockchain)};
@@ -622,6 +629,8 @@ int main(int argc, char* argv[]) {
     app.add_option("--evm", evm_path, "Path to EVMC-compliant VM");
     std::string tests_path{SILKWORM_CONSENSUS_TEST_DIR};
     app.add_option("--tests", tests_path, "Path to consensus tests", true)->check(CLI::ExistingDirectory);
+    app.add_option("--threads", num_threads, "Number of threads to speculatively execute transactions in parallel",
+                   true);
     CLI11_PARSE(app, argc, argv);
 
     if (!evm_path.empty()) {
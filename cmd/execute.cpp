@@ -14,6 +14,7 @@
    limitations under the License.
 */
 
+#include <chrono>
 #include <filesystem>
 
 #include <CLI/CLI.hpp>
@@ -27,6 +28,27 @@
 #include <silkworm/execution/execution.hpp>
 #include <silkworm_tg_api.h>
 
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+// Peak resident set size in bytes (0 if unknown)
+static size_t peak_rss() {
+#if defined(__linux__) || defined(__APPLE__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+    return 0;
+#endif
+}
+
 int main(int argc, char* argv[]) {
     using namespace silkworm;
 
@@ -45,6 +67,16 @@ int main(int argc, char* argv[]) {
     std::string batch_size_str{"512MB"};
     app.add_option("--batch", batch_size_str, "Batch size of DB changes to accumulate before committing", true);
 
+    uint64_t prefetch_depth{64};
+    app.add_option("--prefetch", prefetch_depth, "Number of blocks to read ahead of execution (0 disables prefetching)",
+                   true);
+
+    uint64_t cache_accounts{1'000'000};
+    app.add_option("--cache.accounts", cache_accounts, "Capacity of the plain state cache in accounts", true);
+
+    uint64_t cache_storage_slots{4'000'000};
+    app.add_option("--cache.storage", cache_storage_slots, "Capacity of the plain state cache in storage slots", true);
+
     CLI11_PARSE(app, argc, argv);
 
     namespace fs = std::filesystem;
@@ -69,6 +101,11 @@ int main(int argc, char* argv[]) {
         return -3;
     }
 
+    if (silkworm_set_state_cache_capacity(cache_accounts, cache_storage_slots, /*num_shards=*/0) !=
+        SilkwormStatusCode::kSilkwormSuccess) {
+        return -4;
+    }
+
     SILKWORM_LOG(LogLevel::Info) << "Starting block execution. DB: " << db_file << std::endl;
 
     try {
@@ -90,10 +127,12 @@ int main(int argc, char* argv[]) {
         uint64_t current_progress{previous_progress};
 
         for (uint64_t block_number{previous_progress + 1}; block_number <= to_block; ++block_number) {
+            const uint64_t batch_start_block{block_number};
+            const auto batch_start{std::chrono::steady_clock::now()};
             int lmdb_error_code{MDB_SUCCESS};
-            SilkwormStatusCode status{silkworm_execute_blocks(*txn->handle(), chain_config->chain_id, block_number,
-                                                              to_block, *batch_size, write_receipts, &current_progress,
-                                                              &lmdb_error_code)};
+            SilkwormStatusCode status{silkworm_execute_blocks_ex(*txn->handle(), chain_config->chain_id, block_number,
+                                                                 to_block, *batch_size, write_receipts,
+                                                                 &current_progress, &lmdb_error_code, prefetch_depth)};
             if (status != SilkwormStatusCode::kSilkwormSuccess &&
                 status != SilkwormStatusCode::kSilkwormBlockNotFound) {
                 SILKWORM_LOG(LogLevel::Error) << "Error in silkworm_execute_blocks: " << magic_enum::enum_name(status)
@@ -111,7 +150,11 @@ int main(int argc, char* argv[]) {
                 break;
             }
 
-            SILKWORM_LOG(LogLevel::Info) << "Blocks <= " << current_progress << " committed" << std::endl;
+            const std::chrono::duration<double> batch_time{std::chrono::steady_clock::now() - batch_start};
+            const double blocks{static_cast<double>(current_progress + 1 - batch_start_block)};
+            SILKWORM_LOG(LogLevel::Info) << "Blocks <= " << current_progress << " committed, "
+                                         << static_cast<uint64_t>(blocks / batch_time.count()) << " blocks/s, peak RSS "
+                                         << peak_rss() / kMebi << " MiB" << std::endl;
             txn = env->begin_rw_transaction();
         }
 
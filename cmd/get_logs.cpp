@@ -0,0 +1,133 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <CLI/CLI.hpp>
+
+#include <silkworm/common/log.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/db/log_filter.hpp>
+#include <silkworm/db/util.hpp>
+
+using namespace silkworm;
+
+// Hex strings of exactly length bytes
+template <typename T>
+static std::optional<std::vector<T>> parse_hex(const std::vector<std::string>& values, size_t length,
+                                               T (*convert)(ByteView)) {
+    std::vector<T> out;
+    for (const auto& value : values) {
+        std::optional<Bytes> bytes{from_hex(value)};
+        if (!bytes || bytes->length() != length) {
+            SILKWORM_LOG(LogLevel::Error) << "Invalid value " << value << std::endl;
+            return std::nullopt;
+        }
+        out.push_back(convert(*bytes));
+    }
+    return out;
+}
+
+int main(int argc, char* argv[]) {
+    namespace fs = std::filesystem;
+
+    CLI::App app{"Queries logs (eth_getLogs style) out of the log indexes"};
+
+    std::string db_path{db::default_path()};
+    uint64_t from_block{0};
+    uint64_t to_block{UINT32_MAX};
+    std::vector<std::string> addresses;
+    std::vector<std::string> topics[4];
+    bool count_only{false};
+    app.add_option("--chaindata", db_path, "Path to a database populated by Turbo-Geth", true)
+        ->check(CLI::ExistingDirectory);
+    app.add_option("--from", from_block, "First block of the range (inclusive)", true);
+    app.add_option("--to", to_block, "Last block of the range (inclusive)", true);
+    app.add_option("--address", addresses, "Accepted log address (repeatable)");
+    for (size_t i{0}; i < 4; ++i) {
+        app.add_option("--topic" + std::to_string(i), topics[i],
+                       "Accepted value of topic " + std::to_string(i) + " (repeatable)");
+    }
+    app.add_flag("--count", count_only, "Only print the number of matching logs");
+    CLI11_PARSE(app, argc, argv);
+
+    // Check data.mdb exists in provided directory
+    fs::path db_file{fs::path(db_path) / fs::path("data.mdb")};
+    if (!fs::exists(db_file)) {
+        SILKWORM_LOG(LogLevel::Error) << "Can't find a valid TG data file in " << db_path << std::endl;
+        return -1;
+    }
+
+    db::LogFilter filter;
+    filter.from_block = from_block;
+    filter.to_block = to_block;
+    auto parsed_addresses{parse_hex(addresses, kAddressLength, &to_address)};
+    if (!parsed_addresses) {
+        return -2;
+    }
+    filter.addresses = std::move(*parsed_addresses);
+    // Positions up to the last one given, the ones in between being wildcards
+    for (size_t i{0}; i < 4; ++i) {
+        if (topics[i].empty()) {
+            continue;
+        }
+        auto parsed_topics{parse_hex(topics[i], kHashLength, &to_bytes32)};
+        if (!parsed_topics) {
+            return -2;
+        }
+        filter.topics.resize(i + 1);
+        filter.topics[i] = std::move(*parsed_topics);
+    }
+
+    lmdb::DatabaseConfig db_config{db_path};
+    std::shared_ptr<lmdb::Environment> env{lmdb::get_env(db_config)};
+    std::unique_ptr<lmdb::Transaction> txn{env->begin_ro_transaction()};
+
+    try {
+        auto start{std::chrono::steady_clock::now()};
+        std::optional<roaring::Roaring> blocks{db::matching_blocks(*txn, filter)};
+        auto index_time{std::chrono::steady_clock::now() - start};
+        start = std::chrono::steady_clock::now();
+        std::vector<db::FilteredLog> logs{db::get_logs(*txn, filter)};
+        auto query_time{std::chrono::steady_clock::now() - start};
+
+        if (!count_only) {
+            for (const auto& [block_number, transaction_index, log_index, log] : logs) {
+                std::cout << "block " << block_number << " tx " << transaction_index << " log " << log_index
+                          << " address " << to_hex(log.address);
+                for (const auto& topic : log.topics) {
+                    std::cout << " " << to_hex(topic);
+                }
+                std::cout << " data " << to_hex(log.data) << "\n";
+            }
+        }
+
+        using std::chrono::duration_cast, std::chrono::microseconds;
+        SILKWORM_LOG(LogLevel::Info) << logs.size() << " logs in "
+                                     << (blocks ? std::to_string(blocks->cardinality()) : "all") << " candidate blocks"
+                                     << ", index lookup " << duration_cast<microseconds>(index_time).count() << " us"
+                                     << ", query " << duration_cast<microseconds>(query_time).count() << " us"
+                                     << std::endl;
+    } catch (const std::exception& ex) {
+        SILKWORM_LOG(LogLevel::Error) << ex.what() << std::endl;
+        return -5;
+    }
+    return 0;
+}
@@ -16,12 +16,15 @@
 
 #include <filesystem>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include <CLI/CLI.hpp>
 #include <boost/endian/conversion.hpp>
 
 #include <silkworm/common/log.hpp>
 #include <silkworm/common/magic_enum.hpp>
+#include <silkworm/common/util.hpp>
 #include <silkworm/db/access_layer.hpp>
 #include <silkworm/db/stages.hpp>
 #include <silkworm/db/tables.hpp>
@@ -80,30 +83,53 @@ void promote_clean_state(lmdb::Transaction* txn, std::string etl_path) {
     MDB_val mdb_data;
     int rc{source_table->seek(&mdb_key, &mdb_data)};
     fs::create_directories(etl_path);
-    etl::Collector collector_account(etl_path.c_str(), 512 * kMebi);
-    etl::Collector collector_storage(etl_path.c_str(), 512 * kMebi);
+    etl::Collector collector_account(etl_path.c_str(), 512 * kMebi, /* parallel */ true);
+    etl::Collector collector_storage(etl_path.c_str(), 512 * kMebi, /* parallel */ true);
     int percent{0};
     uint64_t next_start_byte{0};
+
+    // Keys are hashed in batches. Their views into the table stay valid as it is not written to meanwhile.
+    static constexpr size_t kBatchSize{1024};
+    std::vector<std::pair<ByteView, ByteView>> batch;  // plain key, value
+    std::vector<ByteView> preimages;
+    std::vector<ethash::hash256> hashes;
+    auto hash_batch{[&]() {
+        hashes.resize(preimages.size());
+        keccak256_many(preimages.data(), preimages.size(), hashes.data());
+        const ethash::hash256* hash{hashes.data()};
+        for (const auto& [key, value] : batch) {
+            // Account
+            if (key.length() == kAddressLength) {
+                etl::Entry entry{Bytes(hash++->bytes, kHashLength), Bytes{value}};
+                collector_account.collect(entry);
+            } else {
+                Bytes new_key(kHashLength * 2 + db::kIncarnationLength, '\0');
+                std::memcpy(&new_key[0], hash++->bytes, kHashLength);
+                std::memcpy(&new_key[kHashLength], &key[kAddressLength], db::kIncarnationLength);
+                std::memcpy(&new_key[kHashLength + db::kIncarnationLength], hash++->bytes, kHashLength);
+                etl::Entry entry{new_key, Bytes{value}};
+                collector_storage.collect(entry);
+            }
+        }
+        batch.clear();
+        preimages.clear();
+    }};
+
     while (!rc) { /* Loop as long as we have no errors*/
-        Bytes mdb_key_as_bytes{static_cast<uint8_t*>(mdb_key.mv_data), mdb_key.mv_size};
-        Bytes mdb_value_as_bytes{static_cast<uint8_t*>(mdb_data.mv_data), mdb_data.mv_size};
-        if (static_cast<uint8_t>(mdb_key_as_bytes.at(0)) >= next_start_byte) {
+        ByteView key{db::from_mdb_val(mdb_key)};
+        ByteView value{db::from_mdb_val(mdb_data)};
+        if (key.at(0) >= next_start_byte) {
             SILKWORM_LOG(LogLevel::Info) << "Progress: " << percent << "%" << std::endl;
             percent += 10;
             next_start_byte += 25;
         }
-        // Account
-        if (mdb_key.mv_size == kAddressLength) {
-            etl::Entry entry{Bytes(keccak256(mdb_key_as_bytes).bytes, kHashLength), mdb_value_as_bytes};
-            collector_account.collect(entry);
-        } else {
-            Bytes new_key(kHashLength * 2 + db::kIncarnationLength, '\0');
-            std::memcpy(&new_key[0], keccak256(mdb_key_as_bytes.substr(0, kAddressLength)).bytes, kHashLength);
-            std::memcpy(&new_key[kHashLength], &mdb_key_as_bytes[kAddressLength], db::kIncarnationLength);
-            std::memcpy(&new_key[kHashLength + db::kIncarnationLength],
-                        keccak256(mdb_key_as_bytes.substr(kAddressLength + db::kIncarnationLength)).bytes, kHashLength);
-            etl::Entry entry{new_key, mdb_value_as_bytes};
-            collector_storage.collect(entry);
+        batch.emplace_back(key, value);
+        preimages.push_back(key.substr(0, kAddressLength));
+        if (key.length() != kAddressLength) {
+            preimages.push_back(key.substr(kAddressLength + db::kIncarnationLength));
+        }
+        if (batch.size() == kBatchSize) {
+            hash_batch();
         }
         rc = source_table->get_next(&mdb_key, &mdb_data);
     }
@@ -111,6 +137,7 @@ void promote_clean_state(lmdb::Transaction* txn, std::string etl_path) {
     if (rc && rc != MDB_NOTFOUND) { /* MDB_NOTFOUND is not actually an error rather eof */
         lmdb::err_handler(rc);
     }
+    hash_batch();
 
     SILKWORM_LOG(LogLevel::Info) << "Started Account Loading" << std::endl;
     collector_account.load(txn->open(db::table::kHashedAccounts, MDB_CREATE).get(), nullptr, MDB_APPEND,
@@ -27,6 +27,7 @@
 #include <silkworm/common/log.hpp>
 #include <silkworm/db/access_layer.hpp>
 #include <silkworm/db/bitmap.hpp>
+#include <silkworm/db/index_stages.hpp>
 #include <silkworm/db/stages.hpp>
 #include <silkworm/db/tables.hpp>
 #include <silkworm/etl/collector.hpp>
@@ -79,6 +80,22 @@ int main(int argc, char *argv[]) {
         if (full) {
             last_processed_block_number = 0;
             txn->open(index_config, MDB_CREATE)->clear();
+        } else if (db::stages::get_stage_unwind(*txn, stage_key)) {
+            SILKWORM_LOG(LogLevel::Info) << "Unwinding to block " << db::stages::get_stage_unwind(*txn, stage_key)
+                                         << std::endl;
+            db::unwind_history_index(*txn, storage);
+            lmdb::err_handler(txn->commit());
+            SILKWORM_LOG(LogLevel::Info) << "All Done" << std::endl;
+            return 0;
+        } else if (last_processed_block_number) {
+            // Only the change sets past the stage progress, appended to the last chunks in place
+            SILKWORM_LOG(LogLevel::Info) << "Updating index from block " << last_processed_block_number + 1
+                                         << std::endl;
+            const uint64_t block_number{db::update_history_index(*txn, storage)};
+            lmdb::err_handler(txn->commit());
+            SILKWORM_LOG(LogLevel::Info) << "Latest Block: " << block_number << std::endl;
+            SILKWORM_LOG(LogLevel::Info) << "All Done" << std::endl;
+            return 0;
         }
 
         // Extract
@@ -99,7 +116,7 @@ int main(int argc, char *argv[]) {
                 char composite_key_array[kHashLength + kAddressLength];
                 std::memcpy(&composite_key_array[0], &static_cast<uint8_t *>(mdb_key.mv_data)[8], kAddressLength);
                 std::memcpy(&composite_key_array[kAddressLength], mdb_data.mv_data, kHashLength);
-                composite_key = std::string(composite_key_array);
+                composite_key = std::string(composite_key_array, sizeof(composite_key_array));
             } else {
                 composite_key = std::string(static_cast<char *>(mdb_data.mv_data), kAddressLength);
             }
@@ -146,28 +163,8 @@ int main(int argc, char *argv[]) {
             // Eventually load collected items WITH transform (may throw)
             collector.load(
                 txn->open(index_config, MDB_CREATE).get(),
-                [](etl::Entry entry, lmdb::Table *history_index_table, unsigned int db_flags) {
-                    auto bm{roaring::Roaring64Map::readSafe(byte_ptr_cast(entry.value.data()), entry.value.size())};
-                    Bytes last_chunk_index(entry.key.size() + 8, '\0');
-                    std::memcpy(&last_chunk_index[0], &entry.key[0], entry.key.size());
-                    boost::endian::store_big_u64(&last_chunk_index[entry.key.size()], UINT64_MAX);
-                    auto previous_bitmap_bytes{history_index_table->get(last_chunk_index)};
-                    if (previous_bitmap_bytes.has_value()) {
-                        bm |= roaring::Roaring64Map::readSafe(byte_ptr_cast(previous_bitmap_bytes->data()),
-                                                              previous_bitmap_bytes->size());
-                        db_flags = 0;
-                    }
-                    while (bm.cardinality() > 0) {
-                        auto current_chunk{db::bitmap::cut_left(bm, db::bitmap::kBitmapChunkLimit)};
-                        // make chunk index
-                        Bytes chunk_index(entry.key.size() + 8, '\0');
-                        std::memcpy(&chunk_index[0], &entry.key[0], entry.key.size());
-                        uint64_t suffix{bm.cardinality() == 0 ? UINT64_MAX : current_chunk.maximum()};
-                        boost::endian::store_big_u64(&chunk_index[entry.key.size()], suffix);
-                        Bytes current_chunk_bytes(current_chunk.getSizeInBytes(), '\0');
-                        current_chunk.write(byte_ptr_cast(&current_chunk_bytes[0]));
-                        history_index_table->put(chunk_index, current_chunk_bytes, db_flags);
-                    }
+                [](etl::EntryView entry, lmdb::Table *history_index_table, unsigned int db_flags) {
+                    db::bitmap::append(*history_index_table, entry.key, db::bitmap::read(entry.value), db_flags);
                 },
                 db_flags, /* log_every_percent = */ 20);
 
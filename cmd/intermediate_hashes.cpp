@@ -0,0 +1,105 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <filesystem>
+#include <iostream>
+
+#include <CLI/CLI.hpp>
+
+#include <silkworm/common/log.hpp>
+#include <silkworm/db/access_layer.hpp>
+#include <silkworm/db/stages.hpp>
+#include <silkworm/db/tables.hpp>
+#include <silkworm/trie/db_trie.hpp>
+
+using namespace silkworm;
+namespace fs = std::filesystem;
+
+int main(int argc, char* argv[]) {
+    CLI::App app{"Generates intermediate hashes & checks the state root"};
+
+    std::string db_path{db::default_path()};
+    bool full{false};
+    size_t num_threads{1};
+    app.add_option("-d,--datadir", db_path, "Path to a database populated by Turbo-Geth", true)
+        ->check(CLI::ExistingDirectory);
+    app.add_flag("--full", full, "Regenerate the intermediate hashes from scratch");
+    app.add_option("--threads", num_threads, "Number of threads regenerating the intermediate hashes", true)
+        ->check(CLI::Range(1, 16));
+    CLI11_PARSE(app, argc, argv);
+
+    // Check data.mdb exists in provided directory
+    fs::path db_file{fs::path(db_path) / fs::path("data.mdb")};
+    if (!fs::exists(db_file)) {
+        SILKWORM_LOG(LogLevel::Error) << "Can't find a valid TG data file in " << db_path << std::endl;
+        return -1;
+    }
+    fs::path datadir(db_path);
+    fs::path etl_path(datadir.parent_path() / fs::path("etl-temp"));
+    fs::create_directories(etl_path);
+
+    lmdb::DatabaseConfig db_config{db_path};
+    db_config.set_readonly(false);
+    std::shared_ptr<lmdb::Environment> env{lmdb::get_env(db_config)};
+    std::unique_ptr<lmdb::Transaction> txn{env->begin_rw_transaction()};
+
+    try {
+        const uint64_t from{db::stages::get_stage_progress(*txn, db::stages::kIntermediateHashesKey)};
+        const uint64_t to{db::stages::get_stage_progress(*txn, db::stages::kExecutionKey)};
+
+        std::optional<evmc::bytes32> hash{db::read_canonical_hash(*txn, to)};
+        if (!hash) {
+            throw std::runtime_error("Could not find canonical hash of block " + std::to_string(to));
+        }
+        std::optional<BlockHeader> header{db::read_header(*txn, to, hash->bytes)};
+        if (!header) {
+            throw std::runtime_error("Could not find header of block " + std::to_string(to));
+        }
+
+        if ((full || from == 0) && num_threads > 1) {
+            SILKWORM_LOG(LogLevel::Info) << "Regenerating intermediate hashes with " << num_threads << " threads"
+                                         << std::endl;
+            // Workers read the committed state within their own transactions
+            txn.reset();
+            trie::ParallelDbTrieLoader loader{*env, etl_path.string().c_str(), num_threads};
+            const evmc::bytes32 root{loader.calculate_root()};
+            if (root != header->state_root) {
+                SILKWORM_LOG(LogLevel::Error) << "Wrong trie root: " << to_hex(root)
+                                              << ", expected: " << to_hex(header->state_root) << std::endl;
+                throw trie::WrongRoot{};
+            }
+            txn = env->begin_rw_transaction();
+            txn->open(db::table::kTrieOfAccounts)->clear();
+            txn->open(db::table::kTrieOfStorage)->clear();
+            loader.load(*txn);
+        } else if (full || from == 0) {
+            SILKWORM_LOG(LogLevel::Info) << "Regenerating intermediate hashes" << std::endl;
+            trie::regenerate_db_tries(*txn, etl_path.string().c_str(), &header->state_root);
+        } else {
+            SILKWORM_LOG(LogLevel::Info) << "Incrementing intermediate hashes from block " << from << " to " << to
+                                         << std::endl;
+            trie::increment_db_tries(*txn, etl_path.string().c_str(), from, &header->state_root);
+        }
+
+        db::stages::set_stage_progress(*txn, db::stages::kIntermediateHashesKey, to);
+        lmdb::err_handler(txn->commit());
+        txn.reset();
+        SILKWORM_LOG(LogLevel::Info) << "All Done! State root " << to_hex(header->state_root) << std::endl;
+    } catch (const std::exception& ex) {
+        SILKWORM_LOG(LogLevel::Error) << ex.what() << std::endl;
+        return -5;
+    }
+}
@@ -14,128 +14,197 @@
    limitations under the License.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <filesystem>
 #include <iomanip>
+#include <memory>
 #include <string>
 #include <thread>
 #include <unordered_map>
 
 #include <CLI/CLI.hpp>
 #include <boost/endian/conversion.hpp>
-#include <cbor/decoder.h>
 
 #include <silkworm/common/cast.hpp>
 #include <silkworm/common/log.hpp>
 #include <silkworm/db/access_layer.hpp>
 #include <silkworm/db/bitmap.hpp>
+#include <silkworm/db/index_stages.hpp>
 #include <silkworm/db/stages.hpp>
 #include <silkworm/db/tables.hpp>
 #include <silkworm/etl/collector.hpp>
+#include <silkworm/types/log_cbor.hpp>
 
 using namespace silkworm;
 
 constexpr size_t kBitmapBufferSizeLimit = 512 * kMebi;
 
-void loader_function(etl::Entry entry, lmdb::Table *target_table, unsigned int db_flags) {
+void loader_function(etl::EntryView entry, lmdb::Table *target_table, unsigned int db_flags) {
     auto bm{roaring::Roaring::readSafe(byte_ptr_cast(entry.value.data()), entry.value.size())};
-    Bytes last_chunk_index(entry.key.size() + 4, '\0');
-    std::memcpy(&last_chunk_index[0], &entry.key[0], entry.key.size());
-    boost::endian::store_big_u32(&last_chunk_index[entry.key.size()], UINT32_MAX);
-    auto previous_bitmap_bytes{target_table->get(last_chunk_index)};
-    if (previous_bitmap_bytes.has_value()) {
-        bm |= roaring::Roaring::readSafe(byte_ptr_cast(previous_bitmap_bytes->data()), previous_bitmap_bytes->size());
-        db_flags = 0;
-    }
-    while (bm.cardinality() > 0) {
-        auto current_chunk{db::bitmap::cut_left(bm, db::bitmap::kBitmapChunkLimit)};
-        // make chunk index
-        Bytes chunk_index(entry.key.size() + 4, '\0');
-        std::memcpy(&chunk_index[0], &entry.key[0], entry.key.size());
-        uint64_t suffix{bm.cardinality() == 0 ? UINT32_MAX : current_chunk.maximum()};
-        boost::endian::store_big_u32(&chunk_index[entry.key.size()], suffix);
-        Bytes current_chunk_bytes(current_chunk.getSizeInBytes(), '\0');
-        current_chunk.write(byte_ptr_cast(&current_chunk_bytes[0]));
-        target_table->put(chunk_index, current_chunk_bytes, db_flags);
-    }
+    db::bitmap::append(*target_table, entry.key, std::move(bm), db_flags);
 }
 
-class listener_log_index : public cbor::listener {
-  public:
-    listener_log_index(uint64_t block_number, std::unordered_map<std::string, roaring::Roaring> *topics_map,
-                       std::unordered_map<std::string, roaring::Roaring> *addrs_map, uint64_t *allocated_topics,
-                       uint64_t *allocated_addrs_)
-        : block_number_(block_number),
-          topics_map_(topics_map),
-          addrs_map_(addrs_map),
-          allocated_topics_(allocated_topics),
-          allocated_addrs_(allocated_addrs_){};
-
-    void on_integer(int) override{};
-
-    void on_bytes(unsigned char *data, int size) override {
-        std::string key(byte_ptr_cast(data), size);
-        if (size == kHashLength) {
-            if (topics_map_->find(key) == topics_map_->end()) {
-                topics_map_->emplace(key, roaring::Roaring());
+// Blocks holding logs with each topic & address
+struct LogBitmaps {
+    std::unordered_map<evmc::bytes32, roaring::Roaring> topics;
+    std::unordered_map<evmc::address, roaring::Roaring> addresses;
+    uint64_t allocated_topics{0};
+    uint64_t allocated_addrs{0};
+
+    void add(uint32_t block_number, const Log &log) {
+        addresses[log.address].add(block_number);
+        allocated_addrs += kAddressLength;
+        for (const auto &topic : log.topics) {
+            topics[topic].add(block_number);
+            allocated_topics += kHashLength;
+        }
+    }
+
+    void merge(LogBitmaps &other) {
+        for (auto &[topic, bm] : other.topics) {
+            auto [it, inserted]{topics.try_emplace(topic, std::move(bm))};
+            if (!inserted) {
+                it->second |= bm;
             }
-            topics_map_->at(key).add(block_number_);
-            *allocated_topics_ += kHashLength;
-        } else if (size == kAddressLength) {
-            if (addrs_map_->find(key) == addrs_map_->end()) {
-                addrs_map_->emplace(key, roaring::Roaring());
+        }
+        for (auto &[address, bm] : other.addresses) {
+            auto [it, inserted]{addresses.try_emplace(address, std::move(bm))};
+            if (!inserted) {
+                it->second |= bm;
             }
-            addrs_map_->at(key).add(block_number_);
-            *allocated_addrs_ += kAddressLength;
         }
+        allocated_topics += other.allocated_topics;
+        allocated_addrs += other.allocated_addrs;
+        other = LogBitmaps{};
     }
+};
 
-    void on_string(std::string &) override{};
-
-    void on_array(int) override {}
-
-    void on_map(int) override{};
-
-    void on_tag(unsigned int) override{};
-
-    void on_special(unsigned int) override{};
-
-    void on_bool(bool) override{};
-
-    void on_null() override{};
-
-    void on_undefined() override{};
-
-    void on_error(const char *) override{};
-
-    void on_extra_integer(unsigned long long, int) override{};
+template <typename Key>
+void flush_bitmaps(etl::Collector &collector, std::unordered_map<Key, roaring::Roaring> &map) {
+    for (const auto &[key, bm] : map) {
+        Bytes bitmap_bytes(bm.getSizeInBytes(), '\0');
+        bm.write(byte_ptr_cast(bitmap_bytes.data()));
+        etl::Entry entry{Bytes{full_view(key)}, bitmap_bytes};
+        collector.collect(entry);
+    }
+    map.clear();
+}
 
-    void on_extra_tag(unsigned long long) override{};
+/*
+ * Extracts bitmaps out of the log table in rounds of kRoundSize blocks. Within a round, workers claim
+ * segments of kSegmentSize blocks and index them into bitmaps of their own within a read-only transaction
+ * of their own; at the end of the round per-worker bitmaps are OR-ed together and eventually flushed into
+ * the collectors, which are not thread-safe.
+ * A dbi opened by a transaction stays private to it until it commits, so workers read the log table through
+ * a dbi published on construction by a short read-only transaction: the extractor must thus be constructed
+ * before the calling thread begins its read-write transaction.
+ */
+class LogIndexExtractor {
+  public:
+    static constexpr uint64_t kRoundSize{200'000};
+    static constexpr uint64_t kSegmentSize{1'000};
 
-    void on_extra_special(unsigned long long) override{};
+    LogIndexExtractor(lmdb::Environment &env, size_t num_workers) : env_{env}, workers_(num_workers) {
+        std::unique_ptr<lmdb::Transaction> txn{env_.begin_ro_transaction()};
+        logs_dbi_ = txn->open(db::table::kLogs)->get_dbi();
+        lmdb::err_handler(txn->commit());
+    }
 
-    void on_double(double) override{};
+    // Returns the highest block with logs in [from, to], if any
+    std::optional<uint64_t> extract(uint64_t from, uint64_t to, etl::Collector &topic_collector,
+                                    etl::Collector &addresses_collector) {
+        std::optional<uint64_t> last_block{};
+        LogBitmaps merged;
+        for (uint64_t round_from{from}; round_from <= to; round_from += kRoundSize) {
+            const uint64_t round_to{std::min(to, round_from + kRoundSize - 1)};
+            run_round(round_from, round_to);
+
+            for (Worker &worker : workers_) {
+                merged.merge(worker.bitmaps);
+                if (worker.last_block && (!last_block || *worker.last_block > *last_block)) {
+                    last_block = worker.last_block;
+                }
+            }
 
-    void on_float32(float) override{};
+            if (merged.allocated_topics > kBitmapBufferSizeLimit) {
+                flush_bitmaps(topic_collector, merged.topics);
+                merged.allocated_topics = 0;
+            }
+            if (merged.allocated_addrs > kBitmapBufferSizeLimit) {
+                flush_bitmaps(addresses_collector, merged.addresses);
+                merged.allocated_addrs = 0;
+            }
+            SILKWORM_LOG(LogLevel::Info) << "Current Block: " << round_to << std::endl;
 
-    void set_block_number(uint64_t block_number) { block_number_ = block_number; }
+            if (round_to == to) {
+                break;  // prevent overflow when to is close to UINT64_MAX
+            }
+        }
+        flush_bitmaps(topic_collector, merged.topics);
+        flush_bitmaps(addresses_collector, merged.addresses);
+        return last_block;
+    }
 
   private:
-    uint64_t block_number_;
-    std::unordered_map<std::string, roaring::Roaring> *topics_map_;
-    std::unordered_map<std::string, roaring::Roaring> *addrs_map_;
-    uint64_t *allocated_topics_;
-    uint64_t *allocated_addrs_;
-};
+    struct Worker {
+        LogBitmaps bitmaps;
+        std::optional<uint64_t> last_block{};
+        std::exception_ptr exception{};
+    };
+
+    void run_round(uint64_t from, uint64_t to) {
+        std::atomic<uint64_t> next_segment{from};
+        std::vector<std::thread> threads;
+        for (Worker &worker : workers_) {
+            threads.emplace_back([&]() {
+                try {
+                    index_segments(worker, next_segment, to);
+                } catch (...) {
+                    worker.exception = std::current_exception();
+                }
+            });
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        for (Worker &worker : workers_) {
+            if (worker.exception) {
+                std::rethrow_exception(worker.exception);
+            }
+        }
+    }
 
-void flush_bitmaps(etl::Collector &collector, std::unordered_map<std::string, roaring::Roaring> &map) {
-    for (const auto &[key, bm] : map) {
-        Bytes bitmap_bytes(bm.getSizeInBytes(), '\0');
-        bm.write(byte_ptr_cast(bitmap_bytes.data()));
-        etl::Entry entry{Bytes(byte_ptr_cast(key.c_str()), key.size()), bitmap_bytes};
-        collector.collect(entry);
+    void index_segments(Worker &worker, std::atomic<uint64_t> &next_segment, uint64_t to) {
+        std::unique_ptr<lmdb::Transaction> txn{env_.begin_ro_transaction()};
+        auto log_table{std::make_unique<lmdb::Table>(txn.get(), logs_dbi_, db::table::kLogs.name)};
+
+        std::vector<Log> logs;
+        for (uint64_t segment_from{next_segment.fetch_add(kSegmentSize)}; segment_from <= to;
+             segment_from = next_segment.fetch_add(kSegmentSize)) {
+            const uint64_t segment_to{std::min(to, segment_from + kSegmentSize - 1)};
+            for (auto entry{log_table->seek(db::block_key(segment_from))}; entry; entry = log_table->get_next()) {
+                const uint64_t block_number{boost::endian::load_big_u64(entry->key.data())};
+                if (block_number > segment_to) {
+                    break;
+                }
+                logs.clear();
+                if (!cbor_decode(entry->value, logs)) {
+                    throw std::runtime_error("Invalid CBOR logs at block " + std::to_string(block_number));
+                }
+                for (const Log &log : logs) {
+                    worker.bitmaps.add(static_cast<uint32_t>(block_number), log);
+                }
+                worker.last_block = std::max(worker.last_block.value_or(0), block_number);
+            }
+        }
     }
-    map.clear();
-}
+
+    lmdb::Environment &env_;
+    MDB_dbi logs_dbi_{0};
+    std::vector<Worker> workers_;
+};
 
 int main(int argc, char *argv[]) {
     namespace fs = std::filesystem;
@@ -144,10 +213,13 @@ int main(int argc, char *argv[]) {
 
     std::string db_path{db::default_path()};
     bool full;
+    size_t num_workers{std::max(std::thread::hardware_concurrency(), 1u)};
     app.add_option("--chaindata", db_path, "Path to a database populated by Turbo-Geth", true)
         ->check(CLI::ExistingDirectory);
 
     app.add_flag("--full", full, "Start making history indexes from block 0");
+    app.add_option("--workers", num_workers, "Number of extraction threads", true)
+        ->check(CLI::Range(1u, std::max(std::thread::hardware_concurrency(), 1u)));
 
     CLI11_PARSE(app, argc, argv);
 
@@ -166,6 +238,7 @@ int main(int argc, char *argv[]) {
     lmdb::DatabaseConfig db_config{db_path};
     db_config.set_readonly(false);
     std::shared_ptr<lmdb::Environment> env{lmdb::get_env(db_config)};
+    LogIndexExtractor extractor{*env, num_workers};  // Before the read-write transaction begins
     std::unique_ptr<lmdb::Transaction> txn{env->begin_rw_transaction()};
     // We take data from header table and transform it and put it in blockhashes table
     auto log_table{txn->open(db::table::kLogs)};
@@ -177,51 +250,40 @@ int main(int argc, char *argv[]) {
             last_processed_block_number = 0;
             txn->open(db::table::kLogTopicIndex, MDB_CREATE)->clear();
             txn->open(db::table::kLogAddressIndex, MDB_CREATE)->clear();
+        } else if (db::stages::get_stage_unwind(*txn, db::stages::kLogIndexKey)) {
+            SILKWORM_LOG(LogLevel::Info) << "Unwinding to block "
+                                         << db::stages::get_stage_unwind(*txn, db::stages::kLogIndexKey) << std::endl;
+            db::unwind_log_index(*txn);
+            lmdb::err_handler(txn->commit());
+            SILKWORM_LOG(LogLevel::Info) << "All Done" << std::endl;
+            return 0;
+        } else if (last_processed_block_number) {
+            // Only the logs past the stage progress, appended to the last chunks in place
+            SILKWORM_LOG(LogLevel::Info) << "Updating index from block " << last_processed_block_number + 1
+                                         << std::endl;
+            const uint64_t block_number{db::update_log_index(*txn)};
+            lmdb::err_handler(txn->commit());
+            SILKWORM_LOG(LogLevel::Info) << "Latest Block: " << block_number << std::endl;
+            SILKWORM_LOG(LogLevel::Info) << "All Done" << std::endl;
+            return 0;
         }
 
-        // Extract
-        Bytes start(8, '\0');
-        boost::endian::store_big_u64(&start[0], last_processed_block_number);
-        MDB_val mdb_key{db::to_mdb_val(start)};
-        MDB_val mdb_data;
-
-        SILKWORM_LOG(LogLevel::Info) << "Started Log Index Extraction" << std::endl;
-
-        uint64_t block_number{0};
-        uint64_t topics_allocated_space{0};
-        uint64_t addrs_allocated_space{0};
-        std::unordered_map<std::string, roaring::Roaring> topic_bitmaps;
-        std::unordered_map<std::string, roaring::Roaring> addresses_bitmaps;
-        listener_log_index current_listener(block_number, &topic_bitmaps, &addresses_bitmaps, &topics_allocated_space,
-                                            &addrs_allocated_space);
-        int rc{log_table->seek(&mdb_key, &mdb_data)};  // Sets cursor to nearest key greater equal than this
-        while (!rc) {                                  /* Loop as long as we have no errors*/
-            block_number = boost::endian::load_big_u64(static_cast<uint8_t *>(mdb_key.mv_data));
-            current_listener.set_block_number(block_number);
-            cbor::input input(static_cast<uint8_t *>(mdb_data.mv_data), mdb_data.mv_size);
-            cbor::decoder decoder(input, current_listener);
-            decoder.run();
-            if (topics_allocated_space > kBitmapBufferSizeLimit) {
-                flush_bitmaps(topic_collector, topic_bitmaps);
-                SILKWORM_LOG(LogLevel::Info) << "Current Block: " << block_number << std::endl;
-                topics_allocated_space = 0;
-            }
-
-            if (addrs_allocated_space > kBitmapBufferSizeLimit) {
-                flush_bitmaps(addresses_collector, addresses_bitmaps);
-                SILKWORM_LOG(LogLevel::Info) << "Current Block: " << block_number << std::endl;
-                addrs_allocated_space = 0;
-            }
-
-            rc = log_table->get_next(&mdb_key, &mdb_data);
+        // Extract up to the last block with logs
+        MDB_val mdb_key, mdb_data;
+        int rc{log_table->get_last(&mdb_key, &mdb_data)};
+        if (rc == MDB_NOTFOUND) {
+            SILKWORM_LOG(LogLevel::Info) << "Nothing to index" << std::endl;
+            return 0;
         }
+        lmdb::err_handler(rc);
+        const uint64_t last_log_block{boost::endian::load_big_u64(static_cast<uint8_t *>(mdb_key.mv_data))};
 
-        if (rc && rc != MDB_NOTFOUND) { /* MDB_NOTFOUND is not actually an error rather eof */
-            lmdb::err_handler(rc);
-        }
+        SILKWORM_LOG(LogLevel::Info) << "Started Log Index Extraction with " << num_workers << " workers"
+                                     << std::endl;
 
-        flush_bitmaps(topic_collector, topic_bitmaps);
-        flush_bitmaps(addresses_collector, addresses_bitmaps);
+        const uint64_t block_number{
+            extractor.extract(last_processed_block_number, last_log_block, topic_collector, addresses_collector)
+                .value_or(last_processed_block_number)};
 
         SILKWORM_LOG(LogLevel::Info) << "Latest Block: " << block_number << std::endl;
         // Proceed only if we've done something
@@ -16,11 +16,13 @@
 
 #include <filesystem>
 #include <iostream>
+#include <vector>
 
 #include <CLI/CLI.hpp>
 #include <boost/endian/conversion.hpp>
 
 #include <silkworm/common/log.hpp>
+#include <silkworm/common/util.hpp>
 #include <silkworm/db/access_layer.hpp>
 #include <silkworm/db/stages.hpp>
 #include <silkworm/db/tables.hpp>
@@ -58,7 +60,7 @@ int main(int argc, char* argv[]) {
     fs::path datadir(db_path);
     fs::path etl_path(datadir.parent_path() / fs::path("etl-temp"));
     fs::create_directories(etl_path);
-    etl::Collector collector(etl_path.string().c_str(), /* flush size */ 512 * kMebi);
+    etl::Collector collector(etl_path.string().c_str(), /* flush size */ 512 * kMebi, /* parallel */ true);
 
     lmdb::DatabaseConfig db_config{db_path};
     db_config.set_readonly(false);
@@ -81,6 +83,8 @@ int main(int argc, char* argv[]) {
         MDB_val mdb_key{db::to_mdb_val(start)};
         MDB_val mdb_data;
         SILKWORM_LOG(LogLevel::Info) << "Started Tx Lookup Extraction" << std::endl;
+        std::vector<ByteView> tx_rlps;
+        std::vector<ethash::hash256> tx_hashes;
         int rc{bodies_table->seek(&mdb_key, &mdb_data)};  // Sets cursor to nearest key greater equal than this
         while (!rc) {                                     /* Loop as long as we have no errors*/
             auto body_rlp{db::from_mdb_val(mdb_data)};
@@ -94,14 +98,18 @@ int main(int argc, char* argv[]) {
                 MDB_val tx_key_mdb{db::to_mdb_val(transaction_key)};
                 MDB_val tx_data_mdb{};
 
+                // Take the transactions rlp of the block, then hash them all at once to get the transaction hashes
+                tx_rlps.clear();
                 uint64_t i{0};
                 for (rc = transactions_table->seek_exact(&tx_key_mdb, &tx_data_mdb);
                      rc != MDB_NOTFOUND && i < body.txn_count;
                      rc = transactions_table->get_next(&tx_key_mdb, &tx_data_mdb), ++i) {
                     lmdb::err_handler(rc);
-                    // Take transaction rlp, then hash it in order to get the transaction hash
-                    ByteView tx_rlp{db::from_mdb_val(tx_data_mdb)};
-                    auto hash{keccak256(tx_rlp)};
+                    tx_rlps.push_back(db::from_mdb_val(tx_data_mdb));
+                }
+                tx_hashes.resize(tx_rlps.size());
+                keccak256_many(tx_rlps.data(), tx_rlps.size(), tx_hashes.data());
+                for (const auto& hash : tx_hashes) {
                     etl::Entry entry{Bytes(hash.bytes, 32), Bytes(lookup_block_data.data(), lookup_block_data.size())};
                     collector.collect(entry);
                 }
@@ -23,7 +23,7 @@
 namespace silkworm {
 
 Blockchain::Blockchain(StateBuffer& state, const ChainConfig& config, const Block& genesis_block)
-    : state_{state}, config_{config} {
+    : state_{state}, config_{config}, intra_block_state_{state} {
     evmc::bytes32 hash{genesis_block.header.hash()};
     state_.insert_block(genesis_block, hash);
     state_.canonize_block(genesis_block.header.number, hash);
@@ -90,7 +90,8 @@ ValidationResult Blockchain::insert_block(Block& block, bool check_state_root) {
 
 ValidationResult Blockchain::execute_block(const Block& block, bool check_state_root) {
     std::pair<std::vector<Receipt>, ValidationResult> res{
-        silkworm::execute_block(block, state_, config_, /*analysis_cache=*/nullptr, state_pool, exo_evm)};
+        silkworm::execute_block(block, intra_block_state_, config_, /*analysis_cache=*/nullptr, state_pool, exo_evm,
+                                speculation_pool)};
     if (res.second != ValidationResult::kOk) {
         return res.second;
     }
@@ -21,8 +21,10 @@
 #include <vector>
 
 #include <silkworm/chain/validity.hpp>
+#include <silkworm/execution/speculation_pool.hpp>
 #include <silkworm/execution/state_pool.hpp>
 #include <silkworm/state/buffer.hpp>
+#include <silkworm/state/intra_block_state.hpp>
 
 namespace silkworm {
 
@@ -39,6 +41,8 @@ class Blockchain {
 
     evmc_vm* exo_evm{nullptr};
 
+    SpeculationPool* speculation_pool{nullptr};  // see ExecutionProcessor::execute_block_in_parallel
+
   private:
     ValidationResult execute_block(const Block& block, bool check_state_root);
 
@@ -53,6 +57,7 @@ class Blockchain {
 
     StateBuffer& state_;
     const ChainConfig& config_;
+    IntraBlockState intra_block_state_;  // reused for every executed block
     std::unordered_map<evmc::bytes32, ValidationResult> bad_blocks_;
 };
 
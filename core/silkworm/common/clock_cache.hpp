@@ -0,0 +1,177 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_COMMON_CLOCK_CACHE_HPP_
+#define SILKWORM_COMMON_CLOCK_CACHE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace silkworm {
+
+/*
+ * A fixed capacity cache approximating LRU with the CLOCK algorithm.
+ *
+ * Entries live in a flat array of slots allocated once at construction and are found through
+ * an open addressing (linear probing) index of slot numbers with load factor <= 1/2, hence no
+ * per entry node is ever allocated. A hit only sets the slot's reference bit; on put to a full cache the
+ * clock hand sweeps the slots clearing reference bits and evicts the first unreferenced one.
+ *
+ * Lookups are heterogeneous: any type K for which both hash_t and key_equal_t accept K
+ * can be used (e.g. an evmc::bytes32 view of a wider key).
+ *
+ * The cache is not thread-safe, except that concurrent calls to get are fine as long as there's no concurrent
+ * put or clear (e.g. under a shared lock): reference bits are the only state get modifies and they're atomic.
+ */
+template <typename key_t, typename value_t, typename hash_t = std::hash<key_t>,
+          typename key_equal_t = std::equal_to<>>
+class ClockCache {
+  public:
+    explicit ClockCache(size_t max_size)
+        : capacity_{max_size}, referenced_{std::make_unique<std::atomic<uint8_t>[]>(max_size)} {
+        size_t index_size{1};
+        while (index_size < 2 * capacity_) {
+            index_size <<= 1;
+        }
+        index_.assign(index_size, kEmpty);
+        mask_ = index_size - 1;
+        slots_.reserve(capacity_);
+        hashes_.reserve(capacity_);
+    }
+
+    void put(const key_t& key, const value_t& value) {
+        if (!capacity_) {
+            return;
+        }
+        const size_t hash{hash_t{}(key)};
+        size_t pos{find_position(key, hash)};
+        if (index_[pos] != kEmpty) {
+            slots_[index_[pos]].second = value;
+            referenced_[index_[pos]].store(1, std::memory_order_relaxed);
+            return;
+        }
+
+        uint32_t slot{kEmpty};
+        if (slots_.size() < capacity_) {
+            slot = static_cast<uint32_t>(slots_.size());
+            slots_.emplace_back(key, value);
+            hashes_.push_back(hash);
+            referenced_[slot].store(0, std::memory_order_relaxed);
+        } else {
+            slot = evict();
+            slots_[slot].first = key;
+            slots_[slot].second = value;
+            hashes_[slot] = hash;
+            referenced_[slot].store(0, std::memory_order_relaxed);
+            pos = find_position(key, hash);  // eviction might have shifted the probe sequence
+        }
+        index_[pos] = slot;
+    }
+
+    template <typename K>
+    const value_t* get(const K& key) {
+        const size_t pos{find_position(key, hash_t{}(key))};
+        const uint32_t slot{index_[pos]};
+        if (slot == kEmpty) {
+            return nullptr;
+        }
+        referenced_[slot].store(1, std::memory_order_relaxed);
+        return &slots_[slot].second;
+    }
+
+    size_t size() const noexcept { return slots_.size(); }
+
+    size_t max_size() const noexcept { return capacity_; }
+
+    void clear() noexcept {
+        slots_.clear();
+        hashes_.clear();
+        std::fill(index_.begin(), index_.end(), kEmpty);
+        hand_ = 0;
+    }
+
+  private:
+    static constexpr uint32_t kEmpty{UINT32_MAX};
+
+    // Position in the index either holding the key's slot or the empty one where it would be inserted
+    template <typename K>
+    size_t find_position(const K& key, size_t hash) const {
+        size_t pos{hash & mask_};
+        while (index_[pos] != kEmpty) {
+            const uint32_t slot{index_[pos]};
+            if (hashes_[slot] == hash && key_equal_t{}(slots_[slot].first, key)) {
+                break;
+            }
+            pos = (pos + 1) & mask_;
+        }
+        return pos;
+    }
+
+    // Returns the number of the evicted slot, which has been removed from the index
+    uint32_t evict() {
+        while (referenced_[hand_].load(std::memory_order_relaxed)) {
+            referenced_[hand_].store(0, std::memory_order_relaxed);
+            hand_ = (hand_ + 1) % capacity_;
+        }
+        const auto victim{static_cast<uint32_t>(hand_)};
+        hand_ = (hand_ + 1) % capacity_;
+
+        size_t pos{hashes_[victim] & mask_};
+        while (index_[pos] != victim) {
+            pos = (pos + 1) & mask_;
+        }
+        erase_position(pos);
+        return victim;
+    }
+
+    // Backward shift deletion : keeps probe sequences intact without tombstones
+    void erase_position(size_t pos) {
+        size_t next{pos};
+        while (true) {
+            next = (next + 1) & mask_;
+            const uint32_t slot{index_[next]};
+            if (slot == kEmpty) {
+                break;
+            }
+            const size_t home{hashes_[slot] & mask_};
+            // Move the entry back unless its home lies cyclically in (pos, next]
+            const bool stays{pos <= next ? (pos < home && home <= next) : (pos < home || home <= next)};
+            if (!stays) {
+                index_[pos] = slot;
+                pos = next;
+            }
+        }
+        index_[pos] = kEmpty;
+    }
+
+    const size_t capacity_;
+    size_t mask_{0};
+    size_t hand_{0};
+    std::vector<uint32_t> index_;
+    std::vector<std::pair<key_t, value_t>> slots_;
+    std::vector<size_t> hashes_;
+    std::unique_ptr<std::atomic<uint8_t>[]> referenced_;  // CLOCK reference bits
+};
+
+}  // namespace silkworm
+
+#endif  // SILKWORM_COMMON_CLOCK_CACHE_HPP_
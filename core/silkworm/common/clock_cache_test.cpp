@@ -0,0 +1,126 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "clock_cache.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <silkworm/common/base.hpp>
+
+namespace silkworm {
+
+TEST_CASE("ClockCache put & get") {
+    ClockCache<int, int> cache(1);
+    CHECK(cache.get(7) == nullptr);
+    cache.put(7, 777);
+    REQUIRE(cache.get(7));
+    CHECK(777 == *cache.get(7));
+    cache.put(7, 778);
+    CHECK(778 == *cache.get(7));
+    CHECK(cache.size() == 1);
+
+    cache.put(8, 888);
+    CHECK(cache.get(7) == nullptr);
+    REQUIRE(cache.get(8));
+    CHECK(888 == *cache.get(8));
+    CHECK(cache.size() == 1);
+
+    cache.clear();
+    CHECK(cache.get(8) == nullptr);
+    CHECK(cache.size() == 0);
+}
+
+TEST_CASE("ClockCache keeps referenced entries") {
+    static constexpr int kCapacity{50};
+    ClockCache<int, int> cache(kCapacity);
+
+    for (int i{0}; i < kCapacity; ++i) {
+        cache.put(i, i);
+    }
+    // Entries referenced since the last sweep survive the next evictions
+    for (int i{0}; i < kCapacity; i += 2) {
+        REQUIRE(cache.get(i));
+    }
+    for (int i{kCapacity}; i < kCapacity + kCapacity / 2; ++i) {
+        cache.put(i, i);
+    }
+    CHECK(cache.size() == kCapacity);
+
+    for (int i{0}; i < kCapacity; ++i) {
+        if (i % 2 == 0) {
+            REQUIRE(cache.get(i));
+            CHECK(*cache.get(i) == i);
+        } else {
+            CHECK(cache.get(i) == nullptr);
+        }
+    }
+    for (int i{kCapacity}; i < kCapacity + kCapacity / 2; ++i) {
+        REQUIRE(cache.get(i));
+        CHECK(*cache.get(i) == i);
+    }
+}
+
+TEST_CASE("ClockCache survives colliding keys") {
+    // Worst case for the index : all keys share the same home position
+    struct ConstantHash {
+        size_t operator()(int) const noexcept { return 42; }
+    };
+    static constexpr int kCapacity{16};
+    ClockCache<int, int, ConstantHash> cache(kCapacity);
+
+    for (int i{0}; i < 10 * kCapacity; ++i) {
+        cache.put(i, -i);
+        REQUIRE(cache.get(i));
+        CHECK(*cache.get(i) == -i);
+    }
+    CHECK(cache.size() == kCapacity);
+
+    size_t found{0};
+    for (int i{0}; i < 10 * kCapacity; ++i) {
+        if (const int* value{cache.get(i)}) {
+            CHECK(*value == -i);
+            ++found;
+        }
+    }
+    CHECK(found == kCapacity);
+}
+
+TEST_CASE("ClockCache heterogeneous lookup") {
+    struct CodeKey {
+        evmc::bytes32 code_hash;
+        uint64_t revision{0};
+    };
+    struct CodeKeyHash {
+        size_t operator()(const evmc::bytes32& hash) const noexcept { return std::hash<evmc::bytes32>{}(hash); }
+        size_t operator()(const CodeKey& key) const noexcept { return (*this)(key.code_hash); }
+    };
+    struct CodeKeyEqual {
+        bool operator()(const CodeKey& a, const CodeKey& b) const noexcept {
+            return a.code_hash == b.code_hash && a.revision == b.revision;
+        }
+        bool operator()(const CodeKey& a, const evmc::bytes32& b) const noexcept { return a.code_hash == b; }
+    };
+
+    ClockCache<CodeKey, int, CodeKeyHash, CodeKeyEqual> cache(4);
+    const auto hash{0x5e09a8ef4d5cbeb8fbd2ef5caf9d2bd1c79c5bd0d3a85d0b2a1f0d4c55e0ee9d_bytes32};
+    cache.put(CodeKey{hash, 7}, 1);
+    REQUIRE(cache.get(hash));
+    CHECK(*cache.get(hash) == 1);
+    CHECK(cache.get(CodeKey{hash, 7}));
+    CHECK(cache.get(CodeKey{hash, 8}) == nullptr);
+}
+
+}  // namespace silkworm
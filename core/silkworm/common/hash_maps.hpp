@@ -76,6 +76,13 @@ using NodeHashMap = absl::node_hash_map<K, V>;
 
 #endif
 
+// Unlike clear(), which deallocates the backing array of a large Abseil table,
+// erasing all the elements keeps the capacity for later reuse.
+template <class Container>
+void erase_all(Container& c) noexcept {
+    c.erase(c.begin(), c.end());
+}
+
 }  // namespace silkworm
 
 #endif  // SILKWORM_COMMON_HASH_MAPS_HPP_
@@ -42,10 +42,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cstddef>
 #include <list>
 #include <unordered_map>
+#include <utility>
 
 namespace silkworm {
 
-template <typename key_t, typename value_t>
+template <typename key_t, typename value_t, typename hash_t = std::hash<key_t>>
 class lru_cache {
   public:
     typedef typename std::pair<key_t, value_t> key_value_pair_t;
@@ -53,9 +54,11 @@ class lru_cache {
 
     explicit lru_cache(size_t max_size) : _max_size(max_size) {}
 
-    void put(const key_t& key, const value_t& value) {
+    void put(const key_t& key, const value_t& value) { put(key, value_t(value)); }
+
+    void put(const key_t& key, value_t&& value) {
         auto it = _cache_items_map.find(key);
-        _cache_items_list.push_front(key_value_pair_t(key, value));
+        _cache_items_list.push_front(key_value_pair_t(key, std::move(value)));
         if (it != _cache_items_map.end()) {
             _cache_items_list.erase(it->second);
             _cache_items_map.erase(it);
@@ -89,7 +92,7 @@ class lru_cache {
 
   private:
     std::list<key_value_pair_t> _cache_items_list;
-    std::unordered_map<key_t, list_iterator_t> _cache_items_map;
+    std::unordered_map<key_t, list_iterator_t, hash_t> _cache_items_map;
     size_t _max_size;
 };
 
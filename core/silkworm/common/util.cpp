@@ -213,4 +213,19 @@ size_t prefix_length(ByteView a, ByteView b) {
     }
     return len;
 }
+
+void keccak256_many(const ByteView* inputs, size_t count, ethash::hash256* out) {
+    // Inputs are handed over to ethash in batches, sparing a heap allocation
+    static constexpr size_t kBatchSize{64};
+    const uint8_t* data[kBatchSize];
+    size_t sizes[kBatchSize];
+    for (size_t i{0}; i < count; i += kBatchSize) {
+        const size_t n{std::min(kBatchSize, count - i)};
+        for (size_t j{0}; j < n; ++j) {
+            data[j] = inputs[i + j].data();
+            sizes[j] = inputs[i + j].length();
+        }
+        ethash::keccak256_many(out + i, data, sizes, n);
+    }
+}
 }  // namespace silkworm
@@ -88,6 +88,11 @@ size_t prefix_length(ByteView a, ByteView b);
 
 inline ethash::hash256 keccak256(ByteView view) { return ethash::keccak256(view.data(), view.size()); }
 
+// out[i] = keccak256(inputs[i]) for i < count.
+// Several inputs are hashed at once on CPUs with SIMD support (see ethash::keccak256_many),
+// best results being achieved with inputs of similar sizes.
+void keccak256_many(const ByteView* inputs, size_t count, ethash::hash256* out);
+
 }  // namespace silkworm
 
 #endif  // SILKWORM_COMMON_UTIL_HPP_
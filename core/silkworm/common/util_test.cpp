@@ -123,4 +123,23 @@ TEST_CASE("parse_size") {
     CHECK(!parse_size("ABBA"));
 }
 
+TEST_CASE("keccak256_many") {
+    // Sizes around the 136 bytes Keccak-256 block, so that lanes run out of input at different blocks
+    std::vector<Bytes> data;
+    for (size_t size : {0, 1, 20, 32, 135, 136, 137, 200, 271, 272, 273, 500}) {
+        for (uint8_t i{0}; i < 17; ++i) {
+            data.emplace_back(size + i % 3, i);
+        }
+    }
+    std::vector<ByteView> inputs(data.begin(), data.end());
+
+    std::vector<ethash::hash256> hashes(inputs.size());
+    keccak256_many(inputs.data(), inputs.size(), hashes.data());
+    for (size_t i{0}; i < inputs.size(); ++i) {
+        CHECK(to_hex(full_view(hashes[i].bytes)) == to_hex(full_view(keccak256(inputs[i]).bytes)));
+    }
+
+    keccak256_many(nullptr, 0, nullptr);
+}
+
 }  // namespace silkworm
@@ -16,12 +16,30 @@
 
 #include "ecdsa.hpp"
 
+#include <cstring>
+
+#include <ethash/keccak.hpp>
 #include <secp256k1_recovery.h>
 
 #include <silkworm/common/util.hpp>
 
 namespace silkworm::ecdsa {
 
+// Contexts are safe to share among threads as long as they're only used for recovery
+static const secp256k1_context* context() {
+    static secp256k1_context* ctx{secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY)};
+    return ctx;
+}
+
+static bool recover_public_key(secp256k1_pubkey& pub_key, const uint8_t* message, const uint8_t* signature,
+                               bool odd_y_parity) {
+    secp256k1_ecdsa_recoverable_signature sig;
+    if (!secp256k1_ecdsa_recoverable_signature_parse_compact(context(), &sig, signature, odd_y_parity)) {
+        return false;
+    }
+    return secp256k1_ecdsa_recover(context(), &pub_key, &sig, message);
+}
+
 intx::uint256 y_parity_and_chain_id_to_v(bool odd, const std::optional<intx::uint256>& chain_id) {
     if (chain_id) {
         return *chain_id * 2 + 35 + odd;
@@ -63,26 +81,37 @@ bool is_valid_signature(const intx::uint256& r, const intx::uint256& s, bool hom
 }
 
 std::optional<Bytes> recover(ByteView message, ByteView signature, bool odd_y_parity) {
-    static secp256k1_context* context{secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY)};
-
     if (message.length() != 32 || signature.length() != 64) {
         return std::nullopt;
     }
 
-    secp256k1_ecdsa_recoverable_signature sig;
-    if (!secp256k1_ecdsa_recoverable_signature_parse_compact(context, &sig, &signature[0], odd_y_parity)) {
-        return std::nullopt;
-    }
-
     secp256k1_pubkey pub_key;
-    if (!secp256k1_ecdsa_recover(context, &pub_key, &sig, &message[0])) {
+    if (!recover_public_key(pub_key, &message[0], &signature[0], odd_y_parity)) {
         return std::nullopt;
     }
 
     size_t kOutLen{65};
     Bytes out(kOutLen, '\0');
-    secp256k1_ec_pubkey_serialize(context, &out[0], &kOutLen, &pub_key, SECP256K1_EC_UNCOMPRESSED);
+    secp256k1_ec_pubkey_serialize(context(), &out[0], &kOutLen, &pub_key, SECP256K1_EC_UNCOMPRESSED);
     return out;
 }
 
+std::optional<evmc::address> recover_address(const uint8_t (&message)[32], const uint8_t (&signature)[64],
+                                             bool odd_y_parity) {
+    secp256k1_pubkey pub_key;
+    if (!recover_public_key(pub_key, message, signature, odd_y_parity)) {
+        return std::nullopt;
+    }
+
+    uint8_t serialized[65];
+    size_t len{sizeof(serialized)};
+    secp256k1_ec_pubkey_serialize(context(), serialized, &len, &pub_key, SECP256K1_EC_UNCOMPRESSED);
+
+    // Skip the 0x04 prefix of uncompressed keys
+    const ethash::hash256 hash{ethash::keccak256(&serialized[1], len - 1)};
+    evmc::address address;
+    std::memcpy(address.bytes, &hash.bytes[sizeof(hash) - kAddressLength], kAddressLength);
+    return address;
+}
+
 }  // namespace silkworm::ecdsa
@@ -52,6 +52,11 @@ bool is_valid_signature(const intx::uint256& r, const intx::uint256& s, bool hom
 // Tries recover the public key used for message signing
 std::optional<Bytes> recover(ByteView message, ByteView signature, bool odd_y_parity);
 
+// Tries recover the address of the message signer (i.e. the tail of keccak256 of the public key).
+// Unlike recover, does not allocate: the public key is hashed right from a stack buffer.
+std::optional<evmc::address> recover_address(const uint8_t (&message)[32], const uint8_t (&signature)[64],
+                                             bool odd_y_parity);
+
 }  // namespace silkworm::ecdsa
 
 #endif  // SILKWORM_CRYPTO_ECDSA_HPP_
@@ -16,8 +16,12 @@
 
 #include "ecdsa.hpp"
 
+#include <cstring>
+
 #include <catch2/catch.hpp>
 
+#include <silkworm/common/util.hpp>
+
 namespace silkworm::ecdsa {
 
 TEST_CASE("EIP-155 v to y parity & chain id ") {
@@ -37,4 +41,33 @@ TEST_CASE("EIP-155 v to y parity & chain id ") {
     CHECK(y_parity_and_chain_id_to_v(true, 1) == 38);
 }
 
+TEST_CASE("Recover address") {
+    const Bytes message{*from_hex("18c547e4f7b0f325ad1e56f57e26c745b09a3e503d86e00e5255ff7f715d3d1c")};
+    const Bytes signature{
+        *from_hex("73b1693892219d736caba55bdb67216e485557ea6b6af75f37096c9aa6a5a75f"
+                  "eeb940b1d03b21e36b0e47e79769f095fe2ab855bd91e3a38756b7d75a9c4549")};
+
+    uint8_t message_bytes[32];
+    uint8_t signature_bytes[64];
+    std::memcpy(message_bytes, message.data(), sizeof(message_bytes));
+    std::memcpy(signature_bytes, signature.data(), sizeof(signature_bytes));
+
+    std::optional<evmc::address> address{recover_address(message_bytes, signature_bytes, /*odd_y_parity=*/true)};
+    CHECK(address == 0xa94f5374fce5edbc8e2a8697c15331677e6ebf0b_address);
+
+    // Same key as the allocating version
+    std::optional<Bytes> public_key{recover(message, signature, /*odd_y_parity=*/true)};
+    REQUIRE(public_key);
+    const ethash::hash256 hash{keccak256(public_key->substr(1))};
+    CHECK(full_view(address->bytes) == full_view(hash.bytes).substr(12));
+
+    // Wrong parity recovers some other key
+    address = recover_address(message_bytes, signature_bytes, /*odd_y_parity=*/false);
+    CHECK(address != 0xa94f5374fce5edbc8e2a8697c15331677e6ebf0b_address);
+
+    // Invalid signature
+    std::memset(signature_bytes, 0, sizeof(signature_bytes));
+    CHECK(!recover_address(message_bytes, signature_bytes, /*odd_y_parity=*/true));
+}
+
 }  // namespace silkworm::ecdsa
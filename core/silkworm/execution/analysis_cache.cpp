@@ -16,32 +16,55 @@
 
 #include "analysis_cache.hpp"
 
+#include <climits>
 #include <memory>
 #include <utility>
 
+#if !defined(__wasm__)
+#include <mutex>
+#endif
+
 #include <evmone/analysis.hpp>
 
 namespace silkworm {
 
+AnalysisCache::AnalysisCache(size_t maxSize) {
+    // Small caches are not split lest their capacity be fragmented
+    const size_t num_shards{maxSize >= kNumShards * kMinShardSize ? kNumShards : 1};
+    for (size_t i{0}; i < num_shards; ++i) {
+        shards_.push_back(std::make_unique<Shard>((maxSize + num_shards - 1) / num_shards));
+    }
+}
+
+AnalysisCache::Shard& AnalysisCache::shard(const Key& key) const noexcept {
+    if (shards_.size() == 1) {
+        return *shards_[0];
+    }
+    // Top bits of the hash select the shard: lower ones are used by the shard's own hash table.
+    // All the revisions of a code hash share the same shard.
+    static_assert(kNumShards == 16);
+    return *shards_[std::hash<evmc::bytes32>{}(key.code_hash) >> (sizeof(size_t) * CHAR_BIT - 4)];
+}
+
 std::shared_ptr<evmone::AdvancedCodeAnalysis> AnalysisCache::get(const evmc::bytes32& key,
                                                                  evmc_revision revision) noexcept {
-    if (revision_ == revision) {
-        const auto* ptr{cache_.get(key)};
-        return ptr ? *ptr : nullptr;
-    } else {
-        return nullptr;
-    }
+    const Key k{key, revision};
+    Shard& s{shard(k)};
+#if !defined(__wasm__)
+    std::shared_lock lock{s.mtx};
+#endif
+    const auto* ptr{s.cache.get(k)};
+    return ptr ? *ptr : nullptr;
 }
 
 void AnalysisCache::put(const evmc::bytes32& key, const std::shared_ptr<evmone::AdvancedCodeAnalysis>& analysis,
                         evmc_revision revision) noexcept {
-    if (revision_ != revision) {
-        // multiple revisions are not supported
-        cache_.clear();
-    }
-    revision_ = revision;
-
-    cache_.put(key, analysis);
+    const Key k{key, revision};
+    Shard& s{shard(k)};
+#if !defined(__wasm__)
+    std::lock_guard lock{s.mtx};
+#endif
+    s.cache.put(k, analysis);
 }
 
 }  // namespace silkworm
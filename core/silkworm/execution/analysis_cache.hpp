@@ -18,9 +18,14 @@
 #define SILKWORM_EXECUTION_ANALYSIS_CACHE_HPP_
 
 #include <memory>
+#include <vector>
+
+#if !defined(__wasm__)
+#include <shared_mutex>
+#endif
 
 #include <silkworm/common/base.hpp>
-#include <silkworm/common/lru_cache.hpp>
+#include <silkworm/common/clock_cache.hpp>
 
 namespace evmone {
 struct AdvancedCodeAnalysis;
@@ -30,14 +35,20 @@ namespace silkworm {
 
 /** @brief Cache of EVM analyses.
  *
- * Analyses performed for different EVM revisions do not coexist in the cache
- * and all other revisions are evicted on revision update.
+ * Entries are keyed by code hash & EVM revision, so analyses performed for different
+ * revisions coexist in the cache and a fork boundary does not flush it.
+ * Being independent of any state, a cache may be kept for the lifetime of the process.
+ *
+ * The cache is thread-safe. Entries are spread by code hash over kNumShards independently locked CLOCK shards
+ * (unless the cache is too small to be split); lookups, which vastly outnumber insertions, only take a shared lock.
  */
 class AnalysisCache {
   public:
     static constexpr size_t kDefaultMaxSize{5'000};
+    static constexpr size_t kNumShards{16};
+    static constexpr size_t kMinShardSize{64};
 
-    explicit AnalysisCache(size_t maxSize = kDefaultMaxSize) : cache_{maxSize} {}
+    explicit AnalysisCache(size_t maxSize = kDefaultMaxSize);
 
     AnalysisCache(const AnalysisCache&) = delete;
     AnalysisCache& operator=(const AnalysisCache&) = delete;
@@ -48,14 +59,40 @@ class AnalysisCache {
     std::shared_ptr<evmone::AdvancedCodeAnalysis> get(const evmc::bytes32& key, evmc_revision revision) noexcept;
 
     /** @brief Puts an EVM analysis into the cache.
-     * All cache entries for other EVM revisions are evicted.
+     * When the shard of the code hash is full, its CLOCK hand evicts the first entry not looked up
+     * since the hand last passed over it, whatever the revision: there's no per revision quota.
      */
     void put(const evmc::bytes32& key, const std::shared_ptr<evmone::AdvancedCodeAnalysis>& analysis,
              evmc_revision revision) noexcept;
 
   private:
-    lru_cache<evmc::bytes32, std::shared_ptr<evmone::AdvancedCodeAnalysis>> cache_;
-    evmc_revision revision_{EVMC_MAX_REVISION};
+    struct Key {
+        evmc::bytes32 code_hash;
+        evmc_revision revision;
+
+        friend bool operator==(const Key& a, const Key& b) {
+            return a.code_hash == b.code_hash && a.revision == b.revision;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const noexcept {
+            return std::hash<evmc::bytes32>{}(key.code_hash) ^ static_cast<size_t>(key.revision);
+        }
+    };
+
+    struct Shard {
+        explicit Shard(size_t max_size) : cache{max_size} {}
+
+#if !defined(__wasm__)
+        std::shared_mutex mtx;
+#endif
+        ClockCache<Key, std::shared_ptr<evmone::AdvancedCodeAnalysis>, KeyHash> cache;
+    };
+
+    Shard& shard(const Key& key) const noexcept;
+
+    std::vector<std::unique_ptr<Shard>> shards_;
 };
 
 }  // namespace silkworm
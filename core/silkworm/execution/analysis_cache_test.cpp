@@ -0,0 +1,86 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "analysis_cache.hpp"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <evmone/analysis.hpp>
+
+namespace silkworm {
+
+TEST_CASE("Analysis cache keeps revisions side by side") {
+    AnalysisCache cache{/*maxSize=*/16};
+
+    const auto code_hash{0x5e09a8ef4d5cbeb8fbd2ef5caf9d2bd1c79c5bd0d3a85d0b2a1f0d4c55e0ee9d_bytes32};
+    const auto istanbul_analysis{std::make_shared<evmone::AdvancedCodeAnalysis>()};
+    const auto berlin_analysis{std::make_shared<evmone::AdvancedCodeAnalysis>()};
+
+    CHECK(cache.get(code_hash, EVMC_ISTANBUL) == nullptr);
+    cache.put(code_hash, istanbul_analysis, EVMC_ISTANBUL);
+    CHECK(cache.get(code_hash, EVMC_ISTANBUL) == istanbul_analysis);
+    CHECK(cache.get(code_hash, EVMC_BERLIN) == nullptr);
+
+    // Putting an analysis for another revision doesn't evict the previous one
+    cache.put(code_hash, berlin_analysis, EVMC_BERLIN);
+    CHECK(cache.get(code_hash, EVMC_BERLIN) == berlin_analysis);
+    CHECK(cache.get(code_hash, EVMC_ISTANBUL) == istanbul_analysis);
+}
+
+TEST_CASE("Analysis cache shared by threads") {
+    static constexpr size_t kNumThreads{4};
+    static constexpr size_t kNumKeys{500};
+    AnalysisCache cache;
+    REQUIRE(kNumThreads * kNumKeys <= AnalysisCache::kDefaultMaxSize / 2);
+
+    const auto key_of{[](size_t thread, size_t i) {
+        evmc::bytes32 key;
+        const size_t n{thread * kNumKeys + i};
+        std::memcpy(key.bytes, &n, sizeof(n));
+        return key;
+    }};
+
+    std::vector<std::vector<std::shared_ptr<evmone::AdvancedCodeAnalysis>>> analyses(kNumThreads);
+    std::vector<std::thread> threads;
+    for (size_t t{0}; t < kNumThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t i{0}; i < kNumKeys; ++i) {
+                analyses[t].push_back(std::make_shared<evmone::AdvancedCodeAnalysis>());
+                cache.put(key_of(t, i), analyses[t].back(), EVMC_BERLIN);
+                cache.get(key_of((t + 1) % kNumThreads, i), EVMC_BERLIN);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    size_t hits{0};
+    for (size_t t{0}; t < kNumThreads; ++t) {
+        for (size_t i{0}; i < kNumKeys; ++i) {
+            const auto analysis{cache.get(key_of(t, i), EVMC_BERLIN)};
+            CHECK((!analysis || analysis == analyses[t][i]));
+            hits += analysis != nullptr;
+        }
+    }
+    // Shards might be unevenly filled, but not that much
+    CHECK(hits > kNumThreads * kNumKeys * 9 / 10);
+}
+
+}  // namespace silkworm
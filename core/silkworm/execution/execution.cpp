@@ -26,17 +26,29 @@ std::pair<std::vector<Receipt>, ValidationResult> execute_block(const Block& blo
                                                                 const ChainConfig& config,
                                                                 AnalysisCache* analysis_cache,
                                                                 ExecutionStatePool* state_pool,
-                                                                evmc_vm* exo_evm) noexcept {
+                                                                evmc_vm* exo_evm,
+                                                                SpeculationPool* speculation_pool) noexcept {
+    IntraBlockState state{buffer};
+    return execute_block(block, state, config, analysis_cache, state_pool, exo_evm, speculation_pool);
+}
+
+std::pair<std::vector<Receipt>, ValidationResult> execute_block(const Block& block, IntraBlockState& state,
+                                                                const ChainConfig& config,
+                                                                AnalysisCache* analysis_cache,
+                                                                ExecutionStatePool* state_pool,
+                                                                evmc_vm* exo_evm,
+                                                                SpeculationPool* speculation_pool) noexcept {
     const BlockHeader& header{block.header};
     const uint64_t block_num{header.number};
 
-    IntraBlockState state{buffer};
+    state.clear();
     ExecutionProcessor processor{block, state, config};
     processor.evm().analysis_cache = analysis_cache;
     processor.evm().state_pool = state_pool;
     processor.evm().exo_evm = exo_evm;
 
-    std::pair<std::vector<Receipt>, ValidationResult> res{processor.execute_block()};
+    std::pair<std::vector<Receipt>, ValidationResult> res{
+        speculation_pool ? processor.execute_block_in_parallel(*speculation_pool) : processor.execute_block()};
 
     const auto& receipts{res.first};
     auto& err{res.second};
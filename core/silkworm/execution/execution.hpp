@@ -22,8 +22,10 @@
 #include <silkworm/chain/config.hpp>
 #include <silkworm/chain/validity.hpp>
 #include <silkworm/execution/analysis_cache.hpp>
+#include <silkworm/execution/speculation_pool.hpp>
 #include <silkworm/execution/state_pool.hpp>
 #include <silkworm/state/buffer.hpp>
+#include <silkworm/state/intra_block_state.hpp>
 #include <silkworm/types/block.hpp>
 #include <silkworm/types/receipt.hpp>
 
@@ -38,12 +40,23 @@ namespace silkworm {
  * pre-Byzantium receipt root isn't validated either.
  *
  * For better performance use AnalysisCache & ExecutionStatePool.
+ * Transactions are speculatively executed in parallel if a SpeculationPool bound to buffer is provided
+ * (see ExecutionProcessor::execute_block_in_parallel).
  */
-[[nodiscard]] std::pair<std::vector<Receipt>, ValidationResult> execute_block(const Block& block, StateBuffer& buffer,
-                                                                              const ChainConfig& config,
-                                                                              AnalysisCache* analysis_cache = nullptr,
-                                                                              ExecutionStatePool* state_pool = nullptr,
-                                                                              evmc_vm* exo_evm = nullptr) noexcept;
+[[nodiscard]] std::pair<std::vector<Receipt>, ValidationResult> execute_block(
+    const Block& block, StateBuffer& buffer, const ChainConfig& config, AnalysisCache* analysis_cache = nullptr,
+    ExecutionStatePool* state_pool = nullptr, evmc_vm* exo_evm = nullptr,
+    SpeculationPool* speculation_pool = nullptr) noexcept;
+
+/** @brief Same as above, but on a long-lived IntraBlockState which is cleared first (see IntraBlockState::clear).
+ *
+ * Reusing the same IntraBlockState for subsequent blocks (on the same StateBuffer) spares
+ * the reallocation of its containers and the re-reading of hot contracts' code for every block.
+ */
+[[nodiscard]] std::pair<std::vector<Receipt>, ValidationResult> execute_block(
+    const Block& block, IntraBlockState& state, const ChainConfig& config, AnalysisCache* analysis_cache = nullptr,
+    ExecutionStatePool* state_pool = nullptr, evmc_vm* exo_evm = nullptr,
+    SpeculationPool* speculation_pool = nullptr) noexcept;
 
 }  // namespace silkworm
 
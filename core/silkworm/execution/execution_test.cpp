@@ -64,11 +64,20 @@ TEST_CASE("Execute two blocks") {
     sender_account.balance = kEther;
     buffer.update_account(sender, std::nullopt, sender_account);
 
+    IntraBlockState state{buffer};
+    bool reuse_state{false};
+    SECTION("Fresh state for every block") {}
+    SECTION("Reused state") { reuse_state = true; }
+
+    const auto execute{[&]() {
+        return reuse_state ? execute_block(block, state, kMainnetConfig) : execute_block(block, buffer, kMainnetConfig);
+    }};
+
     // ---------------------------------------
     // Execute first block
     // ---------------------------------------
 
-    CHECK(execute_block(block, buffer, kMainnetConfig).second == ValidationResult::kOk);
+    CHECK(execute().second == ValidationResult::kOk);
 
     auto contract_address{create_address(sender, /*nonce=*/0)};
     std::optional<Account> contract_account{buffer.read_account(contract_address)};
@@ -104,7 +113,7 @@ TEST_CASE("Execute two blocks") {
     block.transactions[0].to = contract_address;
     block.transactions[0].data = *from_hex(new_val);
 
-    CHECK(execute_block(block, buffer, kMainnetConfig).second == ValidationResult::kOk);
+    CHECK(execute().second == ValidationResult::kOk);
 
     storage0 = buffer.read_storage(contract_address, kDefaultIncarnation, storage_key0);
     CHECK(to_hex(storage0) == new_val);
@@ -16,14 +16,139 @@
 
 #include "processor.hpp"
 
+#include <algorithm>
+#include <memory>
+
 #include <silkworm/chain/dao.hpp>
 #include <silkworm/chain/intrinsic_gas.hpp>
 #include <silkworm/chain/protocol_param.hpp>
 
 #include "execution.hpp"
+#include "speculation_pool.hpp"
 
 namespace silkworm {
 
+#if !defined(__wasm__)
+
+namespace {
+
+    // Read-only view of the state at the beginning of the block for a speculatively executed transaction.
+    // Account & storage values served are recorded so that they can be checked before the transaction is committed.
+    // The underlying MemoryBuffer is read concurrently by all the speculating threads, which is safe as nothing
+    // is written to it meanwhile.
+    class RecordingBuffer : public StateBuffer {
+      public:
+        explicit RecordingBuffer(const MemoryBuffer& db) noexcept : db_{db} {}
+
+        std::optional<Account> read_account(const evmc::address& address) const noexcept override {
+            std::optional<Account> account{db_.read_account(address)};
+            accounts_.emplace(address, account);
+            return account;
+        }
+
+        Bytes read_code(const evmc::bytes32& code_hash) const noexcept override {
+            return db_.read_code(code_hash);
+        }
+
+        evmc::bytes32 read_storage(const evmc::address& address, uint64_t incarnation,
+                                   const evmc::bytes32& location) const noexcept override {
+            evmc::bytes32 value{db_.read_storage(address, incarnation, location)};
+            storage_[address].emplace(location, value);
+            return value;
+        }
+
+        uint64_t previous_incarnation(const evmc::address& address) const noexcept override {
+            return db_.previous_incarnation(address);
+        }
+
+        std::optional<BlockHeader> read_header(uint64_t block_number,
+                                               const evmc::bytes32& block_hash) const noexcept override {
+            return db_.read_header(block_number, block_hash);
+        }
+
+        std::optional<BlockBody> read_body(uint64_t block_number,
+                                           const evmc::bytes32& block_hash) const noexcept override {
+            return db_.read_body(block_number, block_hash);
+        }
+
+        std::optional<intx::uint256> total_difficulty(uint64_t block_number,
+                                                      const evmc::bytes32& block_hash) const noexcept override {
+            return db_.total_difficulty(block_number, block_hash);
+        }
+
+        evmc::bytes32 state_root_hash() const override {
+            return db_.state_root_hash();
+        }
+
+        uint64_t current_canonical_block() const override {
+            return db_.current_canonical_block();
+        }
+
+        std::optional<evmc::bytes32> canonical_hash(uint64_t block_number) const override {
+            return db_.canonical_hash(block_number);
+        }
+
+        // Speculative states are never written to the DB
+
+        void insert_block(const Block&, const evmc::bytes32&) override {}
+
+        void canonize_block(uint64_t, const evmc::bytes32&) override {}
+
+        void decanonize_block(uint64_t) override {}
+
+        void insert_receipts(uint64_t, const std::vector<Receipt>&) override {}
+
+        void begin_block(uint64_t) override {}
+
+        void update_account(const evmc::address&, std::optional<Account>, std::optional<Account>) override {}
+
+        void update_account_code(const evmc::address&, uint64_t, const evmc::bytes32&, ByteView) override {}
+
+        void update_storage(const evmc::address&, uint64_t, const evmc::bytes32&, const evmc::bytes32&,
+                            const evmc::bytes32&) override {}
+
+        void unwind_state_changes(uint64_t) override {}
+
+        // Whether all the values read so far are still current in the given state
+        bool is_current(const IntraBlockState& state) const noexcept {
+            for (const auto& [address, account] : accounts_) {
+                if (!state.is_current(address, account)) {
+                    return false;
+                }
+            }
+            for (const auto& [address, values] : storage_) {
+                for (const auto& [location, value] : values) {
+                    if (!state.is_current(address, location, value)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        bool has_read(const evmc::address& address) const noexcept { return accounts_.count(address) != 0; }
+
+      private:
+        const MemoryBuffer& db_;
+
+        mutable FlatHashMap<evmc::address, std::optional<Account>> accounts_;
+        mutable FlatHashMap<evmc::address, FlatHashMap<evmc::bytes32, evmc::bytes32>> storage_;
+    };
+
+    // Outcome of a transaction run against the state at the beginning of the block
+    struct Speculation {
+        explicit Speculation(const MemoryBuffer& db) noexcept : buffer{db} {}
+
+        RecordingBuffer buffer;
+        IntraBlockState state{buffer};
+        bool success{false};
+        uint64_t gas_used{0};
+    };
+
+}  // namespace
+
+#endif  // !defined(__wasm__)
+
 ExecutionProcessor::ExecutionProcessor(const Block& block, IntraBlockState& state, const ChainConfig& config)
     : evm_{block, state, config} {}
 
@@ -55,9 +180,8 @@ ValidationResult ExecutionProcessor::validate_transaction(const Transaction& txn
     return ValidationResult::kOk;
 }
 
-Receipt ExecutionProcessor::execute_transaction(const Transaction& txn) noexcept {
+CallResult ExecutionProcessor::run_transaction(const Transaction& txn) noexcept {
     IntraBlockState& state{evm_.state()};
-    evm_.state().clear_journal_and_substate();
 
     state.access_account(*txn.from);
     state.subtract_from_balance(*txn.from, txn.gas_limit * txn.gas_price);
@@ -79,29 +203,46 @@ Receipt ExecutionProcessor::execute_transaction(const Transaction& txn) noexcept
     const intx::uint128 g0{intrinsic_gas(txn, rev >= EVMC_HOMESTEAD, rev >= EVMC_ISTANBUL)};
     CallResult vm_res{evm_.execute(txn, txn.gas_limit - g0.lo)};
 
-    uint64_t gas_used{txn.gas_limit - refund_gas(txn, vm_res.gas_left)};
-
-    // award the miner
-    state.add_to_balance(evm_.block().header.beneficiary, gas_used * txn.gas_price);
+    vm_res.gas_left = refund_gas(txn, vm_res.gas_left);
+    return vm_res;
+}
 
+void ExecutionProcessor::finalize_transaction() noexcept {
     evm_.state().destruct_suicides();
-    if (rev >= EVMC_SPURIOUS_DRAGON) {
+    if (evm_.revision() >= EVMC_SPURIOUS_DRAGON) {
         evm_.state().destruct_touched_dead();
     }
 
     evm_.state().finalize_transaction();
+}
 
+Receipt ExecutionProcessor::make_receipt(const Transaction& txn, bool success, uint64_t gas_used,
+                                         const std::vector<Log>& logs) noexcept {
     cumulative_gas_used_ += gas_used;
 
     return {
-        txn.type,                         // type
-        vm_res.status == EVMC_SUCCESS,    // success
-        cumulative_gas_used_,             // cumulative_gas_used
-        logs_bloom(evm_.state().logs()),  // bloom
-        evm_.state().logs(),              // logs
+        txn.type,              // type
+        success,               // success
+        cumulative_gas_used_,  // cumulative_gas_used
+        logs_bloom(logs),      // bloom
+        logs,                  // logs
     };
 }
 
+Receipt ExecutionProcessor::execute_transaction(const Transaction& txn) noexcept {
+    evm_.state().clear_journal_and_substate();
+
+    const CallResult vm_res{run_transaction(txn)};
+    const uint64_t gas_used{txn.gas_limit - vm_res.gas_left};
+
+    // award the miner
+    evm_.state().add_to_balance(evm_.block().header.beneficiary, gas_used * txn.gas_price);
+
+    finalize_transaction();
+
+    return make_receipt(txn, vm_res.status == EVMC_SUCCESS, gas_used, evm_.state().logs());
+}
+
 uint64_t ExecutionProcessor::available_gas() const noexcept {
     return evm_.block().header.gas_limit - cumulative_gas_used_;
 }
@@ -143,6 +284,84 @@ std::pair<std::vector<Receipt>, ValidationResult> ExecutionProcessor::execute_bl
     return {receipts, ValidationResult::kOk};
 }
 
+std::pair<std::vector<Receipt>, ValidationResult> ExecutionProcessor::execute_block_in_parallel(
+    SpeculationPool& pool) noexcept {
+#if defined(__wasm__)
+    (void)pool;
+    return execute_block();
+#else
+    const Block& block{evm_.block()};
+    const std::vector<Transaction>& txns{block.transactions};
+    const StateBuffer& db{pool.db()};
+    if (pool.num_threads() < 2 || txns.size() < 2 || &db != &evm_.state().db()) {
+        return execute_block();
+    }
+
+    // 1) Run every transaction against the state at the beginning of the block
+    std::vector<std::unique_ptr<Speculation>> speculations(txns.size());
+    pool.run(txns.size(), [&](size_t i) {
+        const Transaction& txn{txns[i]};
+        auto spec{std::make_unique<Speculation>(pool.db())};
+
+        // AnalysisCache & ExecutionStatePool are thread-safe
+        ExecutionProcessor processor{block, spec->state, evm_.config()};
+        processor.evm().analysis_cache = evm_.analysis_cache;
+        processor.evm().state_pool = evm_.state_pool ? evm_.state_pool : &pool.state_pool();
+        processor.evm().exo_evm = evm_.exo_evm;
+        if (processor.validate_transaction(txn) != ValidationResult::kOk) {
+            return;  // it will be validated again on commit
+        }
+
+        const CallResult vm_res{processor.run_transaction(txn)};
+        processor.finalize_transaction();
+        spec->gas_used = txn.gas_limit - vm_res.gas_left;
+        spec->success = vm_res.status == EVMC_SUCCESS;
+        speculations[i] = std::move(spec);
+    });
+
+    // 2) Commit transactions in order
+    std::vector<Receipt> receipts{};
+    receipts.reserve(txns.size());
+
+    IntraBlockState& state{evm_.state()};
+    const evmc::address& beneficiary{block.header.beneficiary};
+    if (block.header.number == evm_.config().dao_block) {
+        dao::transfer_balances(state);
+    }
+
+    cumulative_gas_used_ = 0;
+    for (size_t i{0}; i < txns.size(); ++i) {
+        const Transaction& txn{txns[i]};
+        ValidationResult err{validate_transaction(txn)};
+        if (err != ValidationResult::kOk) {
+            return {receipts, err};
+        }
+
+        // Missing speculations (not run to completion) are executed now.
+        // Speculative runs don't award the miner, so those which have observed its account are discarded too
+        const std::unique_ptr<Speculation> spec{std::move(speculations[i])};
+        if (!spec || spec->buffer.has_read(beneficiary) || !spec->buffer.is_current(state)) {
+            receipts.push_back(execute_transaction(txn));
+            continue;
+        }
+
+        state.clear_journal_and_substate();
+        state.merge_transaction(spec->state);
+
+        // award the miner
+        state.add_to_balance(beneficiary, spec->gas_used * txn.gas_price);
+
+        finalize_transaction();
+
+        receipts.push_back(make_receipt(txn, spec->success, spec->gas_used, spec->state.logs()));
+    }
+
+    apply_rewards();
+
+    return {receipts, ValidationResult::kOk};
+#endif  // defined(__wasm__)
+}
+
 void ExecutionProcessor::apply_rewards() noexcept {
     const evmc_revision rev{evm_.revision()};
     intx::uint256 block_reward;
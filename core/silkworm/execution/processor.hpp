@@ -30,6 +30,8 @@
 
 namespace silkworm {
 
+class SpeculationPool;
+
 class ExecutionProcessor {
   public:
     ExecutionProcessor(const ExecutionProcessor&) = delete;
@@ -48,12 +50,37 @@ class ExecutionProcessor {
     /// Execute the block, but do not write to the DB yet
     [[nodiscard]] std::pair<std::vector<Receipt>, ValidationResult> execute_block() noexcept;
 
+    /** @brief Same as execute_block, but transactions are first speculatively executed in parallel.
+     *
+     * Each transaction is run by one of the threads of the pool against the state at the beginning of the block
+     * (i.e. the MemoryBuffer the pool is bound to), recording the values it reads. Transactions are then committed
+     * in order: a transaction whose read values have been changed by any preceding one is re-executed,
+     * as is any transaction the speculation of which didn't complete.
+     * Resulting receipts and state changes are the same as those of execute_block.
+     *
+     * Falls back to execute_block unless the pool is bound to the buffer of the IntraBlockState.
+     * AnalysisCache & ExecutionStatePool of the EVM are shared by all the threads.
+     */
+    [[nodiscard]] std::pair<std::vector<Receipt>, ValidationResult> execute_block_in_parallel(
+        SpeculationPool& pool) noexcept;
+
     uint64_t cumulative_gas_used() const noexcept { return cumulative_gas_used_; }
 
     EVM& evm() noexcept { return evm_; }
     const EVM& evm() const noexcept { return evm_; }
 
   private:
+    // Runs the transaction and refunds the sender, but neither awards the miner nor finalizes the transaction.
+    // Returned gas_left is after the refund.
+    CallResult run_transaction(const Transaction& txn) noexcept;
+
+    // Destructs the accounts as required at the end of a transaction
+    void finalize_transaction() noexcept;
+
+    // Accounts for the gas used by a transaction and returns its receipt
+    Receipt make_receipt(const Transaction& txn, bool success, uint64_t gas_used,
+                         const std::vector<Log>& logs) noexcept;
+
     uint64_t available_gas() const noexcept;
     uint64_t refund_gas(const Transaction& txn, uint64_t gas_left) noexcept;
 
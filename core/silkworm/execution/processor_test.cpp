@@ -20,10 +20,12 @@
 #include <evmc/evmc.hpp>
 
 #include <silkworm/chain/protocol_param.hpp>
+#include <silkworm/rlp/encode.hpp>
 #include <silkworm/state/memory_buffer.hpp>
 
 #include "address.hpp"
 #include "execution.hpp"
+#include "speculation_pool.hpp"
 
 namespace silkworm {
 
@@ -435,4 +437,106 @@ TEST_CASE("Empty suicide beneficiary") {
     CHECK(!db.read_account(suicide_beneficiary).has_value());
 }
 
+TEST_CASE("Parallel execution") {
+    uint64_t block_number{10'050'107};
+    Block block{};
+    block.header.number = block_number;
+    block.header.gas_limit = 10'000'000;
+    block.header.beneficiary = 0x5146556427ff689250ed1801a783d12138c3dd5e_address;
+
+    const std::vector<evmc::address> senders{
+        0x834e9b529ac9fa63b39a06f8d8c9b0d6791fa5df_address, 0xc789e5aba05051b1468ac980e30068e19fad8587_address,
+        0x4bf2054ffae7a454a35fd8cf4be21b23b1f25a6f_address, 0x5ed8cee6b63b1c6afce3ad7c92f4fd7e1b8fad9f_address,
+        0x004512399a230565b99be5c3b0030a56f3ace68c_address,
+    };
+    const evmc::address recipient{0x6d20c1c07e56b7098eb8c50ee03ba0f6f498a91d_address};
+
+    // Stores its input into the 0th storage : SSTORE(0, CALLDATALOAD(0))
+    const evmc::address contract{0x0c729be7c39543c3d549282a40395299d987cec2_address};
+    const Bytes contract_code{*from_hex("600035600055")};
+
+    const auto transaction{[](const evmc::address& from, uint64_t nonce, std::optional<evmc::address> to,
+                              intx::uint256 value, Bytes data) {
+        Transaction txn{
+            std::nullopt,  // type
+            nonce,         // nonce
+            20 * kGiga,    // gas_price
+            200'000,       // gas_limit
+            to,            // to
+            value,         // value
+            data,          // data
+        };
+        txn.from = from;
+        return txn;
+    }};
+
+    block.transactions = {
+        transaction(senders[0], 0, recipient, kGiga, {}),
+        transaction(senders[1], 0, 0xee098e6c2a43d9e2c04f08f0c3a87b0ba59079d5_address, kGiga, {}),
+        // Same sender : stale nonce & balance
+        transaction(senders[0], 1, recipient, kGiga, {}),
+        // Observes the miner's balance
+        transaction(senders[2], 0, block.header.beneficiary, kGiga, {}),
+        // Storage conflict
+        transaction(senders[3], 0, contract, 0, *from_hex("01")),
+        transaction(senders[4], 0, contract, 0, *from_hex("02")),
+        // Contract creation
+        transaction(senders[1], 1, std::nullopt, 0, *from_hex("602a60005560098060106000396000f36000358060005531")),
+    };
+
+    const auto init_state{[&](MemoryBuffer& db) {
+        IntraBlockState state{db};
+        for (const auto& sender : senders) {
+            state.add_to_balance(sender, kEther);
+        }
+        state.set_code(contract, contract_code);
+        state.write_to_db(block_number - 1);
+    }};
+
+    MemoryBuffer sequential_db;
+    init_state(sequential_db);
+    IntraBlockState sequential_state{sequential_db};
+    ExecutionProcessor sequential_processor{block, sequential_state, kMainnetConfig};
+    const auto sequential_res{sequential_processor.execute_block()};
+    REQUIRE(sequential_res.second == ValidationResult::kOk);
+    const std::vector<Receipt>& sequential_receipts{sequential_res.first};
+    sequential_state.write_to_db(block_number);
+
+    MemoryBuffer parallel_db;
+    init_state(parallel_db);
+
+    const auto check_parallel_execution{[&](SpeculationPool& pool) {
+        IntraBlockState parallel_state{parallel_db};
+        ExecutionProcessor parallel_processor{block, parallel_state, kMainnetConfig};
+        const auto [parallel_receipts, parallel_err]{parallel_processor.execute_block_in_parallel(pool)};
+        REQUIRE(parallel_err == ValidationResult::kOk);
+
+        REQUIRE(parallel_receipts.size() == sequential_receipts.size());
+        for (size_t i{0}; i < sequential_receipts.size(); ++i) {
+            Bytes sequential_rlp, parallel_rlp;
+            rlp::encode(sequential_rlp, sequential_receipts[i]);
+            rlp::encode(parallel_rlp, parallel_receipts[i]);
+            CHECK(to_hex(parallel_rlp) == to_hex(sequential_rlp));
+        }
+
+        parallel_state.write_to_db(block_number);
+        CHECK(parallel_db.read_storage(contract, 0, {}) == sequential_db.read_storage(contract, 0, {}));
+        CHECK(parallel_db.read_account(block.header.beneficiary) ==
+              sequential_db.read_account(block.header.beneficiary));
+        CHECK(to_hex(parallel_db.state_root_hash()) == to_hex(sequential_db.state_root_hash()));
+    }};
+
+    SECTION("Pool bound to the state") {
+        SpeculationPool pool{parallel_db, /*num_threads=*/4};
+        check_parallel_execution(pool);
+    }
+
+    SECTION("Pool bound to another state") {
+        // Falls back to sequential execution
+        MemoryBuffer other_db;
+        SpeculationPool pool{other_db, /*num_threads=*/4};
+        check_parallel_execution(pool);
+    }
+}
+
 }  // namespace silkworm
@@ -0,0 +1,118 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "speculation_pool.hpp"
+
+namespace silkworm {
+
+SpeculationPool::SpeculationPool(const MemoryBuffer& db, size_t num_threads) : db_{db} {
+#if defined(__wasm__)
+    (void)num_threads;
+#else
+    for (size_t i{1}; i < num_threads; ++i) {
+        workers_.emplace_back([this]() { work(); });
+    }
+#endif
+}
+
+SpeculationPool::~SpeculationPool() {
+#if !defined(__wasm__)
+    {
+        std::lock_guard lock{mtx_};
+        stopped_ = true;
+    }
+    work_available_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+#endif
+}
+
+size_t SpeculationPool::num_threads() const noexcept {
+#if defined(__wasm__)
+    return 1;
+#else
+    return workers_.size() + 1;
+#endif
+}
+
+void SpeculationPool::run(size_t num_tasks, const std::function<void(size_t)>& task) noexcept {
+#if defined(__wasm__)
+    for (size_t i{0}; i < num_tasks; ++i) {
+        task(i);
+    }
+#else
+    task_ = &task;
+    num_tasks_ = num_tasks;
+    next_task_.store(0, std::memory_order_relaxed);
+    busy_workers_.store(workers_.size(), std::memory_order_relaxed);
+    {
+        std::lock_guard lock{mtx_};
+        ++generation_;
+    }
+    work_available_.notify_all();
+
+    run_tasks();
+
+    {
+        std::unique_lock lock{mtx_};
+        work_done_.wait(lock, [this]() { return busy_workers_.load(std::memory_order_acquire) == 0; });
+    }
+    task_ = nullptr;
+#endif
+}
+
+#if !defined(__wasm__)
+
+void SpeculationPool::work() {
+    uint64_t generation{0};
+    while (true) {
+        {
+            std::unique_lock lock{mtx_};
+            work_available_.wait(lock, [&]() { return stopped_ || generation_ != generation; });
+            if (stopped_) {
+                return;
+            }
+            generation = generation_;
+        }
+
+        run_tasks();
+
+        if (busy_workers_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard lock{mtx_};
+            work_done_.notify_one();
+        }
+    }
+}
+
+void SpeculationPool::run_tasks() noexcept {
+    for (size_t i{next_task_.fetch_add(1, std::memory_order_relaxed)}; i < num_tasks_;
+         i = next_task_.fetch_add(1, std::memory_order_relaxed)) {
+#if defined(__cpp_exceptions)
+        try {
+            (*task_)(i);
+        } catch (...) {
+            // abandoned, see run
+        }
+#else
+        (*task_)(i);
+#endif
+    }
+}
+
+#endif  // !defined(__wasm__)
+
+}  // namespace silkworm
@@ -0,0 +1,92 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_EXECUTION_SPECULATION_POOL_HPP_
+#define SILKWORM_EXECUTION_SPECULATION_POOL_HPP_
+
+#include <functional>
+#include <vector>
+
+#if !defined(__wasm__)
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#include <silkworm/execution/state_pool.hpp>
+#include <silkworm/state/memory_buffer.hpp>
+
+namespace silkworm {
+
+/** @brief Threads speculatively executing the transactions of blocks on a given state
+ * (see ExecutionProcessor::execute_block_in_parallel).
+ *
+ * The pool is bound to a MemoryBuffer, the readers of which are safe to call from several threads at once
+ * as long as nothing is written meanwhile. Buffers backed by a DB transaction, which must only be used
+ * by the thread which has begun it, can't be bound.
+ *
+ * Threads are started by the constructor and kept alive across blocks.
+ * A pool must only be used by one thread at a time.
+ */
+class SpeculationPool {
+  public:
+    // num_threads is the overall number of speculating threads, the one calling run included
+    SpeculationPool(const MemoryBuffer& db, size_t num_threads);
+    ~SpeculationPool();
+
+    SpeculationPool(const SpeculationPool&) = delete;
+    SpeculationPool& operator=(const SpeculationPool&) = delete;
+
+    const MemoryBuffer& db() const noexcept { return db_; }
+
+    size_t num_threads() const noexcept;
+
+    // Execution states of the speculating threads, for EVMs without a pool of their own
+    ExecutionStatePool& state_pool() noexcept { return state_pool_; }
+
+    /** @brief Calls task(i) for every i in [0, num_tasks) from the pool's threads and the calling one.
+     *
+     * Returns once every call has returned. A call which throws is abandoned:
+     * it's up to the task to record its own completion.
+     */
+    void run(size_t num_tasks, const std::function<void(size_t)>& task) noexcept;
+
+  private:
+    const MemoryBuffer& db_;
+    ExecutionStatePool state_pool_;
+
+#if !defined(__wasm__)
+    void work();
+    void run_tasks() noexcept;
+
+    const std::function<void(size_t)>* task_{nullptr};
+    size_t num_tasks_{0};
+    std::atomic<size_t> next_task_{0};
+    std::atomic<size_t> busy_workers_{0};
+
+    std::mutex mtx_;
+    std::condition_variable work_available_;
+    std::condition_variable work_done_;
+    uint64_t generation_{0};  // incremented at each run, guarded by mtx_
+    bool stopped_{false};
+    std::vector<std::thread> workers_;
+#endif
+};
+
+}  // namespace silkworm
+
+#endif  // SILKWORM_EXECUTION_SPECULATION_POOL_HPP_
@@ -0,0 +1,42 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "speculation_pool.hpp"
+
+#include <atomic>
+
+#include <catch2/catch.hpp>
+
+namespace silkworm {
+
+TEST_CASE("Speculation pool") {
+    MemoryBuffer db;
+    SpeculationPool pool{db, /*num_threads=*/4};
+#if !defined(__wasm__)
+    CHECK(pool.num_threads() == 4);
+#endif
+
+    // Threads are reused across runs
+    for (size_t num_tasks : {0u, 1u, 3u, 100u, 1000u}) {
+        std::vector<std::atomic<int>> calls(num_tasks);
+        pool.run(num_tasks, [&](size_t i) { ++calls[i]; });
+        for (size_t i{0}; i < num_tasks; ++i) {
+            CHECK(calls[i] == 1);
+        }
+    }
+}
+
+}  // namespace silkworm
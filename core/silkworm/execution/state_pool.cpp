@@ -16,6 +16,7 @@
 
 #include "state_pool.hpp"
 
+#include <atomic>
 #include <utility>
 
 #pragma GCC diagnostic push
@@ -25,21 +26,49 @@
 
 namespace silkworm {
 
+namespace {
+
+    // Home sub-pool of the calling thread; threads are assigned sub-pools round-robin
+    size_t home_pool_index() noexcept {
+        static std::atomic<size_t> next_index{0};
+        thread_local const size_t index{next_index++ % ExecutionStatePool::kNumPools};
+        return index;
+    }
+
+}  // namespace
+
 ExecutionStatePool::ExecutionStatePool() {}
 
 ExecutionStatePool::~ExecutionStatePool() {}
 
-std::unique_ptr<evmone::AdvancedExecutionState> ExecutionStatePool::acquire() noexcept {
-    if (pool_.empty()) {
-        return std::make_unique<evmone::AdvancedExecutionState>();
+std::unique_ptr<evmone::AdvancedExecutionState> ExecutionStatePool::pop(Pool& pool) noexcept {
+#if !defined(__wasm__)
+    std::lock_guard lock{pool.mtx};
+#endif
+    if (pool.states.empty()) {
+        return nullptr;
     }
-    std::unique_ptr<evmone::AdvancedExecutionState> obj{pool_.top().release()};
-    pool_.pop();
+    std::unique_ptr<evmone::AdvancedExecutionState> obj{std::move(pool.states.back())};
+    pool.states.pop_back();
     return obj;
 }
 
+std::unique_ptr<evmone::AdvancedExecutionState> ExecutionStatePool::acquire() noexcept {
+    const size_t home{home_pool_index()};
+    for (size_t i{0}; i < kNumPools; ++i) {
+        if (auto obj{pop(pools_[(home + i) % kNumPools])}) {
+            return obj;
+        }
+    }
+    return std::make_unique<evmone::AdvancedExecutionState>();
+}
+
 void ExecutionStatePool::release(std::unique_ptr<evmone::AdvancedExecutionState> obj) noexcept {
-    pool_.push(std::move(obj));
+    Pool& pool{pools_[home_pool_index()]};
+#if !defined(__wasm__)
+    std::lock_guard lock{pool.mtx};
+#endif
+    pool.states.push_back(std::move(obj));
 }
 
 }  // namespace silkworm
@@ -17,8 +17,13 @@
 #ifndef SILKWORM_EXECUTION_STATE_POOL_HPP_
 #define SILKWORM_EXECUTION_STATE_POOL_HPP_
 
+#include <array>
 #include <memory>
-#include <stack>
+#include <vector>
+
+#if !defined(__wasm__)
+#include <mutex>
+#endif
 
 namespace evmone {
 struct AdvancedExecutionState;
@@ -26,9 +31,16 @@ struct AdvancedExecutionState;
 
 namespace silkworm {
 
-/// Object pool of EVM execution states.
+/** @brief Object pool of EVM execution states.
+ *
+ * The pool is thread-safe. It's made of kNumPools independently locked sub-pools: every thread has a home sub-pool,
+ * which it releases states to and acquires states from, and steals from the other sub-pools when its own is empty.
+ * Hence threads don't contend as long as there are no more of them than sub-pools.
+ */
 class ExecutionStatePool {
   public:
+    static constexpr size_t kNumPools{16};
+
     ExecutionStatePool();
     ~ExecutionStatePool();
 
@@ -40,7 +52,16 @@ class ExecutionStatePool {
     void release(std::unique_ptr<evmone::AdvancedExecutionState> obj) noexcept;
 
   private:
-    std::stack<std::unique_ptr<evmone::AdvancedExecutionState>> pool_;
+    struct Pool {
+#if !defined(__wasm__)
+        std::mutex mtx;
+#endif
+        std::vector<std::unique_ptr<evmone::AdvancedExecutionState>> states;
+    };
+
+    std::unique_ptr<evmone::AdvancedExecutionState> pop(Pool& pool) noexcept;
+
+    std::array<Pool, kNumPools> pools_;
 };
 
 }  // namespace silkworm
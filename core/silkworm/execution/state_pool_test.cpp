@@ -0,0 +1,56 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "state_pool.hpp"
+
+#include <set>
+#include <thread>
+
+#include <catch2/catch.hpp>
+#include <evmone/analysis.hpp>
+
+namespace silkworm {
+
+TEST_CASE("Execution state pool") {
+    ExecutionStatePool pool;
+
+    auto state{pool.acquire()};
+    REQUIRE(state);
+    const evmone::AdvancedExecutionState* ptr{state.get()};
+    pool.release(std::move(state));
+    CHECK(pool.acquire().get() == ptr);
+
+    // States released by other threads are stolen
+    std::set<const evmone::AdvancedExecutionState*> released;
+    for (int i{0}; i < 2; ++i) {
+        std::thread{[&]() {
+            auto obj{std::make_unique<evmone::AdvancedExecutionState>()};
+            released.insert(obj.get());
+            pool.release(std::move(obj));
+        }}.join();
+    }
+    std::set<const evmone::AdvancedExecutionState*> acquired;
+    std::thread{[&]() {
+        auto obj1{pool.acquire()};
+        auto obj2{pool.acquire()};
+        acquired = {obj1.get(), obj2.get()};
+        pool.release(std::move(obj1));
+        pool.release(std::move(obj2));
+    }}.join();
+    CHECK(acquired == released);
+}
+
+}  // namespace silkworm
@@ -22,44 +22,30 @@
 
 namespace silkworm::state {
 
-CreateDelta::CreateDelta(evmc::address address) noexcept : address_{std::move(address)} {}
+void CreateDelta::revert(IntraBlockState& state) const noexcept { state.objects_.erase(address); }
 
-void CreateDelta::revert(IntraBlockState& state) noexcept { state.objects_.erase(address_); }
+void UpdateDelta::revert(IntraBlockState& state) const noexcept { state.objects_[address].current = previous; }
 
-UpdateDelta::UpdateDelta(evmc::address address, state::Object previous) noexcept
-    : address_{std::move(address)}, previous_{std::move(previous)} {}
+void SuicideDelta::revert(IntraBlockState& state) const noexcept { state.self_destructs_.erase(address); }
 
-void UpdateDelta::revert(IntraBlockState& state) noexcept { state.objects_[address_] = previous_; }
+void TouchDelta::revert(IntraBlockState& state) const noexcept { state.touched_.erase(address); }
 
-SuicideDelta::SuicideDelta(evmc::address address) noexcept : address_{std::move(address)} {}
+void StorageChangeDelta::revert(IntraBlockState& state) const noexcept {
+    state.storage_[address].current[key] = previous;
+}
 
-void SuicideDelta::revert(IntraBlockState& state) noexcept { state.self_destructs_.erase(address_); }
+void StorageWipeDelta::revert(IntraBlockState& state) noexcept { state.storage_[address] = std::move(storage); }
 
-TouchDelta::TouchDelta(evmc::address address) noexcept : address_{std::move(address)} {}
+void StorageCreateDelta::revert(IntraBlockState& state) const noexcept { state.storage_.erase(address); }
 
-void TouchDelta::revert(IntraBlockState& state) noexcept { state.touched_.erase(address_); }
+void StorageAccessDelta::revert(IntraBlockState& state) const noexcept {
+    state.accessed_storage_keys_[address].erase(key);
+}
 
-StorageChangeDelta::StorageChangeDelta(evmc::address address, evmc::bytes32 key, evmc::bytes32 previous) noexcept
-    : address_{std::move(address)}, key_{std::move(key)}, previous_{std::move(previous)} {}
+void AccountAccessDelta::revert(IntraBlockState& state) const noexcept { state.accessed_addresses_.erase(address); }
 
-void StorageChangeDelta::revert(IntraBlockState& state) noexcept { state.storage_[address_].current[key_] = previous_; }
-
-StorageWipeDelta::StorageWipeDelta(evmc::address address, state::Storage storage) noexcept
-    : address_{std::move(address)}, storage_{std::move(storage)} {}
-
-void StorageWipeDelta::revert(IntraBlockState& state) noexcept { state.storage_[address_] = storage_; }
-
-StorageCreateDelta::StorageCreateDelta(evmc::address address) noexcept : address_{std::move(address)} {}
-
-void StorageCreateDelta::revert(IntraBlockState& state) noexcept { state.storage_.erase(address_); }
-
-StorageAccessDelta::StorageAccessDelta(evmc::address address, evmc::bytes32 key) noexcept
-    : address_{std::move(address)}, key_{std::move(key)} {}
-
-void StorageAccessDelta::revert(IntraBlockState& state) noexcept { state.accessed_storage_keys_[address_].erase(key_); }
-
-AccountAccessDelta::AccountAccessDelta(evmc::address address) noexcept : address_{std::move(address)} {}
-
-void AccountAccessDelta::revert(IntraBlockState& state) noexcept { state.accessed_addresses_.erase(address_); }
+void revert(Delta& delta, IntraBlockState& state) noexcept {
+    std::visit([&state](auto& d) { d.revert(state); }, delta);
+}
 
 }  // namespace silkworm::state
@@ -17,6 +17,9 @@
 #ifndef SILKWORM_STATE_DELTA_HPP_
 #define SILKWORM_STATE_DELTA_HPP_
 
+#include <optional>
+#include <variant>
+
 #include <silkworm/common/base.hpp>
 #include <silkworm/state/object.hpp>
 
@@ -26,124 +29,83 @@ class IntraBlockState;
 
 namespace state {
 
-    // Delta is a revertable change made to IntraBlockState.
-    class Delta {
-      public:
-        Delta(const Delta&) = delete;
-        Delta& operator=(const Delta&) = delete;
-
-        virtual ~Delta() = default;
-
-        virtual void revert(IntraBlockState& state) noexcept = 0;
-
-      protected:
-        Delta() = default;
-    };
+    // Deltas are revertable changes made to IntraBlockState.
+    // They are plain values held in a std::variant (see Delta below) rather than polymorphic objects,
+    // so that the journal is a flat vector which, once grown, records further changes without any allocation.
 
     // Account created.
-    class CreateDelta : public Delta {
-      public:
-        explicit CreateDelta(evmc::address address) noexcept;
-
-        void revert(IntraBlockState& state) noexcept override;
+    struct CreateDelta {
+        evmc::address address;
 
-      private:
-        evmc::address address_;
+        void revert(IntraBlockState& state) const noexcept;
     };
 
-    // Account updated.
-    class UpdateDelta : public Delta {
-      public:
-        UpdateDelta(evmc::address address, state::Object previous) noexcept;
+    // Account updated; initial values of accounts are never changed by a transaction, so only the current one is kept.
+    struct UpdateDelta {
+        evmc::address address;
+        std::optional<Account> previous;
 
-        void revert(IntraBlockState& state) noexcept override;
-
-      private:
-        evmc::address address_;
-        state::Object previous_;
+        void revert(IntraBlockState& state) const noexcept;
     };
 
     // Account recorded for self-destruction.
-    class SuicideDelta : public Delta {
-      public:
-        explicit SuicideDelta(evmc::address address) noexcept;
-
-        void revert(IntraBlockState& state) noexcept override;
+    struct SuicideDelta {
+        evmc::address address;
 
-      private:
-        evmc::address address_;
+        void revert(IntraBlockState& state) const noexcept;
     };
 
     // Account touched.
-    class TouchDelta : public Delta {
-      public:
-        explicit TouchDelta(evmc::address address) noexcept;
+    struct TouchDelta {
+        evmc::address address;
 
-        void revert(IntraBlockState& state) noexcept override;
-
-      private:
-        evmc::address address_;
+        void revert(IntraBlockState& state) const noexcept;
     };
 
     // Storage value changed.
-    class StorageChangeDelta : public Delta {
-      public:
-        StorageChangeDelta(evmc::address address, evmc::bytes32 key, evmc::bytes32 previous) noexcept;
-
-        void revert(IntraBlockState& state) noexcept override;
+    struct StorageChangeDelta {
+        evmc::address address;
+        evmc::bytes32 key;
+        evmc::bytes32 previous;
 
-      private:
-        evmc::address address_;
-        evmc::bytes32 key_;
-        evmc::bytes32 previous_;
+        void revert(IntraBlockState& state) const noexcept;
     };
 
-    // Entire storage deleted.
-    class StorageWipeDelta : public Delta {
-      public:
-        StorageWipeDelta(evmc::address address, state::Storage storage) noexcept;
+    // Entire storage deleted; the storage is moved (rather than copied) into the delta.
+    struct StorageWipeDelta {
+        evmc::address address;
+        state::Storage storage;
 
-        void revert(IntraBlockState& state) noexcept override;
-
-      private:
-        evmc::address address_;
-        state::Storage storage_;
+        void revert(IntraBlockState& state) noexcept;
     };
 
     // Storage created.
-    class StorageCreateDelta : public Delta {
-      public:
-        explicit StorageCreateDelta(evmc::address address) noexcept;
-
-        void revert(IntraBlockState& state) noexcept override;
+    struct StorageCreateDelta {
+        evmc::address address;
 
-      private:
-        evmc::address address_;
+        void revert(IntraBlockState& state) const noexcept;
     };
 
     // Storage accessed (see EIP-2929).
-    class StorageAccessDelta : public Delta {
-      public:
-        StorageAccessDelta(evmc::address address, evmc::bytes32 key) noexcept;
+    struct StorageAccessDelta {
+        evmc::address address;
+        evmc::bytes32 key;
 
-        void revert(IntraBlockState& state) noexcept override;
-
-      private:
-        evmc::address address_;
-        evmc::bytes32 key_;
+        void revert(IntraBlockState& state) const noexcept;
     };
 
     // Account accessed (see EIP-2929).
-    class AccountAccessDelta : public Delta {
-      public:
-        explicit AccountAccessDelta(evmc::address address) noexcept;
-
-        void revert(IntraBlockState& state) noexcept override;
+    struct AccountAccessDelta {
+        evmc::address address;
 
-      private:
-        evmc::address address_;
+        void revert(IntraBlockState& state) const noexcept;
     };
 
+    using Delta = std::variant<CreateDelta, UpdateDelta, SuicideDelta, TouchDelta, StorageChangeDelta,
+                               StorageWipeDelta, StorageCreateDelta, StorageAccessDelta, AccountAccessDelta>;
+
+    void revert(Delta& delta, IntraBlockState& state) noexcept;
+
 }  // namespace state
 }  // namespace silkworm
 
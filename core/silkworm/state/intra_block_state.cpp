@@ -46,11 +46,11 @@ state::Object& IntraBlockState::get_or_create_object(const evmc::address& addres
     auto* obj{get_object(address)};
 
     if (!obj) {
-        journal_.emplace_back(new state::CreateDelta{address});
+        journal_.emplace_back(state::CreateDelta{address});
         obj = &objects_[address];
         obj->current = Account{};
     } else if (!obj->current) {
-        journal_.emplace_back(new state::UpdateDelta{address, *obj});
+        journal_.emplace_back(state::UpdateDelta{address, obj->current});
         obj->current = Account{};
     }
 
@@ -84,9 +84,9 @@ void IntraBlockState::create_contract(const evmc::address& address) noexcept {
         } else if (prev->initial) {
             prev_incarnation = prev->initial->incarnation;
         }
-        journal_.emplace_back(new state::UpdateDelta{address, *prev});
+        journal_.emplace_back(state::UpdateDelta{address, prev->current});
     } else {
-        journal_.emplace_back(new state::CreateDelta{address});
+        journal_.emplace_back(state::CreateDelta{address});
     }
 
     if (!prev_incarnation || prev_incarnation == 0) {
@@ -99,10 +99,10 @@ void IntraBlockState::create_contract(const evmc::address& address) noexcept {
 
     auto it{storage_.find(address)};
     if (it == storage_.end()) {
-        journal_.emplace_back(new state::StorageCreateDelta{address});
+        journal_.emplace_back(state::StorageCreateDelta{address});
     } else {
-        journal_.emplace_back(new state::StorageWipeDelta{address, it->second});
-        storage_.erase(address);
+        journal_.emplace_back(state::StorageWipeDelta{address, std::move(it->second)});
+        storage_.erase(it);
     }
 }
 
@@ -112,14 +112,14 @@ void IntraBlockState::touch(const evmc::address& address) noexcept {
     // See Yellow Paper, Appendix K "Anomalies on the Main Network"
     static constexpr evmc::address kRipemdAddress{0x0000000000000000000000000000000000000003_address};
     if (inserted && address != kRipemdAddress) {
-        journal_.emplace_back(new state::TouchDelta{address});
+        journal_.emplace_back(state::TouchDelta{address});
     }
 }
 
 void IntraBlockState::record_suicide(const evmc::address& address) noexcept {
     bool inserted{self_destructs_.insert(address).second};
     if (inserted) {
-        journal_.emplace_back(new state::SuicideDelta{address});
+        journal_.emplace_back(state::SuicideDelta{address});
     }
 }
 
@@ -154,21 +154,21 @@ intx::uint256 IntraBlockState::get_balance(const evmc::address& address) const n
 
 void IntraBlockState::set_balance(const evmc::address& address, const intx::uint256& value) noexcept {
     auto& obj{get_or_create_object(address)};
-    journal_.emplace_back(new state::UpdateDelta{address, obj});
+    journal_.emplace_back(state::UpdateDelta{address, obj.current});
     obj.current->balance = value;
     touch(address);
 }
 
 void IntraBlockState::add_to_balance(const evmc::address& address, const intx::uint256& addend) noexcept {
     auto& obj{get_or_create_object(address)};
-    journal_.emplace_back(new state::UpdateDelta{address, obj});
+    journal_.emplace_back(state::UpdateDelta{address, obj.current});
     obj.current->balance += addend;
     touch(address);
 }
 
 void IntraBlockState::subtract_from_balance(const evmc::address& address, const intx::uint256& subtrahend) noexcept {
     auto& obj{get_or_create_object(address)};
-    journal_.emplace_back(new state::UpdateDelta{address, obj});
+    journal_.emplace_back(state::UpdateDelta{address, obj.current});
     obj.current->balance -= subtrahend;
     touch(address);
 }
@@ -180,7 +180,7 @@ uint64_t IntraBlockState::get_nonce(const evmc::address& address) const noexcept
 
 void IntraBlockState::set_nonce(const evmc::address& address, uint64_t nonce) noexcept {
     auto& obj{get_or_create_object(address)};
-    journal_.emplace_back(new state::UpdateDelta{address, obj});
+    journal_.emplace_back(state::UpdateDelta{address, obj.current});
     obj.current->nonce = nonce;
 }
 
@@ -211,7 +211,7 @@ evmc::bytes32 IntraBlockState::get_code_hash(const evmc::address& address) const
 
 void IntraBlockState::set_code(const evmc::address& address, Bytes code) noexcept {
     auto& obj{get_or_create_object(address)};
-    journal_.emplace_back(new state::UpdateDelta{address, obj});
+    journal_.emplace_back(state::UpdateDelta{address, obj.current});
     obj.current->code_hash = bit_cast<evmc_bytes32>(keccak256(code));
 
     // Don't overwrite already existing code so that views of it
@@ -222,7 +222,7 @@ void IntraBlockState::set_code(const evmc::address& address, Bytes code) noexcep
 evmc_access_status IntraBlockState::access_account(const evmc::address& address) noexcept {
     const bool cold_read{accessed_addresses_.insert(address).second};
     if (cold_read) {
-        journal_.emplace_back(new state::AccountAccessDelta{address});
+        journal_.emplace_back(state::AccountAccessDelta{address});
     }
     return cold_read ? EVMC_ACCESS_COLD : EVMC_ACCESS_WARM;
 }
@@ -230,7 +230,7 @@ evmc_access_status IntraBlockState::access_account(const evmc::address& address)
 evmc_access_status IntraBlockState::access_storage(const evmc::address& address, const evmc::bytes32& key) noexcept {
     const bool cold_read{accessed_storage_keys_[address].insert(key).second};
     if (cold_read) {
-        journal_.emplace_back(new state::StorageAccessDelta{address, key});
+        journal_.emplace_back(state::StorageAccessDelta{address, key});
     }
     return cold_read ? EVMC_ACCESS_COLD : EVMC_ACCESS_WARM;
 }
@@ -287,7 +287,7 @@ void IntraBlockState::set_storage(const evmc::address& address, const evmc::byte
         return;
     }
     storage_[address].current[key] = value;
-    journal_.emplace_back(new state::StorageChangeDelta{address, key, prev});
+    journal_.emplace_back(state::StorageChangeDelta{address, key, prev});
 }
 
 void IntraBlockState::write_to_db(uint64_t block_number) {
@@ -329,7 +329,7 @@ IntraBlockState::Snapshot IntraBlockState::take_snapshot() const noexcept {
 
 void IntraBlockState::revert_to_snapshot(const IntraBlockState::Snapshot& snapshot) noexcept {
     for (size_t i = journal_.size(); i > snapshot.journal_size_; --i) {
-        journal_[i - 1]->revert(*this);
+        state::revert(journal_[i - 1], *this);
     }
     journal_.resize(snapshot.journal_size_);
     logs_.resize(snapshot.log_size_);
@@ -350,13 +350,77 @@ void IntraBlockState::clear_journal_and_substate() {
     journal_.clear();
 
     // and the substate
-    self_destructs_.clear();
+    erase_all(self_destructs_);
     logs_.clear();
-    touched_.clear();
+    erase_all(touched_);
     refund_ = 0;
     // EIP-2929
-    accessed_addresses_.clear();
-    accessed_storage_keys_.clear();
+    erase_all(accessed_addresses_);
+    erase_all(accessed_storage_keys_);
+}
+
+void IntraBlockState::clear() noexcept {
+    erase_all(objects_);
+    erase_all(storage_);
+    if (code_.size() > kMaxRetainedCode) {
+        code_.clear();
+    }
+    clear_journal_and_substate();
+}
+
+bool IntraBlockState::is_current(const evmc::address& address, const std::optional<Account>& account) const noexcept {
+    auto it{objects_.find(address)};
+    return it == objects_.end() || it->second.current == account;
+}
+
+bool IntraBlockState::is_current(const evmc::address& address, const evmc::bytes32& key,
+                                 const evmc::bytes32& value) const noexcept {
+    auto it1{storage_.find(address)};
+    if (it1 == storage_.end()) {
+        return true;
+    }
+    const state::Storage& storage{it1->second};
+    if (auto it2{storage.current.find(key)}; it2 != storage.current.end()) {
+        return it2->second == value;
+    }
+    if (auto it2{storage.committed.find(key)}; it2 != storage.committed.end()) {
+        return it2->second.original == value;
+    }
+    return true;
+}
+
+void IntraBlockState::merge_transaction(const IntraBlockState& other) noexcept {
+    // Accounts re-created or destructed by the transaction have their storage entirely replaced
+    FlatHashSet<evmc::address> wiped;
+
+    for (const auto& [address, obj] : other.objects_) {
+        auto [it, inserted]{objects_.try_emplace(address, obj)};
+        if (!inserted) {
+            it->second.current = obj.current;
+        }
+        if (!obj.current || !obj.initial || obj.current->incarnation != obj.initial->incarnation) {
+            wiped.insert(address);
+            storage_.erase(address);
+        }
+    }
+
+    for (const auto& [address, storage] : other.storage_) {
+        if (wiped.count(address)) {
+            storage_[address] = storage;
+            continue;
+        }
+        state::Storage& target{storage_[address]};
+        for (const auto& [key, val] : storage.committed) {
+            auto [it, inserted]{target.committed.try_emplace(key, val)};
+            if (!inserted) {
+                it->second.original = val.original;
+            }
+        }
+    }
+
+    for (const auto& [code_hash, code] : other.code_) {
+        code_.try_emplace(code_hash, code);
+    }
 }
 
 void IntraBlockState::add_log(const Log& log) noexcept { logs_.push_back(log); }
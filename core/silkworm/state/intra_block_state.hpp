@@ -105,6 +105,15 @@ class IntraBlockState {
     // See Section 6.1 "Substate" of the Yellow Paper
     void clear_journal_and_substate();
 
+    /** Discards all the state so that this object can be reused for the next block
+     * while its containers keep their capacity.
+     * Contract code, being keyed by hash, is retained (up to kMaxRetainedCode entries).
+     */
+    void clear() noexcept;
+
+    // Retained code is dropped beyond that many entries
+    static constexpr size_t kMaxRetainedCode{4'096};
+
     void add_log(const Log& log) noexcept;
 
     const std::vector<Log>& logs() const noexcept { return logs_; }
@@ -114,16 +123,37 @@ class IntraBlockState {
 
     uint64_t get_refund() const noexcept { return refund_; }
 
+    /** @name Speculative execution
+     *  See ExecutionProcessor::execute_block_in_parallel
+     */
+    ///@{
+
+    /** Whether an account value read from db (by a transaction run on a separate state)
+     * is still the current one here, i.e. it has not been changed by any preceding transaction.
+     */
+    bool is_current(const evmc::address& address, const std::optional<Account>& account) const noexcept;
+
+    /// Same as above for a storage value; the account is expected to be current.
+    bool is_current(const evmc::address& address, const evmc::bytes32& key,
+                    const evmc::bytes32& value) const noexcept;
+
+    /** Applies the changes of a finalized transaction which has been run on a separate state
+     * on top of the same db. All the values it read from db must be current (see is_current).
+     */
+    void merge_transaction(const IntraBlockState& other) noexcept;
+
+    ///@}
+
   private:
-    friend class state::CreateDelta;
-    friend class state::UpdateDelta;
-    friend class state::SuicideDelta;
-    friend class state::TouchDelta;
-    friend class state::StorageChangeDelta;
-    friend class state::StorageWipeDelta;
-    friend class state::StorageCreateDelta;
-    friend class state::StorageAccessDelta;
-    friend class state::AccountAccessDelta;
+    friend struct state::CreateDelta;
+    friend struct state::UpdateDelta;
+    friend struct state::SuicideDelta;
+    friend struct state::TouchDelta;
+    friend struct state::StorageChangeDelta;
+    friend struct state::StorageWipeDelta;
+    friend struct state::StorageCreateDelta;
+    friend struct state::StorageAccessDelta;
+    friend struct state::AccountAccessDelta;
 
     evmc::bytes32 get_storage(const evmc::address& address, const evmc::bytes32& key, bool original) const noexcept;
 
@@ -135,10 +165,12 @@ class IntraBlockState {
     mutable FlatHashMap<evmc::address, state::Object> objects_;
     mutable FlatHashMap<evmc::address, state::Storage> storage_;
 
-    // we want pointer stability here, thus node map
+    // we want pointer stability here, thus node map;
+    // retained across blocks by clear()
     mutable NodeHashMap<evmc::bytes32, Bytes> code_;
 
-    std::vector<std::unique_ptr<state::Delta>> journal_;
+    // cleared but not deallocated between transactions
+    std::vector<state::Delta> journal_;
 
     // substate
     FlatHashSet<evmc::address> self_destructs_;
@@ -0,0 +1,75 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "intra_block_state.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <silkworm/state/memory_buffer.hpp>
+
+namespace silkworm {
+
+TEST_CASE("Revert to snapshot") {
+    MemoryBuffer db;
+    IntraBlockState state{db};
+
+    const evmc::address address{0xbe00000000000000000000000000000000000000_address};
+    const evmc::bytes32 key{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+    const evmc::bytes32 value1{0x0000000000000000000000000000000000000000000000000000000000000011_bytes32};
+    const evmc::bytes32 value2{0x0000000000000000000000000000000000000000000000000000000000000022_bytes32};
+
+    state.create_contract(address);
+    state.set_balance(address, 1000);
+    state.set_storage(address, key, value1);
+    state.access_account(address);
+
+    for (int i{0}; i < 2; ++i) {
+        const IntraBlockState::Snapshot snapshot{state.take_snapshot()};
+
+        state.set_nonce(address, 5);
+        state.set_storage(address, key, value2);
+        state.access_storage(address, key);
+        state.record_suicide(address);
+
+        // Re-creation wipes the storage
+        state.create_contract(address);
+        CHECK(state.get_current_storage(address, key) == evmc::bytes32{});
+        state.set_storage(address, key, value2);
+
+        state.revert_to_snapshot(snapshot);
+
+        CHECK(state.exists(address));
+        CHECK(state.get_nonce(address) == 0);
+        CHECK(state.get_balance(address) == 1000);
+        CHECK(state.get_current_storage(address, key) == value1);
+        CHECK(state.number_of_self_destructs() == 0);
+        CHECK(state.access_account(address) == EVMC_ACCESS_WARM);
+    }
+    CHECK(state.access_storage(address, key) == EVMC_ACCESS_COLD);
+
+    // The journal is reusable after it has been cleared
+    state.finalize_transaction();
+    state.clear_journal_and_substate();
+    const IntraBlockState::Snapshot snapshot{state.take_snapshot()};
+    state.add_to_balance(address, 1);
+    state.set_storage(address, key, value2);
+    state.revert_to_snapshot(snapshot);
+    CHECK(state.get_balance(address) == 1000);
+    CHECK(state.get_current_storage(address, key) == value1);
+    CHECK(state.get_original_storage(address, key) == value1);
+}
+
+}  // namespace silkworm
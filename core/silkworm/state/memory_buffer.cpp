@@ -240,13 +240,21 @@ evmc::bytes32 MemoryBuffer::account_storage_root(const evmc::address& address, u
         return kEmptyRoot;
     }
 
+    std::vector<ByteView> locations;
+    locations.reserve(storage.size());
+    for (const auto& entry : storage) {
+        locations.push_back(full_view(entry.first));
+    }
+    std::vector<ethash::hash256> hashes(locations.size());
+    keccak256_many(locations.data(), locations.size(), hashes.data());
+
     std::map<evmc::bytes32, Bytes> storage_rlp;
     Bytes rlp;
-    for (const auto& [location, value] : storage) {
-        ethash::hash256 hash{keccak256(full_view(location))};
+    size_t i{0};
+    for (const auto& entry : storage) {
         rlp.clear();
-        rlp::encode(rlp, zeroless_view(value));
-        storage_rlp[to_bytes32(full_view(hash.bytes))] = rlp;
+        rlp::encode(rlp, zeroless_view(entry.second));
+        storage_rlp[to_bytes32(full_view(hashes[i++].bytes))] = rlp;
     }
 
     trie::HashBuilder hb;
@@ -262,11 +270,19 @@ evmc::bytes32 MemoryBuffer::state_root_hash() const {
         return kEmptyRoot;
     }
 
+    std::vector<ByteView> addresses;
+    addresses.reserve(accounts_.size());
+    for (const auto& entry : accounts_) {
+        addresses.push_back(full_view(entry.first));
+    }
+    std::vector<ethash::hash256> hashes(addresses.size());
+    keccak256_many(addresses.data(), addresses.size(), hashes.data());
+
     std::map<evmc::bytes32, Bytes> account_rlp;
+    size_t i{0};
     for (const auto& [address, account] : accounts_) {
-        ethash::hash256 hash{keccak256(full_view(address))};
         evmc::bytes32 storage_root{account_storage_root(address, account.incarnation)};
-        account_rlp[to_bytes32(full_view(hash.bytes))] = account.rlp(storage_root);
+        account_rlp[to_bytes32(full_view(hashes[i++].bytes))] = account.rlp(storage_root);
     }
 
     trie::HashBuilder hb;
@@ -56,16 +56,21 @@ bool operator==(const Node& a, const Node& b) {
 }
 
 Bytes unpack_nibbles(ByteView packed) {
-    Bytes out(2 * packed.length(), '\0');
+    Bytes out;
+    unpack_nibbles(packed, out);
+    return out;
+}
+
+void unpack_nibbles(ByteView packed, Bytes& out) {
+    out.resize(2 * packed.length());
     for (size_t i{0}; i < packed.length(); ++i) {
         out[2 * i] = packed[i] >> 4;
         out[2 * i + 1] = packed[i] & 0xF;
     }
-    return out;
 }
 
-static Bytes encode_path(ByteView path, bool terminating) {
-    Bytes res(path.length() / 2 + 1, '\0');
+static void encode_path(ByteView path, bool terminating, Bytes& res) {
+    res.resize(path.length() / 2 + 1);
     bool odd{path.length() % 2 != 0};
 
     if (!terminating && !odd) {
@@ -88,66 +93,118 @@ static Bytes encode_path(ByteView path, bool terminating) {
             res[i] = (path[2 * i - 2] << 4) + path[2 * i - 1];
         }
     }
+}
 
+static NodeRef wrap_hash(const uint8_t (&hash)[kHashLength]) {
+    NodeRef wrapped;
+    wrapped.length = kHashLength + 1;
+    wrapped.bytes[0] = rlp::kEmptyStringCode + kHashLength;
+    std::memcpy(&wrapped.bytes[1], hash, kHashLength);
+    return wrapped;
+}
+
+// Copy of a node reference given as bytes
+static NodeRef to_node_ref(ByteView ref) {
+    assert(ref.length() <= kHashLength + 1);
+    NodeRef res;
+    res.length = static_cast<uint8_t>(ref.length());
+    std::memcpy(res.bytes, ref.data(), ref.length());
     return res;
 }
 
-static Bytes leaf_node_rlp(ByteView path, ByteView value) {
-    Bytes encoded_path{encode_path(path, /*terminating=*/true)};
-    Bytes rlp;
+static NodeRef node_ref(ByteView rlp) {
+    if (rlp.length() < kHashLength) {
+        return to_node_ref(rlp);
+    }
+    return wrap_hash(keccak256(rlp).bytes);
+}
+
+NodeRef HashBuilder::leaf_node_ref(ByteView path, ByteView value) {
+    encode_path(path, /*terminating=*/true, encoded_path_);
+    rlp_.clear();
     rlp::Header h;
     h.list = true;
-    h.payload_length = rlp::length(encoded_path) + rlp::length(value);
-    rlp::encode_header(rlp, h);
-    rlp::encode(rlp, encoded_path);
-    rlp::encode(rlp, value);
-    return rlp;
+    h.payload_length = rlp::length(encoded_path_) + rlp::length(value);
+    rlp::encode_header(rlp_, h);
+    rlp::encode(rlp_, encoded_path_);
+    rlp::encode(rlp_, value);
+    return node_ref(rlp_);
 }
 
-static Bytes extension_node_rlp(ByteView path, ByteView child_ref) {
-    Bytes encoded_path{encode_path(path, /*terminating=*/false)};
-    Bytes rlp;
+NodeRef HashBuilder::extension_node_ref(ByteView path, ByteView child_ref) {
+    encode_path(path, /*terminating=*/false, encoded_path_);
+    rlp_.clear();
     rlp::Header h;
     h.list = true;
-    h.payload_length = rlp::length(encoded_path) + child_ref.length();
-    rlp::encode_header(rlp, h);
-    rlp::encode(rlp, encoded_path);
-    rlp.append(child_ref);
-    return rlp;
+    h.payload_length = rlp::length(encoded_path_) + child_ref.length();
+    rlp::encode_header(rlp_, h);
+    rlp::encode(rlp_, encoded_path_);
+    rlp_.append(child_ref);
+    return node_ref(rlp_);
 }
 
-static Bytes node_ref(ByteView rlp) {
-    if (rlp.length() < kHashLength) {
-        return Bytes{rlp};
+void HashBuilder::add(ByteView packed, ByteView value) {
+    unpack_nibbles(packed, succ_);
+    assert(succ_ > key_);
+    if (!key_.empty()) {
+        gen_struct_step(key_, succ_);
+    }
+    key_.swap(succ_);
+    if (Bytes* leaf_value{std::get_if<Bytes>(&value_)}) {
+        leaf_value->assign(value);
+    } else {
+        value_ = Bytes{value};
     }
-
-    Bytes rlp_wrapped_hash(kHashLength + 1, '\0');
-    rlp_wrapped_hash[0] = rlp::kEmptyStringCode + kHashLength;
-    const ethash::hash256 hash{keccak256(rlp)};
-    std::memcpy(&rlp_wrapped_hash[1], hash.bytes, kHashLength);
-    return rlp_wrapped_hash;
 }
 
-void HashBuilder::add(ByteView packed, ByteView value) {
-    Bytes key{unpack_nibbles(packed)};
-    assert(key > key_);
+void HashBuilder::add_branch_node(ByteView unpacked_key, const evmc::bytes32& hash, bool is_in_db_trie) {
+    assert(unpacked_key > key_ || (key_.empty() && unpacked_key.empty()));
     if (!key_.empty()) {
-        gen_struct_step(key_, key, value_);
+        gen_struct_step(key_, unpacked_key);
+    } else if (unpacked_key.empty()) {
+        // known root hash
+        stack_.push_back(wrap_hash(hash.bytes));
     }
-    key_ = key;
-    value_ = value;
+    key_ = unpacked_key;
+    value_ = hash;
+    is_in_db_trie_ = is_in_db_trie;
 }
 
 void HashBuilder::finalize() {
     if (!key_.empty()) {
-        gen_struct_step(key_, {}, value_);
+        gen_struct_step(key_, {});
         key_.clear();
-        value_.clear();
+        value_ = Bytes{};
     }
 }
 
 evmc::bytes32 HashBuilder::root_hash() { return root_hash(/*auto_finalize=*/true); }
 
+Bytes HashBuilder::finalize_as_root_child() {
+    assert(!key_.empty());
+    // Any key diverging at the first nibble closes all the branches below the root, but not the root itself
+    const uint8_t sibling{static_cast<uint8_t>(key_[0] ^ 1)};
+    gen_struct_step(key_, ByteView{&sibling, 1});
+    key_.clear();
+    value_ = Bytes{};
+    assert(stack_.size() == 1);
+    return Bytes{stack_.back().view()};
+}
+
+evmc::bytes32 HashBuilder::root_hash_of_branch(const std::array<Bytes, 16>& children) {
+    HashBuilder hb;
+    uint16_t state_mask{0};
+    for (size_t i{0}; i < children.size(); ++i) {
+        if (!children[i].empty()) {
+            hb.stack_.push_back(to_node_ref(children[i]));
+            state_mask |= 1u << i;
+        }
+    }
+    assert(hb.stack_.size() >= 2);
+    hb.branch_ref(state_mask, /*hash_mask=*/0);
+    return hb.root_hash(/*auto_finalize=*/false);
+}
+
 evmc::bytes32 HashBuilder::root_hash(bool auto_finalize) {
     if (auto_finalize) {
         finalize();
@@ -157,7 +214,7 @@ evmc::bytes32 HashBuilder::root_hash(bool auto_finalize) {
         return kEmptyRoot;
     }
 
-    const Bytes& node_ref{stack_.back()};
+    const ByteView node_ref{stack_.back().view()};
     evmc::bytes32 res{};
     if (node_ref.length() == kHashLength + 1) {
         std::memcpy(res.bytes, &node_ref[1], kHashLength);
@@ -168,7 +225,7 @@ evmc::bytes32 HashBuilder::root_hash(bool auto_finalize) {
 }
 
 // https://github.com/ledgerwatch/turbo-geth/blob/master/docs/programmers_guide/guide.md#generating-the-structural-information-from-the-sequence-of-keys
-void HashBuilder::gen_struct_step(ByteView curr, const ByteView succ, const ByteView value) {
+void HashBuilder::gen_struct_step(ByteView curr, const ByteView succ) {
     for (bool build_extensions{false};; build_extensions = true) {
         const bool prec_exists{!groups_.empty()};
         const size_t prec_len{groups_.empty() ? 0 : groups_.size() - 1};
@@ -196,10 +253,38 @@ void HashBuilder::gen_struct_step(ByteView curr, const ByteView succ, const Byte
 
         const ByteView short_node_key{curr.substr(remainder_start)};
         if (!build_extensions) {
-            stack_.push_back(node_ref(leaf_node_rlp(short_node_key, value)));
-        } else if (!short_node_key.empty()) {
-            // TODO[Issue 179] propagate tree_masks_ rootwards along extension nodes
-            stack_.back() = node_ref(extension_node_rlp(short_node_key, stack_.back()));
+            if (const Bytes* leaf_value{std::get_if<Bytes>(&value_)}) {
+                stack_.push_back(leaf_node_ref(short_node_key, *leaf_value));
+            } else {
+                // Hash of a branch node the sub-trie of which has not been walked through
+                stack_.push_back(wrap_hash(std::get<evmc::bytes32>(value_).bytes));
+                if (node_collector) {
+                    if (is_in_db_trie_) {
+                        tree_masks_[curr.length() - 1] |= 1u << curr.back();  // keep track of existing DB trie nodes
+                    }
+                    hash_masks_[curr.length() - 1] |= 1u << curr.back();  // register myself in parent's bitmaps
+                }
+                build_extensions = true;
+            }
+        }
+
+        if (build_extensions && !short_node_key.empty()) {  // extension node
+            if (node_collector && remainder_start > 0) {
+                const uint16_t flag = 1u << curr[remainder_start - 1];
+
+                // DB trie can't use hash of an extension node
+                hash_masks_[remainder_start - 1] &= ~flag;
+
+                if (tree_masks_[curr.length() - 1]) {
+                    // Propagate tree_masks bit along the extension node
+                    tree_masks_[remainder_start - 1] |= flag;
+                }
+            }
+
+            stack_.back() = extension_node_ref(short_node_key, stack_.back().view());
+
+            tree_masks_.resize(remainder_start);
+            hash_masks_.resize(remainder_start);
         }
 
         // Check for the optional part
@@ -209,11 +294,12 @@ void HashBuilder::gen_struct_step(ByteView curr, const ByteView succ, const Byte
 
         // Close the immediately encompassing prefix group, if needed
         if (!succ.empty() || prec_exists) {  // branch node
-            std::vector<Bytes> child_hashes{branch_ref(groups_[len], hash_masks_[len])};
+            branch_ref(groups_[len], hash_masks_[len]);
 
             // See db/silkworm/trie/db_trie.hpp
             if (node_collector) {
-                if (len > 0) {
+                // A branch node shorter than a hash is embedded into its parent instead
+                if (len > 0 && stack_.back().length == kHashLength + 1) {
                     hash_masks_[len - 1] |= 1u << curr[len - 1];
                 }
 
@@ -223,12 +309,7 @@ void HashBuilder::gen_struct_step(ByteView curr, const ByteView succ, const Byte
                         tree_masks_[len - 1] |= 1u << curr[len - 1];  // register myself in parent bitmap
                     }
 
-                    std::vector<evmc::bytes32> hashes(child_hashes.size());
-                    for (size_t i{0}; i < child_hashes.size(); ++i) {
-                        assert(child_hashes[i].size() == kHashLength + 1);
-                        std::memcpy(hashes[i].bytes, &child_hashes[i][1], kHashLength);
-                    }
-                    Node n{groups_[len], tree_masks_[len], hash_masks_[len], hashes};
+                    Node n{groups_[len], tree_masks_[len], hash_masks_[len], child_hashes_};
                     if (len == 0) {
                         n.set_root_hash(root_hash(/*auto_finalize=*/false));
                     }
@@ -255,11 +336,9 @@ void HashBuilder::gen_struct_step(ByteView curr, const ByteView succ, const Byte
     }
 }
 
-// Takes children from the stack and replaces them with branch node ref.
-std::vector<Bytes> HashBuilder::branch_ref(uint16_t state_mask, uint16_t hash_mask) {
+void HashBuilder::branch_ref(uint16_t state_mask, uint16_t hash_mask) {
     assert_subset(hash_mask, state_mask);
-    std::vector<Bytes> child_hashes;
-    child_hashes.reserve(std::bitset<16>(hash_mask).count());
+    child_hashes_.clear();
 
     const size_t first_child_idx{stack_.size() - std::bitset<16>(state_mask).count()};
 
@@ -269,33 +348,32 @@ std::vector<Bytes> HashBuilder::branch_ref(uint16_t state_mask, uint16_t hash_ma
 
     for (size_t i{first_child_idx}, digit{0}; digit < 16; ++digit) {
         if (state_mask & (1u << digit)) {
-            h.payload_length += stack_[i++].length();
+            h.payload_length += stack_[i++].length;
         } else {
             h.payload_length += 1;
         }
     }
 
-    Bytes rlp{};
-    rlp::encode_header(rlp, h);
+    rlp_.clear();
+    rlp::encode_header(rlp_, h);
 
     for (size_t i{first_child_idx}, digit{0}; digit < 16; ++digit) {
         if (state_mask & (1u << digit)) {
             if (hash_mask & (1u << digit)) {
-                child_hashes.push_back(stack_[i]);
+                assert(stack_[i].length == kHashLength + 1);
+                std::memcpy(child_hashes_.emplace_back().bytes, &stack_[i].bytes[1], kHashLength);
             }
-            rlp.append(stack_[i++]);
+            rlp_.append(stack_[i++].view());
         } else {
-            rlp.push_back(rlp::kEmptyStringCode);
+            rlp_.push_back(rlp::kEmptyStringCode);
         }
     }
 
     // branch nodes with values are not supported
-    rlp.push_back(rlp::kEmptyStringCode);
+    rlp_.push_back(rlp::kEmptyStringCode);
 
     stack_.resize(first_child_idx + 1);
-    stack_.back() = node_ref(rlp);
-
-    return child_hashes;
+    stack_.back() = node_ref(rlp_);
 }
 
 }  // namespace silkworm::trie
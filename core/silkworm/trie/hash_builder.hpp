@@ -17,8 +17,10 @@
 #ifndef SILKWORM_TRIE_HASH_BUILDER_HPP_
 #define SILKWORM_TRIE_HASH_BUILDER_HPP_
 
+#include <array>
 #include <functional>
 #include <optional>
+#include <variant>
 #include <vector>
 
 #include <silkworm/common/base.hpp>
@@ -62,6 +64,15 @@ bool operator==(const Node& a, const Node& b);
 // TG HashCollector2
 using NodeCollector = std::function<void(ByteView unpacked_key, const Node&)>;
 
+// Node reference: RLP of the node if shorter than 32 bytes, RLP of its hash otherwise.
+// Either way it's at most 33 bytes long and is kept inline, without heap allocation.
+struct NodeRef {
+    uint8_t length{0};
+    uint8_t bytes[kHashLength + 1];
+
+    ByteView view() const { return {bytes, length}; }
+};
+
 // Calculates root hash of a Modified Merkle Patricia Trie.
 // See Appendix D "Modified Merkle Patricia Trie" of the Yellow Paper
 // and https://eth.wiki/fundamentals/patricia-tree
@@ -78,33 +89,65 @@ class HashBuilder {
     // (e.g. keys "ab" & "ab05" are mutually exclusive).
     void add(ByteView key, ByteView value);
 
+    // Adds the hash of a whole sub-trie (i.e. a branch node), the leaves of which are then not to be added.
+    // Unlike add, unpacked_key is unpacked (one nibble per byte); it's the path of the branch node
+    // and an empty one stands for the already known root hash of the entire trie.
+    // is_in_db_trie tells whether the branch node itself is stored in the DB trie (see db_trie.hpp).
+    // Same ordering rules of add apply.
+    void add_branch_node(ByteView unpacked_key, const evmc::bytes32& hash, bool is_in_db_trie);
+
     // May only be called after all entries have been added.
     evmc::bytes32 root_hash();
 
+    // Finalizes the entries added so far, all of which must share the same first nibble, as the sub-trie of
+    // a child of the root branch node and returns the child's node reference (see root_hash_of_branch).
+    // Nodes are collected as if entries of other children had been added too, except for the root itself.
+    Bytes finalize_as_root_child();
+
+    // Root hash of a trie the root of which is a branch node with the given children node references;
+    // empty references stand for missing children. There must be at least two children.
+    static evmc::bytes32 root_hash_of_branch(const std::array<Bytes, 16>& children);
+
     NodeCollector node_collector{nullptr};
 
   private:
     // See TG GenStructStep
-    void gen_struct_step(ByteView curr, ByteView succ, ByteView value);
+    void gen_struct_step(ByteView curr, ByteView succ);
+
+    NodeRef leaf_node_ref(ByteView path, ByteView value);
+
+    NodeRef extension_node_ref(ByteView path, ByteView child_ref);
 
-    std::vector<Bytes> branch_ref(uint16_t state_mask, uint16_t hash_mask);
+    // Takes children from the stack and replaces them with branch node ref.
+    // Hashes of the children in hash_mask are left in child_hashes_.
+    void branch_ref(uint16_t state_mask, uint16_t hash_mask);
 
     void finalize();
 
     evmc::bytes32 root_hash(bool auto_finalize);
 
-    Bytes key_;  // unpacked – one nibble per byte
-    Bytes value_;
+    Bytes key_;                                // unpacked – one nibble per byte
+    std::variant<Bytes, evmc::bytes32> value_;  // leaf value or branch node hash
+    bool is_in_db_trie_{false};
 
     std::vector<uint16_t> groups_;
     std::vector<uint16_t> tree_masks_;
     std::vector<uint16_t> hash_masks_;
-    std::vector<Bytes> stack_;  // node references: hashes or embedded RLPs
+    std::vector<NodeRef> stack_;
+
+    // Scratch buffers, reused across entries so that their allocations are amortized
+    Bytes succ_;
+    Bytes encoded_path_;
+    Bytes rlp_;
+    std::vector<evmc::bytes32> child_hashes_;
 };
 
 // TG DecompressNibbles
 Bytes unpack_nibbles(ByteView packed);
 
+// Same as above, reusing the out buffer
+void unpack_nibbles(ByteView packed, Bytes& out);
+
 }  // namespace silkworm::trie
 
 #endif  // SILKWORM_TRIE_HASH_BUILDER_HPP_
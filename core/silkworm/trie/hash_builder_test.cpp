@@ -17,16 +17,97 @@
 #include "hash_builder.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cstring>
 #include <iterator>
+#include <utility>
+#include <vector>
 
 #include <catch2/catch.hpp>
 #include <ethash/keccak.hpp>
 
+#include <silkworm/common/cast.hpp>
 #include <silkworm/common/util.hpp>
 #include <silkworm/rlp/encode.hpp>
 
 namespace silkworm::trie {
 
+namespace {
+
+    // Straightforward recursive computation of trie nodes, a reference for HashBuilder
+
+    Bytes hex_prefix(ByteView nibbles, bool leaf) {
+        const bool odd{nibbles.length() % 2 != 0};
+        Bytes out(nibbles.length() / 2 + 1, '\0');
+        out[0] = static_cast<uint8_t>(((leaf ? 2 : 0) + (odd ? 1 : 0)) << 4);
+        size_t i{0};
+        if (odd) {
+            out[0] |= nibbles[0];
+            i = 1;
+        }
+        for (size_t j{1}; i < nibbles.length(); i += 2, ++j) {
+            out[j] = static_cast<uint8_t>(nibbles[i] << 4 | nibbles[i + 1]);
+        }
+        return out;
+    }
+
+    Bytes wrap_into_list(const Bytes& payload) {
+        Bytes out;
+        rlp::encode_header(out, rlp::Header{/*list=*/true, payload.length()});
+        out.append(payload);
+        return out;
+    }
+
+    // What the parent of a node embeds: either the node itself or its hash
+    Bytes node_ref(const Bytes& node_rlp) {
+        if (node_rlp.length() < kHashLength) {
+            return node_rlp;
+        }
+        const ethash::hash256 hash{keccak256(node_rlp)};
+        Bytes out;
+        rlp::encode(out, hash.bytes);
+        return out;
+    }
+
+    using Entries = std::vector<std::pair<Bytes, Bytes>>;  // unpacked keys of the same length & values
+
+    // RLP of the node of sorted entries [first, last) with keys sharing their first depth nibbles
+    Bytes node_rlp(Entries::const_iterator first, Entries::const_iterator last, size_t depth) {
+        const ByteView first_key{first->first};
+        Bytes payload;
+        if (std::next(first) == last) {
+            rlp::encode(payload, hex_prefix(first_key.substr(depth), /*leaf=*/true));
+            rlp::encode(payload, ByteView{first->second});
+            return wrap_into_list(payload);
+        }
+
+        // As entries are sorted, the prefix shared by the first and last keys is shared by all of them
+        const ByteView last_key{std::prev(last)->first};
+        size_t prefix_end{depth};
+        while (first_key[prefix_end] == last_key[prefix_end]) {
+            ++prefix_end;
+        }
+        if (prefix_end > depth) {
+            rlp::encode(payload, hex_prefix(first_key.substr(depth, prefix_end - depth), /*leaf=*/false));
+            payload.append(node_ref(node_rlp(first, last, prefix_end)));
+            return wrap_into_list(payload);
+        }
+
+        for (uint8_t nibble{0}; nibble < 16; ++nibble) {
+            auto child_last{std::find_if(first, last, [&](const auto& e) { return e.first[depth] != nibble; })};
+            if (child_last == first) {
+                payload.push_back(rlp::kEmptyStringCode);
+            } else {
+                payload.append(node_ref(node_rlp(first, child_last, depth + 1)));
+                first = child_last;
+            }
+        }
+        payload.push_back(rlp::kEmptyStringCode);  // no value as all keys have the same length
+        return wrap_into_list(payload);
+    }
+
+}  // namespace
+
 TEST_CASE("Empty trie") {
     HashBuilder hb;
     CHECK(to_hex(hb.root_hash()) == to_hex(full_view(kEmptyRoot)));
@@ -129,4 +210,89 @@ TEST_CASE("HashBuilder2") {
     CHECK(to_hex(hb1.root_hash()) == to_hex(full_view(hash1.bytes)));
 }
 
+TEST_CASE("Root of branch from sub-tries") {
+    // keys & values in the increasing order of keys
+    std::vector<std::pair<evmc::bytes32, Bytes>> entries;
+    for (uint8_t i{0}; i < 100; ++i) {
+        const ethash::hash256 key{keccak256(Bytes{i})};
+        entries.emplace_back(bit_cast<evmc_bytes32>(key), Bytes(1 + i % 40, i));
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<std::pair<Bytes, Node>> nodes;
+    HashBuilder hb;
+    hb.node_collector = [&](ByteView key, const Node& node) { nodes.emplace_back(key, node); };
+    for (const auto& [key, value] : entries) {
+        hb.add(full_view(key), value);
+    }
+    const evmc::bytes32 root{hb.root_hash()};
+
+    std::array<Bytes, 16> children;
+    std::vector<std::pair<Bytes, Node>> sub_trie_nodes;
+    for (uint8_t nibble{0}; nibble < 16; ++nibble) {
+        HashBuilder sub_hb;
+        sub_hb.node_collector = [&](ByteView key, const Node& node) { sub_trie_nodes.emplace_back(key, node); };
+        bool empty{true};
+        for (const auto& [key, value] : entries) {
+            if (key.bytes[0] >> 4 == nibble) {
+                sub_hb.add(full_view(key), value);
+                empty = false;
+            }
+        }
+        if (!empty) {
+            children[nibble] = sub_hb.finalize_as_root_child();
+        }
+    }
+    CHECK(HashBuilder::root_hash_of_branch(children) == root);
+
+    // The same nodes but the root
+    nodes.erase(std::remove_if(nodes.begin(), nodes.end(), [](const auto& n) { return n.first.empty(); }),
+                nodes.end());
+    CHECK(!nodes.empty());
+    CHECK(sub_trie_nodes == nodes);
+}
+
+TEST_CASE("HashBuilder against a reference trie") {
+    // Keys sharing leading bytes with many others so that the trie has extensions of every length,
+    // plus keys differing only in their last nibble. Values of various lengths make leaves
+    // both embedded into and hashed out of their parents.
+    std::vector<std::pair<evmc::bytes32, Bytes>> entries;
+    for (uint32_t i{0}; i < 20'000; ++i) {
+        const ethash::hash256 hash{keccak256(Bytes{static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i)})};
+        evmc::bytes32 key{bit_cast<evmc_bytes32>(hash)};
+        std::memset(key.bytes, static_cast<int>(i / kHashLength % 3), i % kHashLength);
+        entries.emplace_back(key, Bytes(1 + i % 50, static_cast<uint8_t>(i)));
+        if (i % 7 == 0) {
+            key.bytes[kHashLength - 1] ^= 0x01;
+            entries.emplace_back(key, Bytes(1 + i % 3, static_cast<uint8_t>(i)));
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    entries.erase(std::unique(entries.begin(), entries.end(),
+                              [](const auto& a, const auto& b) { return a.first == b.first; }),
+                  entries.end());
+
+    Entries reference_entries;
+    for (const auto& [key, value] : entries) {
+        reference_entries.emplace_back(unpack_nibbles(full_view(key)), value);
+    }
+    const ethash::hash256 reference_root{
+        keccak256(node_rlp(reference_entries.cbegin(), reference_entries.cend(), /*depth=*/0))};
+
+    HashBuilder hb;
+    for (const auto& [key, value] : entries) {
+        hb.add(full_view(key), value);
+    }
+    CHECK(to_hex(hb.root_hash()) == to_hex(full_view(reference_root.bytes)));
+
+    size_t num_nodes{0};
+    HashBuilder collecting_hb;
+    collecting_hb.node_collector = [&](ByteView, const Node&) { ++num_nodes; };
+    for (const auto& [key, value] : entries) {
+        collecting_hb.add(full_view(key), value);
+    }
+    CHECK(to_hex(collecting_hb.root_hash()) == to_hex(full_view(reference_root.bytes)));
+    CHECK(num_nodes > 0);
+}
+
 }  // namespace silkworm::trie
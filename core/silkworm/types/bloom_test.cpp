@@ -45,4 +45,26 @@ TEST_CASE("Hardcoded Bloom") {
           "000000000000000000000000000000000000000000000000000000000000100000100000000000000000000000"
           "00000000001400000000000000008000000000000000000000000000000000");
 }
+
+TEST_CASE("Bloom of many logs") {
+    // 6 logs with 2 topics each make a full group of 16 inputs and a remainder of 2,
+    // whereas a single log makes a group of 3 inputs only
+    std::vector<Log> logs(6);
+    for (size_t i{0}; i < logs.size(); ++i) {
+        logs[i].address.bytes[0] = static_cast<uint8_t>(i);
+        logs[i].topics.resize(2);
+        logs[i].topics[0].bytes[0] = static_cast<uint8_t>(i);
+        logs[i].topics[1].bytes[1] = static_cast<uint8_t>(i);
+    }
+
+    Bloom expected{};
+    for (const Log& log : logs) {
+        const Bloom bloom{logs_bloom({log})};
+        for (size_t i{0}; i < kBloomByteLength; ++i) {
+            expected[i] |= bloom[i];
+        }
+    }
+    CHECK(logs_bloom(logs) == expected);
+    CHECK(logs_bloom({}) == Bloom{});
+}
 }  // namespace silkworm
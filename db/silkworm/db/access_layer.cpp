@@ -26,6 +26,19 @@
 
 namespace silkworm::db {
 
+std::optional<evmc::bytes32> read_canonical_hash(lmdb::Transaction& txn, uint64_t block_number) {
+    auto table{txn.open(table::kCanonicalHashes)};
+    std::optional<ByteView> hash{table->get(block_key(block_number))};
+    if (!hash) {
+        return std::nullopt;
+    }
+
+    assert(hash->size() == kHashLength);
+    evmc::bytes32 out;
+    std::memcpy(out.bytes, hash->data(), kHashLength);
+    return out;
+}
+
 std::optional<BlockHeader> read_header(lmdb::Transaction& txn, uint64_t block_number,
                                        const uint8_t (&hash)[kHashLength]) {
     auto table{txn.open(table::kHeaders)};
@@ -69,6 +69,9 @@ constexpr const char* kStorageModeReceipts{"smReceipts"};
 // See TG GetStorageModeFromDB
 bool read_storage_mode_receipts(lmdb::Transaction& txn);
 
+// See TG ReadCanonicalHash
+std::optional<evmc::bytes32> read_canonical_hash(lmdb::Transaction& txn, uint64_t block_number);
+
 std::optional<BlockHeader> read_header(lmdb::Transaction& txn, uint64_t block_number,
                                        const uint8_t (&hash)[kHashLength]);
 
@@ -25,6 +25,7 @@
 #include <silkworm/common/temp_dir.hpp>
 #include <silkworm/db/buffer.hpp>
 
+#include "prefetcher.hpp"
 #include "stages.hpp"
 #include "tables.hpp"
 
@@ -137,12 +138,17 @@ namespace db {
         ethash::hash256 hash{keccak256(rlp)};
 
         CHECK(!read_header(*txn, header.number, hash.bytes));
+        CHECK(!read_canonical_hash(*txn, block_num));
 
         // Write canonical header hash + header rlp
         auto canonical_hashes_table{txn->open(table::kCanonicalHashes)};
         auto k{block_key(block_num)};
         canonical_hashes_table->put(k, Bytes(hash.bytes, kHashLength));
 
+        std::optional<evmc::bytes32> canonical_hash{read_canonical_hash(*txn, block_num)};
+        REQUIRE(canonical_hash);
+        CHECK(full_view(*canonical_hash) == full_view(hash.bytes));
+
         auto header_table{txn->open(table::kHeaders)};
         Bytes key{block_key(header.number, hash.bytes)};
         header_table->put(key, rlp);
@@ -207,6 +213,19 @@ namespace db {
 
             CHECK(bh->block.transactions[0].from == 0x5a0b54d5dc17e0aadc383d2db43b0a0d3e029c4c_address);
             CHECK(bh->block.transactions[1].from == 0x941591b6ca8e8dd05c69efdec02b77c72dac1496_address);
+
+            // Prefetcher only sees committed data
+            lmdb::err_handler(txn->commit());
+            txn = env->begin_rw_transaction();
+            BlockPrefetcher prefetcher{*txn, block_num, block_num + 1, /*depth=*/2};
+            std::optional<BlockWithHash> prefetched{prefetcher.next()};
+            REQUIRE(prefetched);
+            CHECK(prefetched->block.header == header);
+            CHECK(prefetched->block.ommers == body.ommers);
+            CHECK(prefetched->block.transactions == bh->block.transactions);
+            CHECK(full_view(prefetched->hash) == full_view(hash.bytes));
+            CHECK(!prefetcher.next());  // next block is not there
+            CHECK(!prefetcher.next());
         }
     }
 
@@ -348,6 +367,90 @@ namespace db {
         CHECK(db_changes == expected_changes3);
     }
 
+    TEST_CASE("Buffer writes of change sets, receipts & logs") {
+        TemporaryDirectory tmp_dir;
+
+        lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 * kMebi};
+        db_config.set_readonly(false);
+        auto env{lmdb::get_env(db_config)};
+        auto txn{env->begin_rw_transaction()};
+        table::create_all(*txn);
+
+        const auto addr1{0xaa00000000000000000000000000000000000000_address};
+        const auto addr2{0xbb00000000000000000000000000000000000000_address};
+        const auto location1{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+        const auto location2{0x0000000000000000000000000000000000000000000000000000000000000002_bytes32};
+        const auto value{0x00000000000000000000000000000000000000000000000000000000000000ff_bytes32};
+        Account account;
+        account.incarnation = 1;
+        std::vector<Receipt> receipts(1);
+        receipts[0].logs.push_back(Log{addr1, {}, {}});
+
+        auto write_batch{[&](std::vector<uint64_t> block_numbers) {
+            Buffer buffer{txn.get()};
+            for (uint64_t block_number : block_numbers) {
+                buffer.begin_block(block_number);
+                buffer.update_storage(addr1, 1, location1, {}, value);
+                buffer.update_storage(addr1, 1, location2, {}, value);
+                buffer.update_account(addr1, std::nullopt, account);
+                buffer.update_account(addr2, std::nullopt, account);
+                buffer.insert_receipts(block_number, receipts);
+            }
+            buffer.write_to_db();
+        }};
+
+        // Appended to empty tables
+        write_batch({3, 5});
+        // Falls back to plain puts as block 4 goes before block 5
+        write_batch({4});
+        // Appended again
+        write_batch({6, 7});
+
+        auto receipt_table{txn->open(table::kBlockReceipts)};
+        auto log_table{txn->open(table::kLogs)};
+        for (uint64_t block_number{3}; block_number <= 7; ++block_number) {
+            AccountChanges account_changes{read_account_changes(*txn, block_number)};
+            CHECK(account_changes.size() == 2);
+            CHECK(account_changes.contains(addr2));
+            StorageChanges storage_changes{read_storage_changes(*txn, block_number)};
+            CHECK(storage_changes[addr1][1].size() == 2);
+            CHECK(receipt_table->get(block_key(block_number)));
+            CHECK(log_table->get(log_key(block_number, 0)));
+        }
+        CHECK(read_account_changes(*txn, 2).empty());
+        CHECK(read_account_changes(*txn, 8).empty());
+    }
+
+    TEST_CASE("Buffer batch size") {
+        TemporaryDirectory tmp_dir;
+
+        lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 * kMebi};
+        db_config.set_readonly(false);
+        auto env{lmdb::get_env(db_config)};
+        auto txn{env->begin_rw_transaction()};
+        table::create_all(*txn);
+
+        Buffer buffer{txn.get()};
+        buffer.begin_block(1);
+        CHECK(buffer.current_batch_size() == 0);
+
+        // Every new account adds the same amount, hash map rehashes notwithstanding
+        Account account;
+        std::optional<size_t> step;
+        for (uint8_t i{0}; i < 200; ++i) {
+            evmc::address address;
+            address.bytes[0] = i;
+            const size_t size_before{buffer.current_batch_size()};
+            buffer.update_account(address, std::nullopt, account);
+            const size_t size_after{buffer.current_batch_size()};
+            REQUIRE(size_after > size_before);
+            if (!step) {
+                step = size_after - size_before;
+            }
+            CHECK(size_after - size_before == *step);
+        }
+    }
+
     TEST_CASE("genesis config") {
         std::string source_genesis(genesis_mainnet_data(), sizeof_genesis_mainnet_data());
 
@@ -420,7 +523,7 @@ namespace db {
             state_buffer.update_account(account_address, std::nullopt, account);
         }
 
-        auto applied_allocations{static_cast<size_t>(state_buffer.account_changes().at(0).size())};
+        auto applied_allocations{static_cast<size_t>(state_buffer.account_changes(0).size())};
         CHECK(applied_allocations == expected_allocations);
 
         SECTION("state_root") {
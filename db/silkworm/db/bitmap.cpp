@@ -16,7 +16,10 @@
 
 #include "bitmap.hpp"
 
+#include <boost/endian/conversion.hpp>
+
 #include <silkworm/common/cast.hpp>
+#include <silkworm/common/util.hpp>
 
 namespace silkworm::db::bitmap {
 
@@ -44,13 +47,13 @@ roaring::Roaring64Map cut_left(roaring::Roaring64Map &bm, uint64_t size_limit) {
     auto from{bm.minimum()};
     auto min_max{bm.maximum() - bm.minimum()};
 
-    // We look for the cutting point
-    uint64_t i = min_max;
-    uint64_t j = 0;
+    // We look for the cutting point, i.e. the smallest i such that [from, from + i] doesn't fit
+    uint64_t i = 0;
+    uint64_t j = min_max;
     while (i < j) {
         uint64_t h = (i + j) >> 1;
         roaring::Roaring64Map current_bitmap(
-            roaring::api::roaring_bitmap_from_range(from, from + i + 1, 1));  // With range
+            roaring::api::roaring_bitmap_from_range(from, from + h + 1, 1));  // With range
         current_bitmap &= bm;
         current_bitmap.runOptimize();
         if (current_bitmap.getSizeInBytes() <= size_limit) {
@@ -62,9 +65,7 @@ roaring::Roaring64Map cut_left(roaring::Roaring64Map &bm, uint64_t size_limit) {
     roaring::Roaring64Map res(roaring::api::roaring_bitmap_from_range(from, from + i, 1));
     res &= bm;
     res.runOptimize();
-    for (uint64_t k = from; k <= from + i; k++) {
-        bm.remove(k);
-    }
+    bm -= res;
     return res;
 }
 
@@ -79,12 +80,12 @@ roaring::Roaring cut_left(roaring::Roaring &bm, uint64_t size_limit) {
     auto from{bm.minimum()};
     auto min_max{bm.maximum() - bm.minimum()};
 
-    // We look for the cutting point
-    uint64_t i = min_max;
-    uint64_t j = 0;
+    // We look for the cutting point, i.e. the smallest i such that [from, from + i] doesn't fit
+    uint64_t i = 0;
+    uint64_t j = min_max;
     while (i < j) {
         uint64_t h = (i + j) >> 1;
-        roaring::Roaring current_bitmap(roaring::api::roaring_bitmap_from_range(from, from + i + 1, 1));  // With range
+        roaring::Roaring current_bitmap(roaring::api::roaring_bitmap_from_range(from, from + h + 1, 1));  // With range
         current_bitmap &= bm;
         current_bitmap.runOptimize();
         if (current_bitmap.getSizeInBytes() <= size_limit) {
@@ -96,8 +97,128 @@ roaring::Roaring cut_left(roaring::Roaring &bm, uint64_t size_limit) {
     roaring::Roaring res(roaring::api::roaring_bitmap_from_range(from, from + i, 1));
     res &= bm;
     res.runOptimize();
-    roaring::api::roaring_bitmap_remove_range_closed(&bm.roaring, from, from + i);
+    bm -= res;
     return res;
 }
 
+namespace {
+
+    template <typename Bitmap>
+    struct ChunkTraits;
+
+    template <>
+    struct ChunkTraits<roaring::Roaring64Map> {
+        static constexpr uint64_t kMaxSuffix{UINT64_MAX};
+        static constexpr size_t kSuffixLength{sizeof(uint64_t)};
+        static void store_suffix(uint8_t *dst, uint64_t suffix) { boost::endian::store_big_u64(dst, suffix); }
+        static uint64_t load_suffix(const uint8_t *src) { return boost::endian::load_big_u64(src); }
+    };
+
+    template <>
+    struct ChunkTraits<roaring::Roaring> {
+        static constexpr uint64_t kMaxSuffix{UINT32_MAX};
+        static constexpr size_t kSuffixLength{sizeof(uint32_t)};
+        static void store_suffix(uint8_t *dst, uint64_t suffix) {
+            boost::endian::store_big_u32(dst, static_cast<uint32_t>(suffix));
+        }
+        static uint64_t load_suffix(const uint8_t *src) { return boost::endian::load_big_u32(src); }
+    };
+
+    template <typename Bitmap>
+    Bytes chunk_key(ByteView key, uint64_t suffix) {
+        Bytes out(key);
+        out.resize(key.length() + ChunkTraits<Bitmap>::kSuffixLength);
+        ChunkTraits<Bitmap>::store_suffix(&out[key.length()], suffix);
+        return out;
+    }
+
+    template <typename Bitmap>
+    bool is_chunk_key(ByteView key, ByteView candidate) {
+        return candidate.length() == key.length() + ChunkTraits<Bitmap>::kSuffixLength && has_prefix(candidate, key);
+    }
+
+    template <typename Bitmap>
+    Bitmap read_chunk(ByteView serialized) {
+        return Bitmap::readSafe(byte_ptr_cast(serialized.data()), serialized.size());
+    }
+
+    template <typename Bitmap>
+    void put_chunk(lmdb::Table &index, ByteView key, uint64_t suffix, const Bitmap &chunk, unsigned int db_flags) {
+        Bytes value(chunk.getSizeInBytes(), '\0');
+        chunk.write(byte_ptr_cast(value.data()));
+        index.put(chunk_key<Bitmap>(key, suffix), value, db_flags);
+    }
+
+}  // namespace
+
+template <typename Bitmap>
+void append(lmdb::Table &index, ByteView key, Bitmap bitmap, unsigned int db_flags) {
+    using Traits = ChunkTraits<Bitmap>;
+
+    if (std::optional<ByteView> last_chunk{index.get(chunk_key<Bitmap>(key, Traits::kMaxSuffix))}) {
+        bitmap |= read_chunk<Bitmap>(*last_chunk);
+        db_flags = 0;
+    }
+
+    bitmap.runOptimize();
+    while (bitmap.getSizeInBytes() > kBitmapChunkLimit) {
+        Bitmap chunk{cut_left(bitmap, kBitmapChunkLimit)};
+        put_chunk(index, key, chunk.maximum(), chunk, db_flags);
+    }
+    if (!bitmap.isEmpty()) {
+        put_chunk(index, key, Traits::kMaxSuffix, bitmap, db_flags);
+    }
+}
+
+template <typename Bitmap>
+void truncate(lmdb::Table &index, ByteView key, uint64_t from) {
+    using Traits = ChunkTraits<Bitmap>;
+
+    if (from > Traits::kMaxSuffix) {
+        return;
+    }
+
+    // Chunks with an upper bound not lower than from are dropped, except for the values of the first one below from
+    const Bytes seek_key{chunk_key<Bitmap>(key, from)};
+    std::optional<Bitmap> remainder;
+    for (auto entry{index.seek(seek_key)}; entry && is_chunk_key<Bitmap>(key, entry->key); entry = index.get_next()) {
+        if (!remainder) {
+            remainder.emplace();
+            for (auto value : read_chunk<Bitmap>(entry->value)) {
+                if (value >= from) {
+                    break;
+                }
+                remainder->add(value);
+            }
+        }
+        lmdb::err_handler(index.del_current());
+    }
+
+    if (!remainder) {
+        return;
+    }
+    if (!remainder->isEmpty()) {
+        put_chunk(index, key, Traits::kMaxSuffix, *remainder, 0);
+        return;
+    }
+
+    // The previous chunk, if any, becomes the last one
+    MDB_val mdb_key{}, mdb_data{};
+    int rc{index.seek(seek_key) ? index.get_prev(&mdb_key, &mdb_data) : index.get_last(&mdb_key, &mdb_data)};
+    if (rc == MDB_NOTFOUND) {
+        return;
+    }
+    lmdb::err_handler(rc);
+    if (is_chunk_key<Bitmap>(key, from_mdb_val(mdb_key))) {
+        const Bytes value{from_mdb_val(mdb_data)};
+        lmdb::err_handler(index.del_current());
+        index.put(chunk_key<Bitmap>(key, Traits::kMaxSuffix), value);
+    }
+}
+
+template void append(lmdb::Table &, ByteView, roaring::Roaring64Map, unsigned int);
+template void append(lmdb::Table &, ByteView, roaring::Roaring, unsigned int);
+template void truncate<roaring::Roaring64Map>(lmdb::Table &, ByteView, uint64_t);
+template void truncate<roaring::Roaring>(lmdb::Table &, ByteView, uint64_t);
+
 }  // namespace silkworm::db::bitmap
@@ -25,6 +25,7 @@
 #pragma GCC diagnostic pop
 
 #include <silkworm/common/base.hpp>
+#include <silkworm/db/chaindb.hpp>
 
 namespace silkworm::db::bitmap {
 
@@ -42,6 +43,25 @@ std::optional<uint64_t> seek(const roaring::Roaring64Map &bitmap, uint64_t n);
 roaring::Roaring64Map cut_left(roaring::Roaring64Map &bitmap, uint64_t len);
 roaring::Roaring cut_left(roaring::Roaring &bitmap, uint64_t len);
 
+/*
+ * Chunked bitmap indexes (history & log indexes) map key + chunk upper bound (big endian) to a chunk of
+ * the bitmap of key, the last chunk being keyed by the maximum value of the suffix instead.
+ * History indexes have 64-bit bitmaps (roaring::Roaring64Map) & suffixes, log indexes 32-bit ones.
+ * See TG bitmapdb.
+ */
+
+// Adds the values of bitmap, none of them lower than those already indexed, to the index of key:
+// they're merged into the last chunk in place, which is then split by cut_left into chunks of
+// at most kBitmapChunkLimit bytes. db_flags only apply if key isn't indexed yet
+// (e.g. MDB_APPEND when keys are added in order into a new index).
+template <typename Bitmap>
+void append(lmdb::Table &index, ByteView key, Bitmap bitmap, unsigned int db_flags = 0);
+
+// Removes the values not lower than from out of the index of key (unwind).
+// What's left of the first chunk affected, if anything, becomes the last chunk.
+template <typename Bitmap>
+void truncate(lmdb::Table &index, ByteView key, uint64_t from);
+
 };  // namespace silkworm::db::bitmap
 
 #endif  // !SILKWORM_DB_BITMAP_HPP_
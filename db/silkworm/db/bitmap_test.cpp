@@ -18,9 +18,13 @@
 
 #include <vector>
 
+#include <boost/endian/conversion.hpp>
 #include <catch2/catch.hpp>
 
+#include <silkworm/common/temp_dir.hpp>
+
 #include "access_layer.hpp"
+#include "tables.hpp"
 
 namespace silkworm::db::bitmap {
 TEST_CASE("cut_left") {
@@ -36,4 +40,89 @@ TEST_CASE("cut_left") {
     }
     CHECK(actual == expected);
 }
+
+TEST_CASE("cut_left sparse") {
+    roaring::Roaring64Map bitmap;
+    for (uint64_t i{0}; i < 5'000; ++i) {
+        bitmap.add(i * 3);
+    }
+    const roaring::Roaring64Map expected{bitmap};
+
+    roaring::Roaring64Map actual;
+    std::optional<uint64_t> previous_max;
+    while (!bitmap.isEmpty()) {
+        roaring::Roaring64Map chunk{cut_left(bitmap, kBitmapChunkLimit)};
+        REQUIRE(!chunk.isEmpty());
+        CHECK(chunk.getSizeInBytes() <= kBitmapChunkLimit);
+        if (previous_max) {
+            CHECK(chunk.minimum() > *previous_max);
+        }
+        previous_max = chunk.maximum();
+        actual |= chunk;
+    }
+    CHECK(actual == expected);
+}
+
+// All chunks of key along with their suffixes
+static std::vector<std::pair<uint64_t, roaring::Roaring64Map>> read_chunks(lmdb::Table &index, ByteView key) {
+    std::vector<std::pair<uint64_t, roaring::Roaring64Map>> chunks;
+    for (auto entry{index.seek(key)}; entry && entry->key.substr(0, key.length()) == key; entry = index.get_next()) {
+        chunks.emplace_back(boost::endian::load_big_u64(&entry->key[key.length()]), read(entry->value));
+    }
+    return chunks;
+}
+
+TEST_CASE("Chunked index") {
+    TemporaryDirectory tmp_dir;
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 * kMebi};
+    db_config.set_readonly(false);
+    auto env{lmdb::get_env(db_config)};
+    auto txn{env->begin_rw_transaction()};
+    table::create_all(*txn);
+    auto index{txn->open(table::kAccountHistory)};
+
+    const Bytes key{*from_hex("0xbe00000000000000000000000000000000000001")};
+    const Bytes other_key{*from_hex("0xbe00000000000000000000000000000000000002")};
+
+    auto check_chunks{[&](uint64_t end) {
+        auto chunks{read_chunks(*index, key)};
+        roaring::Roaring64Map actual;
+        for (size_t i{0}; i < chunks.size(); ++i) {
+            const auto &[suffix, chunk] = chunks[i];
+            CHECK(suffix == (i + 1 == chunks.size() ? UINT64_MAX : chunk.maximum()));
+            CHECK(chunk.getSizeInBytes() <= kBitmapChunkLimit);
+            actual |= chunk;
+        }
+        roaring::Roaring64Map expected;
+        for (uint64_t i{0}; i * 3 < end; ++i) {
+            expected.add(i * 3);
+        }
+        CHECK(actual == expected);
+        return chunks.size();
+    }};
+
+    // Appended in two rounds, the second one merged into the last chunk
+    roaring::Roaring64Map first, second;
+    for (uint64_t i{0}; i < 5'000; ++i) {
+        (i < 2'500 ? first : second).add(i * 3);
+    }
+    append(*index, key, first, MDB_APPEND);
+    append(*index, other_key, roaring::Roaring64Map{second});
+    append(*index, key, second);
+    CHECK(check_chunks(15'000) > 2);
+
+    // Unwind within a chunk
+    truncate<roaring::Roaring64Map>(*index, key, 10'000);
+    check_chunks(10'000);
+
+    // Unwind right after a chunk: the previous one becomes the last one
+    const uint64_t first_chunk_max{read_chunks(*index, key).front().second.maximum()};
+    truncate<roaring::Roaring64Map>(*index, key, first_chunk_max + 1);
+    CHECK(check_chunks(first_chunk_max + 1) == 1);
+
+    truncate<roaring::Roaring64Map>(*index, key, 0);
+    CHECK(read_chunks(*index, key).empty());
+    CHECK(read_chunks(*index, other_key).size() > 1);
+}
+
 }  // namespace silkworm::db::bitmap
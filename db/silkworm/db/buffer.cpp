@@ -18,7 +18,6 @@
 
 #include <algorithm>
 
-#include <absl/container/btree_set.h>
 #include <boost/endian/conversion.hpp>
 
 #include <silkworm/common/util.hpp>
@@ -30,12 +29,67 @@
 
 namespace silkworm::db {
 
+using StorageEntry = std::pair<const detail::StorageKey, evmc::bytes32>;
+
+static detail::StorageKey flat_storage_key(const evmc::address& address, uint64_t incarnation,
+                                           const evmc::bytes32& location) {
+    detail::StorageKey key;
+    std::memcpy(&key.bytes[0], address.bytes, kAddressLength);
+    boost::endian::store_big_u64(&key.bytes[kAddressLength], incarnation);
+    std::memcpy(&key.bytes[kStoragePrefixLength], location.bytes, kHashLength);
+    return key;
+}
+
+static detail::AccountChangeKey flat_account_change_key(uint64_t block_number, const evmc::address& address) {
+    detail::AccountChangeKey key;
+    boost::endian::store_big_u64(&key.bytes[0], block_number);
+    std::memcpy(&key.bytes[sizeof(uint64_t)], address.bytes, kAddressLength);
+    return key;
+}
+
+static detail::StorageChangeKey flat_storage_change_key(uint64_t block_number, const detail::StorageKey& storage_key) {
+    detail::StorageChangeKey key;
+    boost::endian::store_big_u64(&key.bytes[0], block_number);
+    std::memcpy(&key.bytes[sizeof(uint64_t)], storage_key.bytes, sizeof(storage_key.bytes));
+    return key;
+}
+
+static Bytes encode_initial(const detail::InitialAccount& initial) {
+    return initial.account ? initial.account->encode_for_storage(initial.omit_code_hash) : Bytes{};
+}
+
+// Pointers to the entries of a hash map, sorted by key
+template <typename Map>
+static std::vector<const typename Map::value_type*> sorted_entries(const Map& map) {
+    std::vector<const typename Map::value_type*> entries;
+    entries.reserve(map.size());
+    for (const auto& entry : map) {
+        entries.push_back(&entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+    return entries;
+}
+
+// Approximate memory held by the entries of a flat hash map: their slots and control bytes.
+// Counting entries rather than capacity makes the batch size grow steadily instead of by the whole
+// slot array on each rehash, which would make batch boundaries erratic.
+template <typename Map>
+static size_t flat_map_memory(const Map& map) {
+    static constexpr size_t kControlBytes{1};
+    return map.size() * (sizeof(typename Map::value_type) + kControlBytes);
+}
+
 void Buffer::bump_batch_size(size_t key_len, size_t value_len) {
     // Approximately matches TG batch size logic in (m *mutation) Put
     static constexpr size_t kEntryOverhead{8};
     batch_size_ += kEntryOverhead + key_len + value_len;
 }
 
+size_t Buffer::current_batch_size() const noexcept {
+    return batch_size_ + flat_map_memory(accounts_) + flat_map_memory(storage_) + flat_map_memory(account_changes_) +
+           flat_map_memory(storage_changes_);
+}
+
 void Buffer::begin_block(uint64_t block_number) {
     block_number_ = block_number;
     changed_storage_.clear();
@@ -52,22 +106,15 @@ void Buffer::update_account(const evmc::address& address, std::optional<Account>
         return;
     }
 
-    Bytes encoded_initial{};
-    if (initial) {
-        bool omit_code_hash{!account_deleted};
-        encoded_initial = initial->encode_for_storage(omit_code_hash);
-    }
-    if (account_changes_[block_number_].insert_or_assign(address, encoded_initial).second) {
-        bump_batch_size(8, kAddressLength + encoded_initial.length());
-    }
+    bool omit_code_hash{!account_deleted};
+    account_changes_.insert_or_assign(flat_account_change_key(block_number_, address),
+                                      detail::InitialAccount{initial, omit_code_hash});
 
     if (equal) {
         return;
     }
 
-    if (accounts_.insert_or_assign(address, current).second) {
-        bump_batch_size(kAddressLength, current ? current->encoding_length_for_storage() : 0);
-    };
+    accounts_.insert_or_assign(address, current);
 
     if (account_deleted && initial->incarnation) {
         if (incarnations_.insert_or_assign(address, initial->incarnation).second) {
@@ -93,39 +140,38 @@ void Buffer::update_storage(const evmc::address& address, uint64_t incarnation,
         return;
     }
     changed_storage_.insert(address);
-    ByteView change_val{zeroless_view(initial)};
-    if (storage_changes_[block_number_][address][incarnation].insert_or_assign(location, change_val).second) {
-        bump_batch_size(8 + kStoragePrefixLength, kHashLength + change_val.size());
-    }
-
-    if (storage_[address][incarnation].insert_or_assign(location, current).second) {
-        bump_batch_size(kStoragePrefixLength, kHashLength + zeroless_view(current).size());
-    }
+    const detail::StorageKey key{flat_storage_key(address, incarnation, location)};
+    storage_changes_.insert_or_assign(flat_storage_change_key(block_number_, key), initial);
+    storage_.insert_or_assign(key, current);
 }
 
-evmc::bytes32 Buffer::account_storage_root(const evmc::address& address, uint64_t incarnation) const {
-    auto it1{storage_.find(address)};
-    if (it1 == storage_.end()) {
+// Storage root of a contract out of the storage entries sorted by key
+static evmc::bytes32 account_storage_root(const std::vector<const StorageEntry*>& storage, ByteView prefix) {
+    const auto first{std::lower_bound(storage.begin(), storage.end(), prefix, [](const auto* entry, ByteView p) {
+        return std::memcmp(entry->first.bytes, p.data(), kStoragePrefixLength) < 0;
+    })};
+    const auto last{std::upper_bound(first, storage.end(), prefix, [](ByteView p, const auto* entry) {
+        return std::memcmp(p.data(), entry->first.bytes, kStoragePrefixLength) < 0;
+    })};
+    if (first == last) {
         return kEmptyRoot;
     }
 
-    auto it2{it1->second.find(incarnation)};
-    if (it2 == it1->second.end()) {
-        return kEmptyRoot;
-    }
-
-    const auto& storage{it2->second};
-    if (storage.empty()) {
-        return kEmptyRoot;
+    std::vector<ByteView> locations;
+    locations.reserve(static_cast<size_t>(last - first));
+    for (auto it{first}; it != last; ++it) {
+        locations.push_back((*it)->first.view().substr(kStoragePrefixLength));
     }
+    std::vector<ethash::hash256> hashes(locations.size());
+    keccak256_many(locations.data(), locations.size(), hashes.data());
 
     std::map<evmc::bytes32, Bytes> storage_rlp;
     Bytes rlp;
-    for (const auto& [location, value] : storage) {
-        ethash::hash256 hash{keccak256(full_view(location))};
+    size_t i{0};
+    for (auto it{first}; it != last; ++it) {
         rlp.clear();
-        rlp::encode(rlp, zeroless_view(value));
-        storage_rlp[to_bytes32(full_view(hash.bytes))] = rlp;
+        rlp::encode(rlp, zeroless_view((*it)->second));
+        storage_rlp[to_bytes32(full_view(hashes[i++].bytes))] = rlp;
     }
 
     trie::HashBuilder hb;
@@ -136,11 +182,11 @@ evmc::bytes32 Buffer::account_storage_root(const evmc::address& address, uint64_
     return hb.root_hash();
 }
 
-static void upsert_storage_value(lmdb::Table& state_table, ByteView storage_prefix, const evmc::bytes32& location,
+static void upsert_storage_value(lmdb::Table& state_table, ByteView storage_prefix, ByteView location,
                                  const evmc::bytes32& value) {
-    state_table.del(storage_prefix, full_view(location));
+    state_table.del(storage_prefix, location);
     if (!is_zero(value)) {
-        Bytes data{full_view(location)};
+        Bytes data{location};
         data.append(zeroless_view(value));
         state_table.put(storage_prefix, data);
     }
@@ -150,46 +196,78 @@ void Buffer::write_to_state_table() {
     auto state_table{txn_->open(table::kPlainState)};
 
     // sort before inserting into the DB
-    absl::btree_set<evmc::address> addresses;
-    for (auto& x : accounts_) {
-        addresses.insert(x.first);
-    }
-    for (auto& x : storage_) {
-        addresses.insert(x.first);
-    }
-
-    std::vector<evmc::bytes32> storage_keys;
-
-    for (const auto& address : addresses) {
-        if (auto it{accounts_.find(address)}; it != accounts_.end()) {
+    const auto accounts{sorted_entries(accounts_)};
+    const auto storage{sorted_entries(storage_)};
+
+    // Merge by address, an account going before its storage as in the DB
+    auto account_it{accounts.begin()};
+    auto storage_it{storage.begin()};
+    while (account_it != accounts.end() || storage_it != storage.end()) {
+        if (storage_it == storage.end() ||
+            (account_it != accounts.end() &&
+             std::memcmp((*account_it)->first.bytes, (*storage_it)->first.bytes, kAddressLength) <= 0)) {
+            const auto& [address, account]{**account_it++};
             state_table->del(full_view(address));
-            if (it->second.has_value()) {
-                Bytes encoded{it->second->encode_for_storage()};
+            if (account.has_value()) {
+                Bytes encoded{account->encode_for_storage()};
                 state_table->put(full_view(address), encoded);
             }
+            if (state_cache_) {
+                state_cache_->put_account(address, account);
+            }
+        } else {
+            const auto& [key, value]{**storage_it++};
+            const ByteView prefix{key.view().substr(0, kStoragePrefixLength)};
+            const ByteView location{key.view().substr(kStoragePrefixLength)};
+            upsert_storage_value(*state_table, prefix, location, value);
+            if (state_cache_) {
+                state_cache_->put_storage(to_address(prefix), boost::endian::load_big_u64(&key.bytes[kAddressLength]),
+                                          to_bytes32(location), value);
+            }
         }
+    }
+}
 
-        if (auto it{storage_.find(address)}; it != storage_.end()) {
-            for (const auto& contract : it->second) {
-                uint64_t incarnation{contract.first};
-                Bytes prefix{storage_prefix(full_view(address), incarnation)};
+namespace {
 
-                const auto& contract_storage{contract.second};
+    // Puts the entries of a batch, given in increasing key & value order, into a table.
+    // If the batch starts past the last key already in the table, the entries are appended
+    // (MDB_APPEND, or MDB_APPENDDUP for further values of a key in MDB_DUPSORT tables),
+    // sparing a B-tree descent per entry; otherwise they fall back to plain puts.
+    class SortedWriter {
+      public:
+        explicit SortedWriter(lmdb::Table& table) : table_{table} {}
 
-                // sort before inserting into the DB
-                storage_keys.clear();
-                for (const auto& x : contract_storage) {
-                    storage_keys.push_back(x.first);
-                }
-                std::sort(storage_keys.begin(), storage_keys.end());
+        void put(ByteView key, ByteView value) {
+            if (!append_) {
+                append_ = past_last_key(key);
+            }
+            unsigned flags{0};
+            if (*append_) {
+                flags = key == last_key_ ? MDB_APPENDDUP : MDB_APPEND;
+                last_key_.assign(key);
+            }
+            table_.put(key, value, flags);
+        }
 
-                for (const auto& k : storage_keys) {
-                    upsert_storage_value(*state_table, prefix, k, contract_storage.at(k));
-                }
+      private:
+        bool past_last_key(ByteView key) {
+            MDB_val last_key;
+            MDB_val last_value;
+            const int rc{table_.get_last(&last_key, &last_value)};
+            if (rc == MDB_NOTFOUND) {
+                return true;
             }
+            lmdb::err_handler(rc);
+            return from_mdb_val(last_key) < key;
         }
-    }
-}
+
+        lmdb::Table& table_;
+        std::optional<bool> append_;  // decided upon the first entry
+        Bytes last_key_;
+    };
+
+}  // namespace
 
 void Buffer::write_to_db() {
     if (!txn_) {
@@ -215,43 +293,37 @@ void Buffer::write_to_db() {
         code_hash_table->put(entry.first, full_view(entry.second));
     }
 
+    // Change sets, receipts & logs are keyed by block number first, so a batch usually goes past what's stored
     auto account_change_table{txn_->open(table::kPlainAccountChangeSet)};
-    Bytes change_key;
-    for (const auto& block_entry : account_changes_) {
-        uint64_t block_num{block_entry.first};
-        change_key = block_key(block_num);
-        for (const auto& account_entry : block_entry.second) {
-            data = full_view(account_entry.first);
-            data.append(account_entry.second);
-            account_change_table->put(change_key, data);
-        }
+    SortedWriter account_change_writer{*account_change_table};
+    for (const auto* entry : sorted_entries(account_changes_)) {
+        // block number -> address | initial value
+        const ByteView key{entry->first.view()};
+        data = key.substr(sizeof(uint64_t));
+        data.append(encode_initial(entry->second));
+        account_change_writer.put(key.substr(0, sizeof(uint64_t)), data);
     }
 
     auto storage_change_table{txn_->open(table::kPlainStorageChangeSet)};
-    for (const auto& block_entry : storage_changes_) {
-        uint64_t block_num{block_entry.first};
-        for (const auto& address_entry : block_entry.second) {
-            const evmc::address& address{address_entry.first};
-            for (const auto& incarnation_entry : address_entry.second) {
-                uint64_t incarnation{incarnation_entry.first};
-                change_key = storage_change_key(block_num, address, incarnation);
-                for (const auto& storage_entry : incarnation_entry.second) {
-                    data = full_view(storage_entry.first);
-                    data.append(storage_entry.second);
-                    storage_change_table->put(change_key, data);
-                }
-            }
-        }
+    SortedWriter storage_change_writer{*storage_change_table};
+    for (const auto* entry : sorted_entries(storage_changes_)) {
+        // block number | address | incarnation -> location | zeroless initial value
+        const ByteView key{entry->first.view()};
+        data = key.substr(sizeof(uint64_t) + kStoragePrefixLength);
+        data.append(zeroless_view(entry->second));
+        storage_change_writer.put(key.substr(0, sizeof(uint64_t) + kStoragePrefixLength), data);
     }
 
     auto receipt_table{txn_->open(table::kBlockReceipts)};
+    SortedWriter receipt_writer{*receipt_table};
     for (const auto& entry : receipts_) {
-        receipt_table->put(entry.first, entry.second);
+        receipt_writer.put(entry.first, entry.second);
     }
 
     auto log_table{txn_->open(table::kLogs)};
+    SortedWriter log_writer{*log_table};
     for (const auto& entry : logs_) {
-        log_table->put(entry.first, entry.second);
+        log_writer.put(entry.first, entry.second);
     }
 }
 
@@ -283,12 +355,23 @@ evmc::bytes32 Buffer::state_root_hash() const {
         return kEmptyRoot;
     }
 
+    std::vector<ByteView> addresses;
+    for (const auto& [address, account] : accounts_) {
+        if (account.has_value()) {
+            addresses.push_back(full_view(address));
+        }
+    }
+    std::vector<ethash::hash256> hashes(addresses.size());
+    keccak256_many(addresses.data(), addresses.size(), hashes.data());
+
+    const auto storage{sorted_entries(storage_)};
     std::map<evmc::bytes32, Bytes> account_rlp;
+    size_t i{0};
     for (const auto& [address, account] : accounts_) {
         if (account.has_value()) {
-            ethash::hash256 hash{keccak256(full_view(address))};
-            evmc::bytes32 storage_root{account_storage_root(address, account->incarnation)};
-            account_rlp[to_bytes32(full_view(hash.bytes))] = account->rlp(storage_root);
+            const Bytes prefix{storage_prefix(full_view(address), account->incarnation)};
+            evmc::bytes32 storage_root{account_storage_root(storage, prefix)};
+            account_rlp[to_bytes32(full_view(hashes[i++].bytes))] = account->rlp(storage_root);
         }
     }
 
@@ -363,7 +446,18 @@ std::optional<Account> Buffer::read_account(const evmc::address& address) const
     if (!txn_) {
         return std::nullopt;
     }
-    return db::read_account(*txn_, address, historical_block_);
+    if (state_cache_) {
+        if (std::optional<std::optional<Account>> cached{state_cache_->get_account(address)}) {
+            return *cached;
+        }
+    }
+    std::optional<Account> account{historical_block_
+                                       ? historical_reader().read_account(address, *historical_block_)
+                                       : db::read_account(*txn_, address)};
+    if (state_cache_) {
+        state_cache_->put_account(address, account);
+    }
+    return account;
 }
 
 Bytes Buffer::read_code(const evmc::bytes32& code_hash) const noexcept {
@@ -383,18 +477,25 @@ Bytes Buffer::read_code(const evmc::bytes32& code_hash) const noexcept {
 
 evmc::bytes32 Buffer::read_storage(const evmc::address& address, uint64_t incarnation,
                                    const evmc::bytes32& location) const noexcept {
-    if (auto it1{storage_.find(address)}; it1 != storage_.end()) {
-        if (auto it2{it1->second.find(incarnation)}; it2 != it1->second.end()) {
-            if (auto it3{it2->second.find(location)}; it3 != it2->second.end()) {
-                return it3->second;
-            }
-        }
+    if (auto it{storage_.find(flat_storage_key(address, incarnation, location))}; it != storage_.end()) {
+        return it->second;
     }
 
     if (!txn_) {
         return {};
     }
-    return db::read_storage(*txn_, address, incarnation, location, historical_block_);
+    if (state_cache_) {
+        if (std::optional<evmc::bytes32> cached{state_cache_->get_storage(address, incarnation, location)}) {
+            return *cached;
+        }
+    }
+    evmc::bytes32 value{historical_block_
+                            ? historical_reader().read_storage(address, incarnation, location, *historical_block_)
+                            : db::read_storage(*txn_, address, incarnation, location)};
+    if (state_cache_) {
+        state_cache_->put_storage(address, incarnation, location, value);
+    }
+    return value;
 }
 
 uint64_t Buffer::previous_incarnation(const evmc::address& address) const noexcept {
@@ -408,6 +509,37 @@ uint64_t Buffer::previous_incarnation(const evmc::address& address) const noexce
     return incarnation ? *incarnation : 0;
 }
 
+AccountChanges Buffer::account_changes(uint64_t block_number) const {
+    AccountChanges changes;
+    for (const auto& [key, initial] : account_changes_) {
+        if (boost::endian::load_big_u64(key.bytes) == block_number) {
+            changes[to_address(key.view().substr(sizeof(uint64_t)))] = encode_initial(initial);
+        }
+    }
+    return changes;
+}
+
+StorageChanges Buffer::storage_changes(uint64_t block_number) const {
+    StorageChanges changes;
+    for (const auto& [key, initial] : storage_changes_) {
+        if (boost::endian::load_big_u64(key.bytes) == block_number) {
+            const ByteView storage_key{key.view().substr(sizeof(uint64_t))};
+            const evmc::address address{to_address(storage_key)};
+            const uint64_t incarnation{boost::endian::load_big_u64(&storage_key[kAddressLength])};
+            const evmc::bytes32 location{to_bytes32(storage_key.substr(kStoragePrefixLength))};
+            changes[address][incarnation][location] = Bytes{zeroless_view(initial)};
+        }
+    }
+    return changes;
+}
+
+HistoricalStateReader& Buffer::historical_reader() const {
+    if (!historical_reader_) {
+        historical_reader_ = std::make_unique<HistoricalStateReader>(*txn_);
+    }
+    return *historical_reader_;
+}
+
 void Buffer::unwind_state_changes(uint64_t) { throw std::runtime_error("not yet implemented"); }
 
 }  // namespace silkworm::db
@@ -17,7 +17,10 @@
 #ifndef SILKWORM_DB_BUFFER_HPP_
 #define SILKWORM_DB_BUFFER_HPP_
 
+#include <cstring>
+#include <memory>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include <absl/container/btree_map.h>
@@ -25,6 +28,8 @@
 #include <absl/container/flat_hash_set.h>
 
 #include <silkworm/db/chaindb.hpp>
+#include <silkworm/db/history.hpp>
+#include <silkworm/db/state_cache.hpp>
 #include <silkworm/db/util.hpp>
 #include <silkworm/state/buffer.hpp>
 #include <silkworm/trie/hash_builder.hpp>
@@ -34,10 +39,50 @@
 
 namespace silkworm::db {
 
+namespace detail {
+
+    // Fixed-width composite key of pending writes, laid out as its DB counterpart so that keys sort the same way
+    template <size_t N>
+    struct FlatKey {
+        uint8_t bytes[N];
+
+        ByteView view() const { return {bytes, N}; }
+
+        friend bool operator==(const FlatKey& a, const FlatKey& b) { return std::memcmp(a.bytes, b.bytes, N) == 0; }
+        friend bool operator<(const FlatKey& a, const FlatKey& b) { return std::memcmp(a.bytes, b.bytes, N) < 0; }
+
+        template <typename H>
+        friend H AbslHashValue(H h, const FlatKey& key) {
+            return H::combine_contiguous(std::move(h), key.bytes, N);
+        }
+    };
+
+    // address | incarnation | location
+    using StorageKey = FlatKey<kStoragePrefixLength + kHashLength>;
+
+    // block number | address
+    using AccountChangeKey = FlatKey<sizeof(uint64_t) + kAddressLength>;
+
+    // block number | address | incarnation | location
+    using StorageChangeKey = FlatKey<sizeof(uint64_t) + kStoragePrefixLength + kHashLength>;
+
+    // Initial value of an account change, storage-encoded on write
+    struct InitialAccount {
+        std::optional<Account> account;
+        bool omit_code_hash{false};
+    };
+
+}  // namespace detail
+
 class Buffer : public StateBuffer {
   public:
-    explicit Buffer(lmdb::Transaction* txn, std::optional<uint64_t> historical_block = std::nullopt)
-        : txn_{txn}, historical_block_{historical_block} {}
+    /** @param state_cache Optional cache of the current plain state, read through on account & storage misses
+     * and updated by write_to_db. Ignored when reading a historical state, which goes through a
+     * HistoricalStateReader of the buffer's own instead.
+     */
+    explicit Buffer(lmdb::Transaction* txn, std::optional<uint64_t> historical_block = std::nullopt,
+                    StateCache* state_cache = nullptr)
+        : txn_{txn}, historical_block_{historical_block}, state_cache_{historical_block ? nullptr : state_cache} {}
 
     /** @name Readers */
     ///@{
@@ -99,14 +144,14 @@ class Buffer : public StateBuffer {
 
     ///@}
 
-    /// Account (backward) changes per block
-    const absl::btree_map<uint64_t, AccountChanges>& account_changes() const { return account_changes_; }
+    /// Account (backward) changes of a block; goes through the changes of all blocks
+    AccountChanges account_changes(uint64_t block_number) const;
 
-    /// Storage (backward) changes per block
-    const absl::btree_map<uint64_t, StorageChanges>& storage_changes() const { return storage_changes_; }
+    /// Storage (backward) changes of a block; goes through the changes of all blocks
+    StorageChanges storage_changes(uint64_t block_number) const;
 
-    /** Approximate size of accumulated DB changes in bytes.*/
-    size_t current_batch_size() const noexcept { return batch_size_; }
+    /** Approximate memory held by accumulated DB changes in bytes.*/
+    size_t current_batch_size() const noexcept;
 
     void write_to_db();
 
@@ -115,23 +160,24 @@ class Buffer : public StateBuffer {
 
     void bump_batch_size(size_t key_len, size_t value_len);
 
+    HistoricalStateReader& historical_reader() const;
+
     lmdb::Transaction* txn_{nullptr};
     std::optional<uint64_t> historical_block_{};
+    StateCache* state_cache_{nullptr};
+    mutable std::unique_ptr<HistoricalStateReader> historical_reader_{};  // lazily created
 
     absl::btree_map<Bytes, BlockHeader> headers_{};
     absl::btree_map<Bytes, BlockBody> bodies_{};
     absl::btree_map<Bytes, intx::uint256> difficulty_{};
 
+    // Pending state & change sets are kept inline in flat hash maps under composite keys, without per entry
+    // allocations, and get sorted only once, when written to the DB.
     absl::flat_hash_map<evmc::address, std::optional<Account>> accounts_;
+    absl::flat_hash_map<detail::StorageKey, evmc::bytes32> storage_;
 
-    evmc::bytes32 account_storage_root(const evmc::address& address, uint64_t incarnation) const;
-
-    // address -> incarnation -> location -> value
-    absl::flat_hash_map<evmc::address, absl::btree_map<uint64_t, absl::flat_hash_map<evmc::bytes32, evmc::bytes32>>>
-        storage_;
-
-    absl::btree_map<uint64_t, AccountChanges> account_changes_;  // per block
-    absl::btree_map<uint64_t, StorageChanges> storage_changes_;  // per block
+    absl::flat_hash_map<detail::AccountChangeKey, detail::InitialAccount> account_changes_;
+    absl::flat_hash_map<detail::StorageChangeKey, evmc::bytes32> storage_changes_;  // initial values
 
     absl::btree_map<evmc::address, uint64_t> incarnations_;
     absl::btree_map<evmc::bytes32, Bytes> hash_to_code_;
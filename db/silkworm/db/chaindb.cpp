@@ -16,6 +16,8 @@
 
 #include "chaindb.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <filesystem>
 
@@ -34,7 +36,43 @@ void DatabaseConfig::set_readonly(bool value) {
     }
 }
 
-Environment::Environment(const DatabaseConfig& config) {
+namespace {
+
+    // Counts of the transactions opened by the current thread in an env.
+    // Only ever touched by their own thread, so neither locks nor atomics are needed.
+    // Entries are keyed by the unique id of their env, never reused by a later env at the same address,
+    // and are removed as soon as both counts drop back to zero.
+    struct ThreadTxnCounts {
+        uint64_t env_id{0};
+        int ro{0};
+        int rw{0};
+    };
+
+    thread_local std::vector<ThreadTxnCounts> thread_txn_counts{};
+
+    std::vector<ThreadTxnCounts>::iterator find_txn_counts(uint64_t env_id) {
+        return std::find_if(thread_txn_counts.begin(), thread_txn_counts.end(),
+                            [env_id](const ThreadTxnCounts& counts) { return counts.env_id == env_id; });
+    }
+
+    void touch_txn_counts(uint64_t env_id, int ro, int rw) {
+        auto it{find_txn_counts(env_id)};
+        if (it == thread_txn_counts.end()) {
+            it = thread_txn_counts.insert(it, ThreadTxnCounts{env_id});
+        }
+        it->ro += ro;
+        it->rw += rw;
+        if (!it->ro && !it->rw) {
+            *it = thread_txn_counts.back();
+            thread_txn_counts.pop_back();
+        }
+    }
+
+    std::atomic<uint64_t> next_env_id{1};
+
+}  // namespace
+
+Environment::Environment(const DatabaseConfig& config) : id_{next_env_id++} {
     if (config.path.empty()) {
         throw std::invalid_argument("Invalid argument : config.path");
     }
@@ -85,6 +123,13 @@ bool Environment::is_ro(void) {
 
 void Environment::close() noexcept {
     if (handle_) {
+        {
+            std::lock_guard<std::mutex> l(ro_txn_pool_mtx_);
+            for (MDB_txn* txn : ro_txn_pool_) {
+                mdb_txn_abort(txn);
+            }
+            ro_txn_pool_.clear();
+        }
         mdb_env_close(handle_);
         handle_ = nullptr;
     }
@@ -169,17 +214,64 @@ int Environment::set_max_readers(const unsigned int count) { return mdb_env_set_
 
 int Environment::sync(const bool force) { return mdb_env_sync(handle_, force); }
 
-int Environment::get_ro_txns(void) noexcept { return ro_txns_[std::this_thread::get_id()]; }
-int Environment::get_rw_txns(void) noexcept { return rw_txns_[std::this_thread::get_id()]; }
+int Environment::get_ro_txns(void) noexcept {
+    auto it{find_txn_counts(id_)};
+    return it == thread_txn_counts.end() ? 0 : it->ro;
+}
+int Environment::get_rw_txns(void) noexcept {
+    auto it{find_txn_counts(id_)};
+    return it == thread_txn_counts.end() ? 0 : it->rw;
+}
 
-void Environment::touch_ro_txns(int count) noexcept {
-    std::lock_guard<std::mutex> l(count_mtx_);
-    ro_txns_[std::this_thread::get_id()] += count;
+void Environment::touch_ro_txns(int count) noexcept { touch_txn_counts(id_, count, 0); }
+void Environment::touch_rw_txns(int count) noexcept { touch_txn_counts(id_, 0, count); }
+
+MDB_txn* Environment::acquire_pooled_ro_txn() noexcept {
+    std::lock_guard<std::mutex> l(ro_txn_pool_mtx_);
+    if (ro_txn_pool_.empty()) {
+        return nullptr;
+    }
+    MDB_txn* txn{ro_txn_pool_.back()};
+    ro_txn_pool_.pop_back();
+    return txn;
+}
+
+void Environment::release_pooled_ro_txn(MDB_txn* txn) noexcept {
+    mdb_txn_reset(txn);
+    {
+        std::lock_guard<std::mutex> l(ro_txn_pool_mtx_);
+        if (ro_txn_pool_.size() < kMaxPooledRoTxns) {
+            ro_txn_pool_.push_back(txn);
+            return;
+        }
+    }
+    mdb_txn_abort(txn);
 }
 
-void Environment::touch_rw_txns(int count) noexcept {
-    std::lock_guard<std::mutex> l(count_mtx_);
-    rw_txns_[std::this_thread::get_id()] += count;
+std::optional<MDB_dbi> Environment::get_dbi(std::string_view name) {
+    std::lock_guard<std::mutex> l(dbis_mtx_);
+    if (auto it{dbis_.find(name)}; it != dbis_.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+void Environment::cache_dbis(const std::vector<std::pair<std::string, MDB_dbi>>& dbis) noexcept {
+    std::lock_guard<std::mutex> l(dbis_mtx_);
+    for (const auto& [name, dbi] : dbis) {
+        dbis_.insert_or_assign(name, dbi);
+    }
+}
+
+void Environment::forget_dbi(MDB_dbi dbi) noexcept {
+    std::lock_guard<std::mutex> l(dbis_mtx_);
+    for (auto it{dbis_.begin()}; it != dbis_.end();) {
+        if (it->second == dbi) {
+            it = dbis_.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 std::unique_ptr<Transaction> Environment::begin_transaction(unsigned int flags) {
@@ -199,12 +291,37 @@ std::unique_ptr<Transaction> Environment::begin_rw_transaction(unsigned int flag
     return begin_transaction(flags);
 }
 
+std::unique_ptr<Transaction> Environment::begin_pooled_ro_transaction() {
+    unsigned int env_flags{0};
+    err_handler(get_flags(&env_flags));
+    if ((env_flags & MDB_NOTLS) != MDB_NOTLS) {
+        // Reader slots are bound to threads: nothing to share
+        return begin_ro_transaction();
+    }
+
+    if (get_rw_txns()) {
+        throw std::runtime_error("Rw transaction already pending in this thread");
+    }
+
+    if (MDB_txn* txn{acquire_pooled_ro_txn()}; txn) {
+        // Renewal fails e.g. when the map has been resized by another process: fall back to a new handle
+        if (mdb_txn_renew(txn) == MDB_SUCCESS) {
+            touch_ro_txns(1);
+            return std::make_unique<Transaction>(this, txn, MDB_RDONLY, /*pooled=*/true);
+        }
+        mdb_txn_abort(txn);
+    }
+
+    return std::make_unique<Transaction>(this, Transaction::open_transaction(this, nullptr, MDB_RDONLY), MDB_RDONLY,
+                                         /*pooled=*/true);
+}
+
 /*
  * Transactions
  */
 
-Transaction::Transaction(Environment* parent, MDB_txn* txn, unsigned int flags)
-    : parent_env_{parent}, handle_{txn}, flags_{flags} {}
+Transaction::Transaction(Environment* parent, MDB_txn* txn, unsigned int flags, bool pooled)
+    : parent_env_{parent}, handle_{txn}, flags_{flags}, pooled_{pooled}, cursor_pool_{std::make_shared<CursorPool>()} {}
 
 MDB_txn* Transaction::open_transaction(Environment* parent_env, MDB_txn* parent_txn, unsigned int flags) {
     /*
@@ -266,6 +383,76 @@ MDB_dbi Transaction::open_dbi(const char* name, unsigned int flags) {
     return newdbi;
 }
 
+MDB_dbi Transaction::get_dbi(const TableConfig& config, unsigned int flags) {
+    if (auto it{dbis_.find(std::string_view{config.name})}; it != dbis_.end()) {
+        return it->second;
+    }
+
+    // A dbi cached by the env is valid in this transaction unless the latter predates the table creation.
+    // Transactions wrapping an external handle have no env to share dbis with
+    if (parent_env_) {
+        if (std::optional<MDB_dbi> dbi{parent_env_->get_dbi(config.name)}; dbi.has_value()) {
+            unsigned int persisted_flags{0};
+            if (mdb_dbi_flags(handle_, *dbi, &persisted_flags) == MDB_SUCCESS) {
+                dbis_.emplace(config.name, *dbi);
+                return *dbi;
+            }
+        }
+    }
+
+    MDB_dbi dbi{open_dbi(config.name, flags)};
+
+    // Apply custom comparators if any
+    if (config.cmp_func || config.dcmp_func) {
+        unsigned int persisted_flags{0};
+        lmdb::err_handler(mdb_dbi_flags(handle_, dbi, &persisted_flags));
+        if (config.cmp_func) {
+            lmdb::err_handler(mdb_set_compare(handle_, dbi, config.cmp_func));
+        }
+        if (config.dcmp_func && (persisted_flags & MDB_DUPSORT)) {
+            lmdb::err_handler(mdb_set_dupsort(handle_, dbi, config.dcmp_func));
+        }
+    }
+
+    dbis_.emplace(config.name, dbi);
+    if (parent_env_) {
+        new_dbis_.emplace_back(config.name, dbi);
+    }
+    return dbi;
+}
+
+MDB_cursor* Transaction::acquire_cursor(MDB_dbi dbi) {
+    auto& idle{cursor_pool_->idle};
+    for (auto it{idle.rbegin()}; it != idle.rend(); ++it) {
+        if (it->first == dbi) {
+            MDB_cursor* cursor{it->second};
+            idle.erase(std::next(it).base());
+            return cursor;
+        }
+    }
+    return Table::open_cursor(this, dbi);
+}
+
+void Transaction::close_cursors() noexcept {
+    for (const auto& [dbi, cursor] : cursor_pool_->idle) {
+        mdb_cursor_close(cursor);
+    }
+    cursor_pool_->idle.clear();
+    cursor_pool_->open = false;
+}
+
+void Transaction::close_cursors(MDB_dbi dbi) noexcept {
+    auto& idle{cursor_pool_->idle};
+    for (auto it{idle.begin()}; it != idle.end();) {
+        if (it->first == dbi) {
+            mdb_cursor_close(it->second);
+            it = idle.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 Transaction::Transaction(Environment* parent, unsigned int flags)
     : Transaction(parent, open_transaction(parent, nullptr, flags), flags) {}
 Transaction::~Transaction() { abort(); }
@@ -326,20 +513,7 @@ int Transaction::put(const TableConfig& domain, MDB_val* mdb_key, MDB_val* mdb_d
 
 std::unique_ptr<Table> Transaction::open(const TableConfig& config, unsigned flags) {
     flags |= config.flags;
-    MDB_dbi dbi{open_dbi(config.name, flags)};
-
-    // Apply custom comparators if any
-    if (config.cmp_func || config.dcmp_func) {
-        unsigned int persisted_flags{0};
-        lmdb::err_handler(mdb_dbi_flags(handle_, dbi, &persisted_flags));
-        if (config.cmp_func) {
-            lmdb::err_handler(mdb_set_compare(handle_, dbi, config.cmp_func));
-        }
-        if (config.dcmp_func && (persisted_flags & MDB_DUPSORT)) {
-            lmdb::err_handler(mdb_set_dupsort(handle_, dbi, config.dcmp_func));
-        }
-    }
-
+    MDB_dbi dbi{config.name ? get_dbi(config, flags) : open_dbi(config.name, flags)};
     return std::make_unique<Table>(this, dbi, config.name);
 }
 
@@ -352,16 +526,38 @@ std::unique_ptr<Table> Transaction::open(MDB_dbi dbi) {
 
 void Transaction::abort(void) {
     if (handle_) {
-        mdb_txn_abort(handle_);
-        if (is_ro()) {
-            parent_env_->touch_ro_txns(-1);
+        close_cursors();
+        if (pooled_) {
+            parent_env_->release_pooled_ro_txn(handle_);
         } else {
-            parent_env_->touch_rw_txns(-1);
+            mdb_txn_abort(handle_);
         }
+        untrack();
         handle_ = nullptr;
     }
 }
 
+MDB_txn* Transaction::release(void) noexcept {
+    close_cursors();
+    if (handle_) {
+        untrack();
+    }
+    MDB_txn* txn{handle_};
+    handle_ = nullptr;
+    return txn;
+}
+
+void Transaction::untrack(void) noexcept {
+    if (!parent_env_) {
+        return;
+    }
+    if (is_ro()) {
+        parent_env_->touch_ro_txns(-1);
+    } else {
+        parent_env_->touch_rw_txns(-1);
+    }
+}
+
 int Transaction::commit(void) {
     if (!handle_) return MDB_BAD_TXN;
 
@@ -370,12 +566,18 @@ int Transaction::commit(void) {
      * see
      * https://github.com/LMDB/lmdb/blob/mdb.master/libraries/liblmdb/mdb.c#L4125-L4131
      */
+    if (pooled_) {
+        // Nothing to commit for a ro transaction
+        abort();
+        return MDB_SUCCESS;
+    }
+
+    close_cursors();
     int rc{mdb_txn_commit(handle_)};
-    if (is_ro()) {
-        parent_env_->touch_ro_txns(-1);
-    } else {
-        parent_env_->touch_rw_txns(-1);
+    if (rc == MDB_SUCCESS && parent_env_) {
+        parent_env_->cache_dbis(new_dbis_);
     }
+    untrack();
     handle_ = nullptr;
     return rc;
 }
@@ -385,7 +587,7 @@ int Transaction::commit(void) {
  */
 
 Table::Table(Transaction* parent, MDB_dbi dbi, const char* name)
-    : Table::Table(parent, dbi, name, open_cursor(parent, dbi)) {}
+    : Table::Table(parent, dbi, name, parent->acquire_cursor(dbi)) {}
 
 Table::~Table() { close(); }
 
@@ -399,7 +601,7 @@ MDB_cursor* Table::open_cursor(Transaction* parent, MDB_dbi dbi) {
 }
 
 Table::Table(Transaction* parent, MDB_dbi dbi, const char* name, MDB_cursor* cursor)
-    : parent_txn_{parent}, dbi_{dbi}, name_{name ? name : ""}, handle_{cursor} {}
+    : parent_txn_{parent}, dbi_{dbi}, name_{name ? name : ""}, handle_{cursor}, cursor_pool_{parent->cursor_pool_} {}
 
 int Table::get_flags(unsigned int* flags) { return mdb_dbi_flags(*parent_txn_->handle(), dbi_, flags); }
 
@@ -434,16 +636,53 @@ int Table::clear() {
 }
 
 int Table::drop() {
-    close();
     dbi_dropped_ = true;
+    close();
+    // The dbi handle gets closed as well
+    parent_txn_->close_cursors(dbi_);
+    parent_txn_->dbis_.erase(name_);
+    auto& new_dbis{parent_txn_->new_dbis_};
+    new_dbis.erase(std::remove_if(new_dbis.begin(), new_dbis.end(), [this](const auto& x) { return x.second == dbi_; }),
+                   new_dbis.end());
+    if (parent_txn_->parent_env_) {
+        parent_txn_->parent_env_->forget_dbi(dbi_);
+    }
     return mdb_drop(parent_txn_->handle_, dbi_, 1);
 }
 
 int Table::get(MDB_val* key, MDB_val* data, MDB_cursor_op operation) {
+    if (!positioned_) {
+        // A reused cursor is still positioned where its previous table left it: start over as a new one would
+        switch (operation) {
+            case MDB_NEXT:
+            case MDB_NEXT_DUP:
+            case MDB_NEXT_NODUP:
+                operation = MDB_FIRST;
+                break;
+            case MDB_PREV:
+            case MDB_PREV_DUP:
+            case MDB_PREV_NODUP:
+                operation = MDB_LAST;
+                break;
+            case MDB_GET_CURRENT:
+            case MDB_FIRST_DUP:
+            case MDB_LAST_DUP:
+                return EINVAL;
+            default:
+                break;
+        }
+        positioned_ = true;
+    }
     return mdb_cursor_get(handle_, key, data, operation);
 }
 
-int Table::put(MDB_val* key, MDB_val* data, unsigned int flag) { return mdb_cursor_put(handle_, key, data, flag); }
+int Table::put(MDB_val* key, MDB_val* data, unsigned int flag) {
+    if (!positioned_ && (flag & MDB_CURRENT)) {
+        return EINVAL;
+    }
+    positioned_ = true;
+    return mdb_cursor_put(handle_, key, data, flag);
+}
 
 std::optional<ByteView> Table::get(ByteView key) {
     MDB_val key_val{db::to_mdb_val(key)};
@@ -543,6 +782,9 @@ int Table::seek(MDB_val* key, MDB_val* data) { return get(key, data, MDB_SET_RAN
 int Table::seek_exact(MDB_val* key, MDB_val* data) { return get(key, data, MDB_SET); }
 int Table::get_current(MDB_val* key, MDB_val* data) { return get(key, data, MDB_GET_CURRENT); }
 int Table::del_current(bool alldupkeys) {
+    if (!positioned_) {
+        return EINVAL;
+    }
     if (alldupkeys) {
         unsigned int flags{0};
         int rc{get_flags(&flags)};
@@ -563,7 +805,7 @@ int Table::get_next(MDB_val* key, MDB_val* data) { return get(key, data, MDB_NEX
 int Table::get_next_dup(MDB_val* key, MDB_val* data) { return get(key, data, MDB_NEXT_DUP); }
 int Table::get_next_nodup(MDB_val* key, MDB_val* data) { return get(key, data, MDB_NEXT_NODUP); }
 int Table::get_last(MDB_val* key, MDB_val* data) { return get(key, data, MDB_LAST); }
-int Table::get_dcount(size_t* count) { return mdb_cursor_count(handle_, count); }
+int Table::get_dcount(size_t* count) { return positioned_ ? mdb_cursor_count(handle_, count) : EINVAL; }
 
 void Table::put(ByteView key, ByteView data, unsigned int flags) {
     MDB_val key_val{db::to_mdb_val(key)};
@@ -580,11 +822,16 @@ int Table::put_append_dup(MDB_val* key, MDB_val* data) { return put(key, data, M
 int Table::put_multiple(MDB_val* key, MDB_val* data) { return put(key, data, MDB_MULTIPLE); }
 
 void Table::close() {
-    // Free the cursor handle
+    // Hand the cursor over to the transaction for reuse, or free it if the transaction is over
     // There is no need to close the dbi_ handle
     if (handle_) {
-        mdb_cursor_close(handle_);
+        if (cursor_pool_->open && !dbi_dropped_) {
+            cursor_pool_->idle.emplace_back(dbi_, handle_);
+        } else {
+            mdb_cursor_close(handle_);
+        }
         handle_ = nullptr;
+        positioned_ = false;
     }
 }
 
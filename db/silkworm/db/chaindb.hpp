@@ -24,10 +24,13 @@
 
 #include <exception>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include <lmdb/lmdb.h>
@@ -107,10 +110,12 @@ class Environment {
     std::string path_{""};      // Path to data
 
     friend class Transaction;
+    friend class Table;
+
+    const uint64_t id_;  // Unique id of this env, keying the thread local counts of opened transactions
 
-    std::mutex count_mtx_;                      // Lock to prevent concurrent access to transactions counters maps
-    std::map<std::thread::id, int> ro_txns_{};  // A per thread maintained count of opened ro transactions
-    std::map<std::thread::id, int> rw_txns_{};  // A per thread maintained count of opened rw transactions
+    std::mutex ro_txn_pool_mtx_;           // Lock to prevent concurrent access to the pool of ro transactions
+    std::vector<MDB_txn*> ro_txn_pool_{};  // Reset ro transactions ready to be renewed
 
     /*
      * A transaction and its cursors must only be used by a single thread,
@@ -125,7 +130,17 @@ class Environment {
     int get_ro_txns(void) noexcept;          // Returns number of opened ro transactions for calling thread
     int get_rw_txns(void) noexcept;          // Returns number of opened rw transactions for calling thread
     void touch_ro_txns(int count) noexcept;  // Ro transaction count incrementer/decrementer
-    void touch_rw_txns(int count) noexcept;  // Ro transaction count incrementer/decrementer
+    void touch_rw_txns(int count) noexcept;  // Rw transaction count incrementer/decrementer
+
+    MDB_txn* acquire_pooled_ro_txn() noexcept;          // Pops a reset ro transaction off the pool, if any
+    void release_pooled_ro_txn(MDB_txn* txn) noexcept;  // Resets a ro transaction and puts it back into the pool
+
+    std::mutex dbis_mtx_;                                 // Lock to prevent concurrent access to the dbis map
+    std::map<std::string, MDB_dbi, std::less<>> dbis_{};  // Named tables opened by committed transactions
+
+    std::optional<MDB_dbi> get_dbi(std::string_view name);                            // Looks up a cached dbi
+    void cache_dbis(const std::vector<std::pair<std::string, MDB_dbi>>& dbis) noexcept;  // Caches committed dbis
+    void forget_dbi(MDB_dbi dbi) noexcept;                                           // Removes a dropped dbi
 
   public:
     explicit Environment(const DatabaseConfig& config);
@@ -153,6 +168,16 @@ class Environment {
     std::unique_ptr<Transaction> begin_transaction(unsigned int flags = 0);
     std::unique_ptr<Transaction> begin_ro_transaction(unsigned int flags = 0);
     std::unique_ptr<Transaction> begin_rw_transaction(unsigned int flags = 0);
+
+    /*
+     * Begins a ro transaction reusing, when the env is opened with MDB_NOTLS, an MDB_txn handle previously
+     * released to the pool through mdb_txn_reset/mdb_txn_renew. This saves the allocation of a new handle &
+     * of a reader slot, and is meant for short lookups. On end (commit or abort) the handle goes back to the
+     * pool, up to kMaxPooledRoTxns of them, each of which keeps its reader slot.
+     */
+    std::unique_ptr<Transaction> begin_pooled_ro_transaction();
+
+    static constexpr size_t kMaxPooledRoTxns{16};
 };
 
 /**
@@ -162,11 +187,13 @@ class Transaction {
   private:
     static MDB_txn* open_transaction(Environment* parent_env, MDB_txn* parent_txn, unsigned int flags = 0);
 
+    friend class Environment;
     friend class Table;
 
-    Environment* parent_env_;  // Pointer to env this transaction belongs to
+    Environment* parent_env_;  // Pointer to env this transaction belongs to (null if wrapping an external handle)
     MDB_txn* handle_;          // This transaction lmdb handle
     unsigned int flags_;       // Flags this transaction has been opened with
+    bool pooled_;              // Whether the handle goes back to the parent env's pool on end
 
     /*
      * A dbi is an unsigned int handle to a table in database.
@@ -176,26 +203,38 @@ class Transaction {
      * apparently not needed.
      * Key -> the name of the named db
      * Val -> the MDB_dbi handle
+     *
+     * A handle opened by mdb_dbi_open stays private to its transaction until
+     * the transaction commits, and is closed if it aborts (see mdb_dbis_update).
+     * So dbis opened here are only handed over to the env cache on commit,
+     * and other transactions then skip mdb_dbi_open altogether.
      */
+    std::map<std::string, MDB_dbi, std::less<>> dbis_;      // Dbis in use by this transaction
+    std::vector<std::pair<std::string, MDB_dbi>> new_dbis_;  // Dbis opened by this transaction
+
+    MDB_dbi open_dbi(const char* name, unsigned int flags = 0);
+    MDB_dbi get_dbi(const TableConfig& config, unsigned int flags);  // Cached or newly opened dbi
 
     /*
-     * Andrea Lanfranchi
-     * I originally created a map of opened dbi(s) to persist the binding
-     * of a table name with its handle_. This however is incorrect as the
-     * handle_ is not an ordinal position rather an opened "slot" within
-     * the transaction. LMDB already takes care to keep a list of free
-     * slots to use for opening so this additional map is totally
-     * redundant. See for reference
-     * https://github.com/torquem-ch/lmdb/blob/mdb.master/libraries/liblmdb/mdb.c#L10797-L10810
-     * Keep the following line commented for reference
+     * Cursors of the tables closed (destroyed) while this transaction is alive are kept here
+     * and handed over to the next table opened on the same dbi, sparing mdb_cursor_open/close
+     * on every open. Shared with the tables, which may outlive the transaction.
      */
-    // std::map<std::string, MDB_dbi> dbis_;  // Collection of opened MDB_dbi
+    struct CursorPool {
+        bool open{true};                                       // Whether the transaction is still alive
+        std::vector<std::pair<MDB_dbi, MDB_cursor*>> idle{};  // Cursors ready for reuse
+    };
+    std::shared_ptr<CursorPool> cursor_pool_;
 
-    MDB_dbi open_dbi(const char* name, unsigned int flags = 0);
+    MDB_cursor* acquire_cursor(MDB_dbi dbi);  // Pops an idle cursor on dbi, if any, or opens a new one
+    void close_cursors() noexcept;            // Closes the idle cursors, before the transaction ends
+    void close_cursors(MDB_dbi dbi) noexcept;  // Closes the idle cursors on a dropped dbi
+
+    void untrack(void) noexcept;  // Stops counting this transaction as opened in the parent env (if any)
 
   public:
     explicit Transaction(Environment* parent, unsigned int flags = 0);
-    Transaction(Environment* parent, MDB_txn* txn, unsigned int flags);
+    Transaction(Environment* parent, MDB_txn* txn, unsigned int flags, bool pooled = false);
     ~Transaction();
 
     MDB_txn** handle() { return &handle_; }
@@ -224,6 +263,10 @@ class Transaction {
 
     void abort(void);
     int commit(void);
+
+    // Closes the idle cursors and hands the handle over to the caller, leaving this transaction ended.
+    // Meant for transactions wrapping an external handle, which is not theirs to abort nor commit.
+    MDB_txn* release(void) noexcept;
 };
 
 /**
@@ -383,6 +426,8 @@ class Table {
     bool is_opened(void) { return handle_ != nullptr; }
 
   private:
+    friend class Transaction;
+
     static MDB_cursor* open_cursor(Transaction* parent, MDB_dbi dbi);
     Table(Transaction* parent, MDB_dbi dbi, const char* name, MDB_cursor* cursor);
 
@@ -394,6 +439,8 @@ class Table {
     std::string name_;         // The name of the dbi
     bool dbi_dropped_{false};  // Whether or not this table has been dropped
     MDB_cursor* handle_;       // The underlying MDB_cursor for this instance
+    bool positioned_{false};   // Whether the cursor has been positioned by this instance (it may be a reused one)
+    std::shared_ptr<Transaction::CursorPool> cursor_pool_;  // Where the cursor goes back on close
 };
 
 std::shared_ptr<Environment> get_env(DatabaseConfig config);
@@ -0,0 +1,182 @@
+/*
+   Copyright 2020-2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "chaindb.hpp"
+
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+#include <silkworm/common/temp_dir.hpp>
+
+#include "tables.hpp"
+
+namespace silkworm::lmdb {
+
+TEST_CASE("Transaction counts are per thread & per env") {
+    TemporaryDirectory tmp_dir1;
+    TemporaryDirectory tmp_dir2;
+    DatabaseConfig db_config1{tmp_dir1.path(), 32 * kMebi};
+    DatabaseConfig db_config2{tmp_dir2.path(), 32 * kMebi};
+    db_config1.set_readonly(false);
+    db_config2.set_readonly(false);
+    auto env1{get_env(db_config1)};
+    auto env2{get_env(db_config2)};
+
+    auto txn1{env1->begin_rw_transaction()};
+    CHECK_THROWS_AS(env1->begin_ro_transaction(), std::runtime_error);
+    CHECK_THROWS_AS(env1->begin_pooled_ro_transaction(), std::runtime_error);
+
+    // Another env
+    CHECK_NOTHROW(env2->begin_rw_transaction());
+
+    // Another thread
+    bool opened{false};
+    std::thread reader{[&env1, &opened] {
+        auto txn{env1->begin_ro_transaction()};
+        opened = *txn->handle() != nullptr;
+    }};
+    reader.join();
+    CHECK(opened);
+
+    lmdb::err_handler(txn1->commit());
+    CHECK_NOTHROW(env1->begin_ro_transaction());
+}
+
+TEST_CASE("Pooled ro transactions") {
+    TemporaryDirectory tmp_dir;
+    DatabaseConfig db_config{tmp_dir.path(), 32 * kMebi};
+    db_config.set_readonly(false);
+    auto env{get_env(db_config)};
+
+    auto rw_txn{env->begin_rw_transaction()};
+    db::table::create_all(*rw_txn);
+    rw_txn->open(db::table::kConfig)->put(*from_hex("01"), *from_hex("aa"));
+    lmdb::err_handler(rw_txn->commit());
+
+    auto txn{env->begin_pooled_ro_transaction()};
+    const MDB_txn* handle{*txn->handle()};
+    CHECK(txn->open(db::table::kConfig)->get(*from_hex("01")) == from_hex("aa"));
+    CHECK(txn->commit() == MDB_SUCCESS);
+
+    // The handle is renewed & sees later commits
+    rw_txn = env->begin_rw_transaction();
+    rw_txn->open(db::table::kConfig)->put(*from_hex("01"), *from_hex("bb"));
+    lmdb::err_handler(rw_txn->commit());
+
+    txn = env->begin_pooled_ro_transaction();
+    CHECK(*txn->handle() == handle);
+    CHECK(txn->open(db::table::kConfig)->get(*from_hex("01")) == from_hex("bb"));
+
+    // Concurrent ones get their own handle
+    auto txn2{env->begin_pooled_ro_transaction()};
+    CHECK(*txn2->handle() != handle);
+    txn2.reset();
+    txn.reset();
+
+    // Excess handles are not kept
+    std::vector<std::unique_ptr<Transaction>> txns;
+    for (size_t i{0}; i < Environment::kMaxPooledRoTxns + 4; ++i) {
+        txns.push_back(env->begin_pooled_ro_transaction());
+    }
+    txns.clear();
+    CHECK_NOTHROW(env->close());
+}
+
+TEST_CASE("Cursor reuse & dbi cache") {
+    TemporaryDirectory tmp_dir;
+    DatabaseConfig db_config{tmp_dir.path(), 32 * kMebi};
+    db_config.set_readonly(false);
+    auto env{get_env(db_config)};
+
+    static constexpr TableConfig kTable{"Test"};
+
+    auto old_txn{env->begin_ro_transaction()};
+
+    auto txn{env->begin_rw_transaction()};
+    auto table{txn->open(kTable, MDB_CREATE)};
+    for (const char* key : {"01", "02", "03"}) {
+        table->put(*from_hex(key), *from_hex("ff"));
+    }
+    CHECK(table->seek(*from_hex("03"))->key == *from_hex("03"));
+    table.reset();
+
+    // The cursor of the previous table starts over
+    table = txn->open(kTable);
+    std::optional<db::Entry> entry{table->get_next()};
+    REQUIRE(entry);
+    CHECK(entry->key == *from_hex("01"));
+    MDB_val key;
+    MDB_val data;
+    table.reset();
+    table = txn->open(kTable);
+    CHECK(table->get_current(&key, &data) == EINVAL);
+    CHECK(table->get_prev(&key, &data) == MDB_SUCCESS);
+    CHECK(db::from_mdb_val(key) == *from_hex("03"));
+
+    // Several tables on the same dbi at once
+    auto table2{txn->open(kTable)};
+    CHECK(table2->seek(*from_hex("02"))->key == *from_hex("02"));
+    CHECK(table->get_current(&key, &data) == MDB_SUCCESS);
+    CHECK(db::from_mdb_val(key) == *from_hex("03"));
+    table.reset();
+    table2.reset();
+    lmdb::err_handler(txn->commit());
+
+    // Cached dbi
+    txn = env->begin_ro_transaction();
+    CHECK(txn->open(kTable)->get(*from_hex("02")) == *from_hex("ff"));
+
+    // Transactions predating the table don't see it
+    CHECK_THROWS_AS(old_txn->open(kTable), lmdb::exception);
+
+    // Cursors may outlive their transaction
+    table = txn->open(kTable);
+    txn->abort();
+    table.reset();
+}
+
+TEST_CASE("Transaction wrapping an external handle") {
+    TemporaryDirectory tmp_dir;
+    DatabaseConfig db_config{tmp_dir.path(), 32 * kMebi};
+    db_config.set_readonly(false);
+    auto env{get_env(db_config)};
+
+    static constexpr TableConfig kTable{"Test"};
+
+    MDB_txn* handle{nullptr};
+    lmdb::err_handler(mdb_txn_begin(*env->handle(), nullptr, 0, &handle));
+    {
+        Transaction txn{/*parent=*/nullptr, handle, /*flags=*/0};
+        auto table{txn.open(kTable, MDB_CREATE)};
+        table->put(*from_hex("01"), *from_hex("ff"));
+        table.reset();
+        table = txn.open(kTable);
+        CHECK(table->get(*from_hex("01")) == *from_hex("ff"));
+        table.reset();
+
+        // The handle is the caller's to commit
+        CHECK(txn.release() == handle);
+        CHECK(*txn.handle() == nullptr);
+    }
+    lmdb::err_handler(mdb_txn_commit(handle));
+
+    auto txn{env->begin_ro_transaction()};
+    CHECK(txn->open(kTable)->get(*from_hex("01")) == *from_hex("ff"));
+}
+
+}  // namespace silkworm::lmdb
@@ -0,0 +1,212 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "history.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include <boost/endian/conversion.hpp>
+
+#include <silkworm/common/util.hpp>
+
+#include "access_layer.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+static size_t combine_hashes(size_t h, size_t other) {
+    return h ^ (other + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2));
+}
+
+size_t HistoricalStateReader::StorageSlotHash::operator()(const StorageSlot& slot) const noexcept {
+    return combine_hashes(std::hash<evmc::bytes32>{}(slot.location), std::hash<evmc::address>{}(slot.address));
+}
+
+size_t HistoricalStateReader::AccountChangeHash::operator()(const AccountChange& change) const noexcept {
+    return combine_hashes(std::hash<evmc::address>{}(change.address), std::hash<uint64_t>{}(change.block_number));
+}
+
+size_t HistoricalStateReader::StorageChangeHash::operator()(const StorageChange& change) const noexcept {
+    size_t h{std::hash<evmc::bytes32>{}(change.location)};
+    h = combine_hashes(h, std::hash<evmc::address>{}(change.address));
+    h = combine_hashes(h, std::hash<uint64_t>{}(change.incarnation));
+    return combine_hashes(h, std::hash<uint64_t>{}(change.block_number));
+}
+
+HistoricalStateReader::HistoricalStateReader(lmdb::Transaction& txn, size_t max_bitmaps, size_t max_changes)
+    : account_history_{txn.open(table::kAccountHistory)},
+      storage_history_{txn.open(table::kStorageHistory)},
+      account_changes_{txn.open(table::kPlainAccountChangeSet)},
+      storage_changes_{txn.open(table::kPlainStorageChangeSet)},
+      plain_state_{txn.open(table::kPlainState)},
+      contract_code_{txn.open(table::kPlainContractCode)},
+      account_chunks_{max_bitmaps},
+      storage_chunks_{max_bitmaps},
+      account_values_{max_changes},
+      storage_values_{max_changes} {}
+
+template <typename Key, typename Hash>
+std::optional<uint64_t> HistoricalStateReader::find_change(lmdb::Table& history,
+                                                           lru_cache<Key, HistoryChunk, Hash>& chunks, const Key& key,
+                                                           ByteView entity, uint64_t block_number) {
+    if (const HistoryChunk* chunk{chunks.get(key)};
+        chunk && chunk->first_block <= block_number && block_number <= chunk->last_block) {
+        ++stats_.bitmap_hits;
+        return bitmap::seek(chunk->bitmap, block_number);
+    }
+    ++stats_.bitmap_misses;
+
+    const size_t key_length{entity.length() + sizeof(uint64_t)};
+    auto is_chunk_key{[&](ByteView k) { return k.length() == key_length && has_prefix(k, entity); }};
+
+    Bytes seek_key(entity);
+    seek_key.resize(key_length);
+    boost::endian::store_big_u64(&seek_key[entity.length()], block_number);
+
+    // Chunks are keyed by the highest block they may hold, the last one by UINT64_MAX; if the
+    // entity has no chunk past block_number, the empty range after its last one is cached instead
+    HistoryChunk chunk;
+    chunk.last_block = UINT64_MAX;
+    std::optional<Entry> entry{history.seek(seek_key)};
+    if (entry && is_chunk_key(entry->key)) {
+        chunk.last_block = boost::endian::load_big_u64(&entry->key[entity.length()]);
+        chunk.bitmap = bitmap::read(entry->value);
+    }
+
+    // The range starts right after the previous chunk of the entity, if any
+    MDB_val mdb_key{}, mdb_data{};
+    const int rc{entry ? history.get_prev(&mdb_key, &mdb_data) : history.get_last(&mdb_key, &mdb_data)};
+    if (rc != MDB_NOTFOUND) {
+        lmdb::err_handler(rc);
+        const ByteView prev_key{from_mdb_val(mdb_key)};
+        if (is_chunk_key(prev_key)) {
+            chunk.first_block = boost::endian::load_big_u64(&prev_key[entity.length()]) + 1;
+        }
+    }
+
+    std::optional<uint64_t> change_block{bitmap::seek(chunk.bitmap, block_number)};
+    chunks.put(key, std::move(chunk));
+    return change_block;
+}
+
+std::optional<Account> HistoricalStateReader::decode_account(ByteView encoded, const evmc::address& address) {
+    if (encoded.empty()) {
+        return std::nullopt;
+    }
+
+    auto [acc, err]{decode_account_from_storage(encoded)};
+    rlp::err_handler(err);
+
+    if (acc.incarnation > 0 && acc.code_hash == kEmptyHash) {
+        // restore code hash
+        std::optional<ByteView> hash{contract_code_->get(storage_prefix(full_view(address), acc.incarnation))};
+        if (hash && hash->length() == kHashLength) {
+            std::memcpy(acc.code_hash.bytes, hash->data(), kHashLength);
+        }
+    }
+
+    return acc;
+}
+
+std::optional<Account> HistoricalStateReader::read_account(const evmc::address& address, uint64_t block_number) {
+    const std::optional<uint64_t> change_block{
+        find_change(*account_history_, account_chunks_, address, full_view(address), block_number)};
+    if (change_block) {
+        const AccountChange change_key{address, *change_block};
+        if (const std::optional<Account>* cached{account_values_.get(change_key)}) {
+            ++stats_.change_hits;
+            return *cached;
+        }
+        ++stats_.change_misses;
+        if (std::optional<ByteView> encoded{account_changes_->get(block_key(*change_block), full_view(address))}) {
+            std::optional<Account> account{decode_account(*encoded, address)};
+            account_values_.put(change_key, account);
+            return account;
+        }
+    }
+
+    std::optional<ByteView> encoded{plain_state_->get(full_view(address))};
+    return encoded ? decode_account(*encoded, address) : std::nullopt;
+}
+
+evmc::bytes32 HistoricalStateReader::read_storage(const evmc::address& address, uint64_t incarnation,
+                                                  const evmc::bytes32& location, uint64_t block_number) {
+    uint8_t entity[kAddressLength + kHashLength];
+    std::memcpy(entity, address.bytes, kAddressLength);
+    std::memcpy(&entity[kAddressLength], location.bytes, kHashLength);
+
+    std::optional<ByteView> val;
+    const StorageSlot slot{address, location};
+    const std::optional<uint64_t> change_block{
+        find_change(*storage_history_, storage_chunks_, slot, full_view(entity), block_number)};
+    if (change_block) {
+        const StorageChange change_key{address, incarnation, location, *change_block};
+        if (const evmc::bytes32* cached{storage_values_.get(change_key)}) {
+            ++stats_.change_hits;
+            return *cached;
+        }
+        ++stats_.change_misses;
+        val = storage_changes_->get(storage_change_key(*change_block, address, incarnation), full_view(location));
+        if (val) {
+            evmc::bytes32 value{};
+            std::memcpy(value.bytes + kHashLength - val->length(), val->data(), val->length());
+            storage_values_.put(change_key, value);
+            return value;
+        }
+    }
+
+    val = plain_state_->get(storage_prefix(full_view(address), incarnation), full_view(location));
+    evmc::bytes32 value{};
+    if (val) {
+        std::memcpy(value.bytes + kHashLength - val->length(), val->data(), val->length());
+    }
+    return value;
+}
+
+// Indices of keys in ascending order
+template <typename T>
+static std::vector<size_t> sorted_indices(const std::vector<T>& keys) {
+    std::vector<size_t> indices(keys.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::sort(indices.begin(), indices.end(), [&keys](size_t a, size_t b) {
+        return std::memcmp(keys[a].bytes, keys[b].bytes, sizeof(keys[a].bytes)) < 0;
+    });
+    return indices;
+}
+
+std::vector<std::optional<Account>> HistoricalStateReader::read_accounts(const std::vector<evmc::address>& addresses,
+                                                                         uint64_t block_number) {
+    std::vector<std::optional<Account>> accounts(addresses.size());
+    for (size_t i : sorted_indices(addresses)) {
+        accounts[i] = read_account(addresses[i], block_number);
+    }
+    return accounts;
+}
+
+std::vector<evmc::bytes32> HistoricalStateReader::read_storage(const evmc::address& address, uint64_t incarnation,
+                                                               const std::vector<evmc::bytes32>& locations,
+                                                               uint64_t block_number) {
+    std::vector<evmc::bytes32> values(locations.size());
+    for (size_t i : sorted_indices(locations)) {
+        values[i] = read_storage(address, incarnation, locations[i], block_number);
+    }
+    return values;
+}
+
+}  // namespace silkworm::db
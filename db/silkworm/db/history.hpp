@@ -0,0 +1,156 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_HISTORY_HPP_
+#define SILKWORM_DB_HISTORY_HPP_
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <silkworm/common/base.hpp>
+#include <silkworm/common/clock_cache.hpp>
+#include <silkworm/common/lru_cache.hpp>
+#include <silkworm/db/bitmap.hpp>
+#include <silkworm/db/chaindb.hpp>
+#include <silkworm/types/account.hpp>
+
+namespace silkworm::db {
+
+/*
+ * Reads the plain state as of the beginning of a given block (see TG FindByHistory).
+ *
+ * Same as db::read_account & db::read_storage with a block number, but tables are opened once and
+ * decoded history bitmap chunks are kept in an LRU cache together with the range of blocks each covers,
+ * so that further queries of a hot account or storage slot within that range need neither a history
+ * table seek nor bitmap deserialization. Values found in change sets are cached as well.
+ *
+ * Batched overloads read many keys at the same block in key order, keeping cursor moves mostly forward.
+ *
+ * Caches are only valid as long as history & change set tables don't change (e.g. within a read-only
+ * transaction or while only reading historical state).
+ */
+class HistoricalStateReader {
+  public:
+    static constexpr size_t kDefaultMaxBitmaps{10'000};
+    static constexpr size_t kDefaultMaxChanges{100'000};
+
+    struct Stats {
+        uint64_t bitmap_hits{0};
+        uint64_t bitmap_misses{0};
+        uint64_t change_hits{0};
+        uint64_t change_misses{0};
+    };
+
+    // max_bitmaps is the number of cached bitmap chunks, max_changes the number of cached change set values
+    explicit HistoricalStateReader(lmdb::Transaction& txn, size_t max_bitmaps = kDefaultMaxBitmaps,
+                                   size_t max_changes = kDefaultMaxChanges);
+
+    HistoricalStateReader(const HistoricalStateReader&) = delete;
+    HistoricalStateReader& operator=(const HistoricalStateReader&) = delete;
+
+    std::optional<Account> read_account(const evmc::address& address, uint64_t block_number);
+
+    evmc::bytes32 read_storage(const evmc::address& address, uint64_t incarnation, const evmc::bytes32& location,
+                               uint64_t block_number);
+
+    // Point-in-time reads of many accounts; results are in the same order as addresses
+    std::vector<std::optional<Account>> read_accounts(const std::vector<evmc::address>& addresses,
+                                                      uint64_t block_number);
+
+    // Point-in-time reads of many storage slots of a contract; results are in the same order as locations
+    std::vector<evmc::bytes32> read_storage(const evmc::address& address, uint64_t incarnation,
+                                            const std::vector<evmc::bytes32>& locations, uint64_t block_number);
+
+    const Stats& stats() const noexcept { return stats_; }
+
+  private:
+    // Decoded history bitmap chunk of an account or storage slot along with the blocks it covers, i.e.
+    // a query at any block in [first_block, last_block] is answered by this chunk.
+    // An empty bitmap means no change at all within that range.
+    struct HistoryChunk {
+        uint64_t first_block{0};
+        uint64_t last_block{0};
+        roaring::Roaring64Map bitmap;
+    };
+
+    struct StorageSlot {
+        evmc::address address;
+        evmc::bytes32 location;
+
+        friend bool operator==(const StorageSlot& a, const StorageSlot& b) {
+            return a.address == b.address && a.location == b.location;
+        }
+    };
+
+    struct StorageSlotHash {
+        size_t operator()(const StorageSlot& slot) const noexcept;
+    };
+
+    struct AccountChange {
+        evmc::address address;
+        uint64_t block_number{0};
+
+        friend bool operator==(const AccountChange& a, const AccountChange& b) {
+            return a.address == b.address && a.block_number == b.block_number;
+        }
+    };
+
+    struct AccountChangeHash {
+        size_t operator()(const AccountChange& change) const noexcept;
+    };
+
+    struct StorageChange {
+        evmc::address address;
+        uint64_t incarnation{0};
+        evmc::bytes32 location;
+        uint64_t block_number{0};
+
+        friend bool operator==(const StorageChange& a, const StorageChange& b) {
+            return a.address == b.address && a.incarnation == b.incarnation && a.location == b.location &&
+                   a.block_number == b.block_number;
+        }
+    };
+
+    struct StorageChangeHash {
+        size_t operator()(const StorageChange& change) const noexcept;
+    };
+
+    // Block of the first change of the entity (history key prefix) at or after block_number, if any
+    template <typename Key, typename Hash>
+    std::optional<uint64_t> find_change(lmdb::Table& history, lru_cache<Key, HistoryChunk, Hash>& chunks,
+                                        const Key& key, ByteView entity, uint64_t block_number);
+
+    std::optional<Account> decode_account(ByteView encoded, const evmc::address& address);
+
+    std::unique_ptr<lmdb::Table> account_history_;
+    std::unique_ptr<lmdb::Table> storage_history_;
+    std::unique_ptr<lmdb::Table> account_changes_;
+    std::unique_ptr<lmdb::Table> storage_changes_;
+    std::unique_ptr<lmdb::Table> plain_state_;
+    std::unique_ptr<lmdb::Table> contract_code_;
+
+    lru_cache<evmc::address, HistoryChunk> account_chunks_;
+    lru_cache<StorageSlot, HistoryChunk, StorageSlotHash> storage_chunks_;
+    ClockCache<AccountChange, std::optional<Account>, AccountChangeHash> account_values_;
+    ClockCache<StorageChange, evmc::bytes32, StorageChangeHash> storage_values_;
+
+    Stats stats_;
+};
+
+}  // namespace silkworm::db
+
+#endif  // SILKWORM_DB_HISTORY_HPP_
@@ -0,0 +1,159 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "history.hpp"
+
+#include <boost/endian/conversion.hpp>
+#include <catch2/catch.hpp>
+
+#include <silkworm/common/cast.hpp>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/common/util.hpp>
+
+#include "access_layer.hpp"
+#include "buffer.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+static Bytes serialize(const roaring::Roaring64Map& bitmap) {
+    Bytes out(bitmap.getSizeInBytes(), '\0');
+    bitmap.write(byte_ptr_cast(out.data()));
+    return out;
+}
+
+static Bytes history_key(ByteView entity, uint64_t chunk_upper_bound) {
+    Bytes key(entity);
+    key.resize(entity.length() + 8);
+    boost::endian::store_big_u64(&key[entity.length()], chunk_upper_bound);
+    return key;
+}
+
+TEST_CASE("Historical state reader") {
+    TemporaryDirectory tmp_dir;
+
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 * kMebi};
+    db_config.set_readonly(false);
+    auto env{lmdb::get_env(db_config)};
+    auto txn{env->begin_rw_transaction()};
+    table::create_all(*txn);
+
+    const auto address{0xbe00000000000000000000000000000000000000_address};
+    const auto untouched{0xbf00000000000000000000000000000000000000_address};
+    const auto location{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+    const uint64_t incarnation{1};
+
+    auto account_with_balance{[](uint64_t balance) {
+        Account account;
+        account.balance = balance;
+        account.incarnation = 1;
+        return account;
+    }};
+
+    // Account changed at blocks 3 & 7 (first chunk) and 12 & 20 (last chunk),
+    // i.e. its balance was n at the beginning of the n-th change
+    auto history{txn->open(table::kAccountHistory)};
+    auto account_changes{txn->open(table::kPlainAccountChangeSet)};
+    const std::vector<uint64_t> change_blocks{3, 7, 12, 20};
+    roaring::Roaring64Map first_chunk, last_chunk;
+    for (size_t i{0}; i < change_blocks.size(); ++i) {
+        (i < 2 ? first_chunk : last_chunk).add(change_blocks[i]);
+        Bytes value(full_view(address));
+        value.append(account_with_balance(i + 1).encode_for_storage());
+        account_changes->put(block_key(change_blocks[i]), value);
+    }
+    history->put(history_key(full_view(address), 7), serialize(first_chunk));
+    history->put(history_key(full_view(address), UINT64_MAX), serialize(last_chunk));
+
+    // Storage slot changed at block 12 only
+    Bytes slot_entity(full_view(address));
+    slot_entity.append(full_view(location));
+    roaring::Roaring64Map slot_chunk;
+    slot_chunk.add(12);
+    txn->open(table::kStorageHistory)->put(history_key(slot_entity, UINT64_MAX), serialize(slot_chunk));
+    Bytes slot_change(full_view(location));
+    slot_change.push_back(0x0a);
+    txn->open(table::kPlainStorageChangeSet)->put(storage_change_key(12, address, incarnation), slot_change);
+
+    // Current state
+    auto plain_state{txn->open(table::kPlainState)};
+    plain_state->put(full_view(address), account_with_balance(5).encode_for_storage());
+    plain_state->put(full_view(untouched), account_with_balance(100).encode_for_storage());
+    Bytes slot_value(full_view(location));
+    slot_value.push_back(0x0b);
+    plain_state->put(storage_prefix(full_view(address), incarnation), slot_value);
+
+    auto expected_balance{[](uint64_t block_number) -> uint64_t {
+        if (block_number <= 3) {
+            return 1;
+        } else if (block_number <= 7) {
+            return 2;
+        } else if (block_number <= 12) {
+            return 3;
+        } else if (block_number <= 20) {
+            return 4;
+        }
+        return 5;
+    }};
+
+    HistoricalStateReader reader{*txn};
+
+    for (int pass{0}; pass < 2; ++pass) {
+        for (uint64_t block_number{0}; block_number <= 25; ++block_number) {
+            std::optional<Account> account{reader.read_account(address, block_number)};
+            REQUIRE(account);
+            CHECK(account->balance == expected_balance(block_number));
+            CHECK(account == read_account(*txn, address, block_number));
+
+            CHECK(reader.read_account(untouched, block_number) == account_with_balance(100));
+
+            const evmc::bytes32 value{reader.read_storage(address, incarnation, location, block_number)};
+            CHECK(value == to_bytes32(block_number <= 12 ? *from_hex("0a") : *from_hex("0b")));
+            CHECK(value == read_storage(*txn, address, incarnation, location, block_number));
+        }
+    }
+
+    // Only the first query within each chunk range goes to the database:
+    // 2 chunks of address, the empty range of untouched & the single chunk of the storage slot
+    const HistoricalStateReader::Stats& stats{reader.stats()};
+    CHECK(stats.bitmap_misses == 4);
+    CHECK(stats.bitmap_hits == 3 * 2 * 26 - stats.bitmap_misses);
+    CHECK(stats.change_misses == change_blocks.size() + 1);
+
+    SECTION("Batched reads") {
+        const std::vector<evmc::address> addresses{untouched, address, untouched};
+        std::vector<std::optional<Account>> accounts{reader.read_accounts(addresses, 10)};
+        REQUIRE(accounts.size() == 3);
+        CHECK(accounts[0] == account_with_balance(100));
+        CHECK(accounts[1] == account_with_balance(3));
+        CHECK(accounts[2] == account_with_balance(100));
+
+        const auto other_location{0x0000000000000000000000000000000000000000000000000000000000000002_bytes32};
+        std::vector<evmc::bytes32> values{reader.read_storage(address, incarnation, {other_location, location}, 10)};
+        REQUIRE(values.size() == 2);
+        CHECK(values[0] == evmc::bytes32{});
+        CHECK(values[1] == to_bytes32(*from_hex("0a")));
+    }
+
+    SECTION("Historical buffer") {
+        Buffer buffer{txn.get(), /*historical_block=*/8};
+        CHECK(buffer.read_account(address) == account_with_balance(3));
+        CHECK(buffer.read_storage(address, incarnation, location) == to_bytes32(*from_hex("0a")));
+    }
+}
+
+}  // namespace silkworm::db
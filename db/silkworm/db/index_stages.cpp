@@ -0,0 +1,203 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "index_stages.hpp"
+
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+#include <boost/endian/conversion.hpp>
+
+#include <silkworm/common/util.hpp>
+#include <silkworm/types/log_cbor.hpp>
+
+#include "bitmap.hpp"
+#include "stages.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+constexpr size_t kBitmapBufferSizeLimit = 256 * kMebi;
+
+// Calls f(block_number, entry) for the entries of a table keyed by block number first, within [from, to]
+template <typename F>
+static void for_each_block_entry(lmdb::Table& table, uint64_t from, uint64_t to, F f) {
+    for (auto entry{table.seek(block_key(from))}; entry; entry = table.get_next()) {
+        const uint64_t block_number{boost::endian::load_big_u64(entry->key.data())};
+        if (block_number > to) {
+            break;
+        }
+        f(block_number, *entry);
+    }
+}
+
+// Account change set: block -> address + account; storage change set: block + address + incarnation -> location + value
+static Bytes history_key(bool storage, const Entry& change) {
+    if (!storage) {
+        return Bytes{change.value.substr(0, kAddressLength)};
+    }
+    Bytes key{change.key.substr(sizeof(uint64_t), kAddressLength)};
+    key.append(change.value.substr(0, kHashLength));
+    return key;
+}
+
+static const std::vector<Log>& decode_logs(uint64_t block_number, ByteView encoded, std::vector<Log>& logs) {
+    logs.clear();
+    if (!cbor_decode(encoded, logs)) {
+        throw std::runtime_error("Invalid CBOR logs at block " + std::to_string(block_number));
+    }
+    return logs;
+}
+
+template <typename Bitmap>
+static void flush_bitmaps(lmdb::Table& index, std::map<Bytes, Bitmap>& bitmaps) {
+    for (auto& [key, bitmap] : bitmaps) {
+        bitmap::append(index, key, std::move(bitmap));
+    }
+    bitmaps.clear();
+}
+
+uint64_t update_history_index(lmdb::Transaction& txn, bool storage) {
+    const char* stage_key{storage ? stages::kStorageHistoryIndexKey : stages::kAccountHistoryKey};
+    const uint64_t progress{stages::get_stage_progress(txn, stage_key)};
+    const uint64_t to{stages::get_stage_progress(txn, stages::kExecutionKey)};
+    if (to <= progress) {
+        return progress;
+    }
+
+    auto changes{txn.open(storage ? table::kPlainStorageChangeSet : table::kPlainAccountChangeSet)};
+    auto index{txn.open(storage ? table::kStorageHistory : table::kAccountHistory)};
+
+    std::map<Bytes, roaring::Roaring64Map> bitmaps;
+    size_t allocated_space{0};
+    for_each_block_entry(*changes, progress + 1, to, [&](uint64_t block_number, const Entry& change) {
+        bitmaps[history_key(storage, change)].add(block_number);
+        allocated_space += sizeof(uint64_t);
+        if (64 * bitmaps.size() + allocated_space > kBitmapBufferSizeLimit) {
+            flush_bitmaps(*index, bitmaps);
+            allocated_space = 0;
+        }
+    });
+    flush_bitmaps(*index, bitmaps);
+
+    stages::set_stage_progress(txn, stage_key, to);
+    return to;
+}
+
+uint64_t unwind_history_index(lmdb::Transaction& txn, bool storage) {
+    const char* stage_key{storage ? stages::kStorageHistoryIndexKey : stages::kAccountHistoryKey};
+    uint64_t progress{stages::get_stage_progress(txn, stage_key)};
+    const uint64_t unwind_point{stages::get_stage_unwind(txn, stage_key)};
+    if (!unwind_point) {
+        return progress;
+    }
+
+    if (unwind_point < progress) {
+        auto changes{txn.open(storage ? table::kPlainStorageChangeSet : table::kPlainAccountChangeSet)};
+        auto index{txn.open(storage ? table::kStorageHistory : table::kAccountHistory)};
+
+        std::set<Bytes> keys;
+        for_each_block_entry(*changes, unwind_point + 1, progress,
+                             [&](uint64_t, const Entry& change) { keys.insert(history_key(storage, change)); });
+        for (const Bytes& key : keys) {
+            bitmap::truncate<roaring::Roaring64Map>(*index, key, unwind_point + 1);
+        }
+
+        progress = unwind_point;
+        stages::set_stage_progress(txn, stage_key, progress);
+    }
+    stages::clear_stage_unwind(txn, stage_key);
+    return progress;
+}
+
+uint64_t update_log_index(lmdb::Transaction& txn) {
+    const uint64_t progress{stages::get_stage_progress(txn, stages::kLogIndexKey)};
+    const uint64_t to{stages::get_stage_progress(txn, stages::kExecutionKey)};
+    if (to <= progress) {
+        return progress;
+    }
+
+    auto log_table{txn.open(table::kLogs)};
+    auto address_index{txn.open(table::kLogAddressIndex)};
+    auto topic_index{txn.open(table::kLogTopicIndex)};
+
+    std::map<Bytes, roaring::Roaring> address_bitmaps;
+    std::map<Bytes, roaring::Roaring> topic_bitmaps;
+    size_t allocated_space{0};
+    std::vector<Log> logs;
+    for_each_block_entry(*log_table, progress + 1, to, [&](uint64_t block_number, const Entry& entry) {
+        for (const Log& log : decode_logs(block_number, entry.value, logs)) {
+            address_bitmaps[Bytes{full_view(log.address)}].add(static_cast<uint32_t>(block_number));
+            allocated_space += kAddressLength;
+            for (const evmc::bytes32& topic : log.topics) {
+                topic_bitmaps[Bytes{full_view(topic)}].add(static_cast<uint32_t>(block_number));
+                allocated_space += kHashLength;
+            }
+        }
+        if (allocated_space > kBitmapBufferSizeLimit) {
+            flush_bitmaps(*address_index, address_bitmaps);
+            flush_bitmaps(*topic_index, topic_bitmaps);
+            allocated_space = 0;
+        }
+    });
+    flush_bitmaps(*address_index, address_bitmaps);
+    flush_bitmaps(*topic_index, topic_bitmaps);
+
+    stages::set_stage_progress(txn, stages::kLogIndexKey, to);
+    return to;
+}
+
+uint64_t unwind_log_index(lmdb::Transaction& txn) {
+    uint64_t progress{stages::get_stage_progress(txn, stages::kLogIndexKey)};
+    const uint64_t unwind_point{stages::get_stage_unwind(txn, stages::kLogIndexKey)};
+    if (!unwind_point) {
+        return progress;
+    }
+
+    if (unwind_point < progress) {
+        auto log_table{txn.open(table::kLogs)};
+        auto address_index{txn.open(table::kLogAddressIndex)};
+        auto topic_index{txn.open(table::kLogTopicIndex)};
+
+        std::set<Bytes> addresses;
+        std::set<Bytes> topics;
+        std::vector<Log> logs;
+        for_each_block_entry(*log_table, unwind_point + 1, progress, [&](uint64_t block_number, const Entry& entry) {
+            for (const Log& log : decode_logs(block_number, entry.value, logs)) {
+                addresses.insert(Bytes{full_view(log.address)});
+                for (const evmc::bytes32& topic : log.topics) {
+                    topics.insert(Bytes{full_view(topic)});
+                }
+            }
+        });
+        for (const Bytes& key : addresses) {
+            bitmap::truncate<roaring::Roaring>(*address_index, key, unwind_point + 1);
+        }
+        for (const Bytes& key : topics) {
+            bitmap::truncate<roaring::Roaring>(*topic_index, key, unwind_point + 1);
+        }
+
+        progress = unwind_point;
+        stages::set_stage_progress(txn, stages::kLogIndexKey, progress);
+    }
+    stages::clear_stage_unwind(txn, stages::kLogIndexKey);
+    return progress;
+}
+
+}  // namespace silkworm::db
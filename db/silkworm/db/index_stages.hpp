@@ -0,0 +1,50 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_INDEX_STAGES_HPP_
+#define SILKWORM_DB_INDEX_STAGES_HPP_
+
+#include <silkworm/db/chaindb.hpp>
+
+/*
+Incremental maintenance of the account & storage history indexes and of the log indexes, driven by
+db::stages progress & unwind points.
+
+Forward: change sets (logs) of the blocks past the stage progress, up to the Execution stage progress,
+are appended to the last chunk of each key touched (see bitmap::append).
+Unwind: the blocks past the stage unwind point are removed from the index of each key touched by them
+(see bitmap::truncate). As in db::stages, an unwind point of 0 means no unwind is pending.
+
+Full (re)builds are better served by the ETL based history_index & log_index tools.
+*/
+
+namespace silkworm::db {
+
+// Returns the new stage progress
+uint64_t update_history_index(lmdb::Transaction& txn, bool storage);
+
+// Returns the new stage progress
+uint64_t unwind_history_index(lmdb::Transaction& txn, bool storage);
+
+// Returns the new stage progress
+uint64_t update_log_index(lmdb::Transaction& txn);
+
+// Returns the new stage progress
+uint64_t unwind_log_index(lmdb::Transaction& txn);
+
+}  // namespace silkworm::db
+
+#endif  // SILKWORM_DB_INDEX_STAGES_HPP_
@@ -0,0 +1,140 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "index_stages.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <silkworm/common/cast.hpp>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/types/log_cbor.hpp>
+
+#include "bitmap.hpp"
+#include "stages.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+// Blocks of the last chunk of an index key
+static std::vector<uint64_t> last_chunk(lmdb::Transaction& txn, const lmdb::TableConfig& index, ByteView key,
+                                        bool log_index = false) {
+    Bytes chunk_key(key);
+    chunk_key.append(log_index ? 4 : 8, '\xff');
+    std::optional<ByteView> value{txn.open(index)->get(chunk_key)};
+    std::vector<uint64_t> out;
+    if (!value) {
+        return out;
+    }
+    if (log_index) {
+        for (uint32_t block_number : roaring::Roaring::readSafe(byte_ptr_cast(value->data()), value->size())) {
+            out.push_back(block_number);
+        }
+    } else {
+        for (uint64_t block_number : bitmap::read(*value)) {
+            out.push_back(block_number);
+        }
+    }
+    return out;
+}
+
+TEST_CASE("History index stage") {
+    TemporaryDirectory tmp_dir;
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 * kMebi};
+    db_config.set_readonly(false);
+    auto env{lmdb::get_env(db_config)};
+    auto txn{env->begin_rw_transaction()};
+    table::create_all(*txn);
+
+    const auto a{0xaa00000000000000000000000000000000000000_address};
+    const auto b{0xbb00000000000000000000000000000000000000_address};
+    const auto location{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+
+    // a changes in every block, b in block 5 only, as well as its storage
+    auto account_changes{txn->open(table::kPlainAccountChangeSet)};
+    auto storage_changes{txn->open(table::kPlainStorageChangeSet)};
+    for (uint64_t block_number{1}; block_number <= 10; ++block_number) {
+        account_changes->put(block_key(block_number), full_view(a));
+    }
+    account_changes->put(block_key(5), full_view(b));
+    Bytes storage_change{full_view(location)};
+    storage_change.push_back(0x01);
+    storage_changes->put(storage_change_key(5, b, 1), storage_change);
+    Bytes storage_key{full_view(b)};
+    storage_key.append(full_view(location));
+
+    stages::set_stage_progress(*txn, stages::kExecutionKey, 6);
+    CHECK(update_history_index(*txn, /*storage=*/false) == 6);
+    CHECK(update_history_index(*txn, /*storage=*/true) == 6);
+    CHECK(last_chunk(*txn, table::kAccountHistory, full_view(a)) == std::vector<uint64_t>{1, 2, 3, 4, 5, 6});
+    CHECK(last_chunk(*txn, table::kAccountHistory, full_view(b)) == std::vector<uint64_t>{5});
+    CHECK(last_chunk(*txn, table::kStorageHistory, storage_key) == std::vector<uint64_t>{5});
+
+    // Only blocks past the stage progress are indexed
+    stages::set_stage_progress(*txn, stages::kExecutionKey, 10);
+    CHECK(update_history_index(*txn, /*storage=*/false) == 10);
+    CHECK(update_history_index(*txn, /*storage=*/false) == 10);
+    CHECK(last_chunk(*txn, table::kAccountHistory, full_view(a)) ==
+          std::vector<uint64_t>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+
+    // No unwind pending
+    CHECK(unwind_history_index(*txn, /*storage=*/false) == 10);
+
+    stages::set_stage_unwind(*txn, stages::kAccountHistoryKey, 4);
+    stages::set_stage_unwind(*txn, stages::kStorageHistoryIndexKey, 4);
+    CHECK(unwind_history_index(*txn, /*storage=*/false) == 4);
+    CHECK(unwind_history_index(*txn, /*storage=*/true) == 4);
+    CHECK(stages::get_stage_unwind(*txn, stages::kAccountHistoryKey) == 0);
+    CHECK(last_chunk(*txn, table::kAccountHistory, full_view(a)) == std::vector<uint64_t>{1, 2, 3, 4});
+    CHECK(last_chunk(*txn, table::kAccountHistory, full_view(b)).empty());
+    CHECK(last_chunk(*txn, table::kStorageHistory, storage_key).empty());
+
+    CHECK(update_history_index(*txn, /*storage=*/false) == 10);
+    CHECK(last_chunk(*txn, table::kAccountHistory, full_view(b)) == std::vector<uint64_t>{5});
+}
+
+TEST_CASE("Log index stage") {
+    TemporaryDirectory tmp_dir;
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 * kMebi};
+    db_config.set_readonly(false);
+    auto env{lmdb::get_env(db_config)};
+    auto txn{env->begin_rw_transaction()};
+    table::create_all(*txn);
+
+    const auto a{0xaa00000000000000000000000000000000000000_address};
+    const auto topic{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+
+    auto log_table{txn->open(table::kLogs)};
+    log_table->put(log_key(2, 0), cbor_encode({Log{a, {topic}, {}}}));
+    log_table->put(log_key(3, 1), cbor_encode({Log{a, {}, {}}}));
+    log_table->put(log_key(7, 0), cbor_encode({Log{a, {topic}, {}}}));
+
+    stages::set_stage_progress(*txn, stages::kExecutionKey, 7);
+    CHECK(update_log_index(*txn) == 7);
+    CHECK(last_chunk(*txn, table::kLogAddressIndex, full_view(a), true) == std::vector<uint64_t>{2, 3, 7});
+    CHECK(last_chunk(*txn, table::kLogTopicIndex, full_view(topic), true) == std::vector<uint64_t>{2, 7});
+
+    stages::set_stage_unwind(*txn, stages::kLogIndexKey, 2);
+    CHECK(unwind_log_index(*txn) == 2);
+    CHECK(last_chunk(*txn, table::kLogAddressIndex, full_view(a), true) == std::vector<uint64_t>{2});
+    CHECK(last_chunk(*txn, table::kLogTopicIndex, full_view(topic), true) == std::vector<uint64_t>{2});
+
+    log_table->put(log_key(7, 0), *from_hex("8301"));
+    CHECK_THROWS_AS(update_log_index(*txn), std::runtime_error);
+}
+
+}  // namespace silkworm::db
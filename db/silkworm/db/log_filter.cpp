@@ -0,0 +1,169 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "log_filter.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include <boost/endian/conversion.hpp>
+
+#include <silkworm/common/cast.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/types/log_cbor.hpp>
+
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+bool LogFilter::has_criteria() const {
+    return !addresses.empty() ||
+           std::any_of(topics.begin(), topics.end(), [](const auto& values) { return !values.empty(); });
+}
+
+bool LogFilter::matches(const Log& log) const {
+    if (!addresses.empty() && std::find(addresses.begin(), addresses.end(), log.address) == addresses.end()) {
+        return false;
+    }
+    if (log.topics.size() < topics.size()) {
+        return false;
+    }
+    for (size_t i{0}; i < topics.size(); ++i) {
+        if (!topics[i].empty() && std::find(topics[i].begin(), topics[i].end(), log.topics[i]) == topics[i].end()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Appends the bitmap chunks of key overlapping [from, to]
+static void read_chunks(lmdb::Table& index, ByteView key, uint32_t from, uint32_t to,
+                        std::vector<roaring::Roaring>& chunks) {
+    Bytes seek_key(key);
+    seek_key.resize(key.length() + sizeof(uint32_t));
+    boost::endian::store_big_u32(&seek_key[key.length()], from);
+
+    for (auto entry{index.seek(seek_key)}; entry; entry = index.get_next()) {
+        if (entry->key.length() != seek_key.length() || !has_prefix(entry->key, key)) {
+            break;
+        }
+        chunks.push_back(roaring::Roaring::readSafe(byte_ptr_cast(entry->value.data()), entry->value.size()));
+        if (boost::endian::load_big_u32(&entry->key[key.length()]) >= to) {
+            break;
+        }
+    }
+}
+
+// Blocks holding logs with any of the keys
+template <typename T>
+static roaring::Roaring any_of(lmdb::Table& index, const std::vector<T>& keys, uint32_t from, uint32_t to) {
+    std::vector<roaring::Roaring> chunks;
+    for (const T& key : keys) {
+        read_chunks(index, full_view(key), from, to, chunks);
+    }
+    std::vector<const roaring::Roaring*> inputs(chunks.size());
+    std::transform(chunks.begin(), chunks.end(), inputs.begin(), [](const auto& chunk) { return &chunk; });
+    return roaring::Roaring::fastunion(inputs.size(), inputs.data());
+}
+
+std::optional<roaring::Roaring> matching_blocks(lmdb::Transaction& txn, const LogFilter& filter) {
+    if (!filter.has_criteria()) {
+        return std::nullopt;
+    }
+
+    roaring::Roaring blocks;
+    if (filter.from_block > filter.to_block || filter.from_block > UINT32_MAX) {
+        return blocks;
+    }
+    const auto from{static_cast<uint32_t>(filter.from_block)};
+    const auto to{static_cast<uint32_t>(std::min<uint64_t>(filter.to_block, UINT32_MAX))};
+
+    std::vector<roaring::Roaring> criteria;
+    if (!filter.addresses.empty()) {
+        auto index{txn.open(table::kLogAddressIndex)};
+        criteria.push_back(any_of(*index, filter.addresses, from, to));
+    }
+    auto index{txn.open(table::kLogTopicIndex)};
+    for (const auto& values : filter.topics) {
+        if (!values.empty()) {
+            criteria.push_back(any_of(*index, values, from, to));
+        }
+    }
+
+    // Intersect the smallest sets first so that the running result shrinks as fast as possible
+    std::sort(criteria.begin(), criteria.end(),
+              [](const auto& a, const auto& b) { return a.cardinality() < b.cardinality(); });
+    blocks.addRange(from, static_cast<uint64_t>(to) + 1);
+    for (const auto& criterion : criteria) {
+        blocks &= criterion;
+        if (blocks.isEmpty()) {
+            break;
+        }
+    }
+    return blocks;
+}
+
+// Appends the logs of block_number matching the filter;
+// returns the block of the next entry in the log table, if any
+static std::optional<uint64_t> read_block_logs(lmdb::Table& log_table, uint64_t block_number,
+                                               const LogFilter& filter, std::vector<Log>& scratch,
+                                               std::vector<FilteredLog>& out) {
+    const Bytes block_prefix{block_key(block_number)};
+    uint32_t log_index{0};
+    for (auto entry{log_table.seek(block_prefix)}; entry; entry = log_table.get_next()) {
+        if (!has_prefix(entry->key, block_prefix)) {
+            return boost::endian::load_big_u64(entry->key.data());
+        }
+        scratch.clear();
+        if (!cbor_decode(entry->value, scratch)) {
+            throw std::runtime_error("Invalid CBOR logs at block " + std::to_string(block_number));
+        }
+        const uint32_t transaction_index{boost::endian::load_big_u32(&entry->key[block_prefix.length()])};
+        for (Log& log : scratch) {
+            if (filter.matches(log)) {
+                out.push_back({block_number, transaction_index, log_index, std::move(log)});
+            }
+            ++log_index;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<FilteredLog> get_logs(lmdb::Transaction& txn, const LogFilter& filter) {
+    std::vector<FilteredLog> logs;
+    std::vector<Log> scratch;
+    auto log_table{txn.open(table::kLogs)};
+
+    if (std::optional<roaring::Roaring> blocks{matching_blocks(txn, filter)}) {
+        for (uint32_t block_number : *blocks) {
+            if (!read_block_logs(*log_table, block_number, filter, scratch, logs)) {
+                break;
+            }
+        }
+        return logs;
+    }
+
+    // No index to narrow down blocks with: walk the log table throughout the range
+    std::optional<uint64_t> block_number{filter.from_block};
+    while (block_number && *block_number <= filter.to_block) {
+        block_number = read_block_logs(*log_table, *block_number, filter, scratch, logs);
+    }
+    return logs;
+}
+
+}  // namespace silkworm::db
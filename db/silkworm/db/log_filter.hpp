@@ -0,0 +1,74 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_LOG_FILTER_HPP_
+#define SILKWORM_DB_LOG_FILTER_HPP_
+
+#include <optional>
+#include <vector>
+
+#include <silkworm/db/bitmap.hpp>
+#include <silkworm/db/chaindb.hpp>
+#include <silkworm/types/log.hpp>
+
+/*
+Log queries in the fashion of eth_getLogs, served out of the indexes built by the log index stage:
+log_address_index & log_topic_index map an address or a topic (at any position) to chunked 32-bit
+roaring bitmaps of the blocks holding such logs, keyed by address/topic + chunk upper bound (BE uint32),
+the last chunk being keyed by UINT32_MAX.
+
+Candidate blocks are the intersection across criteria of the union of the bitmaps of each criterion's
+values; only logs of those blocks are decoded, and then matched exactly since topic bitmaps don't
+record positions.
+*/
+
+namespace silkworm::db {
+
+struct LogFilter {
+    uint64_t from_block{0};
+    uint64_t to_block{UINT32_MAX};  // inclusive
+
+    // Logs emitted by any of these addresses; any address if empty
+    std::vector<evmc::address> addresses;
+
+    // topics[i] lists the accepted values of the i-th topic, any value if empty.
+    // Logs with fewer topics than positions given never match.
+    std::vector<std::vector<evmc::bytes32>> topics;
+
+    // Whether the filter narrows down blocks beyond their range
+    bool has_criteria() const;
+
+    bool matches(const Log& log) const;
+};
+
+struct FilteredLog {
+    uint64_t block_number{0};
+    uint32_t transaction_index{0};
+    uint32_t log_index{0};  // within the block
+    Log log;
+};
+
+// Blocks within the range of the filter that may hold matching logs according to the indexes,
+// or std::nullopt if the filter has no criteria other than the range
+std::optional<roaring::Roaring> matching_blocks(lmdb::Transaction& txn, const LogFilter& filter);
+
+// Logs matching the filter in block, transaction & log order.
+// Throws std::runtime_error on logs that can't be decoded.
+std::vector<FilteredLog> get_logs(lmdb::Transaction& txn, const LogFilter& filter);
+
+}  // namespace silkworm::db
+
+#endif  // SILKWORM_DB_LOG_FILTER_HPP_
@@ -0,0 +1,161 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "log_filter.hpp"
+
+#include <tuple>
+
+#include <boost/endian/conversion.hpp>
+#include <catch2/catch.hpp>
+
+#include <silkworm/common/cast.hpp>
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/types/log_cbor.hpp>
+
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+static void put_chunk(lmdb::Table& index, ByteView key, std::initializer_list<uint32_t> blocks,
+                      uint32_t chunk_upper_bound = UINT32_MAX) {
+    roaring::Roaring bitmap;
+    for (uint32_t block_number : blocks) {
+        bitmap.add(block_number);
+    }
+    Bytes chunk_key(key);
+    chunk_key.resize(key.length() + sizeof(uint32_t));
+    boost::endian::store_big_u32(&chunk_key[key.length()], chunk_upper_bound);
+    Bytes value(bitmap.getSizeInBytes(), '\0');
+    bitmap.write(byte_ptr_cast(value.data()));
+    index.put(chunk_key, value);
+}
+
+TEST_CASE("Log filter") {
+    TemporaryDirectory tmp_dir;
+
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 * kMebi};
+    db_config.set_readonly(false);
+    auto env{lmdb::get_env(db_config)};
+    auto txn{env->begin_rw_transaction()};
+    table::create_all(*txn);
+
+    const auto a{0xaa00000000000000000000000000000000000000_address};
+    const auto b{0xbb00000000000000000000000000000000000000_address};
+    const auto t1{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+    const auto t2{0x0000000000000000000000000000000000000000000000000000000000000002_bytes32};
+    const auto t3{0x0000000000000000000000000000000000000000000000000000000000000003_bytes32};
+
+    auto log_table{txn->open(table::kLogs)};
+    log_table->put(log_key(1, 0), cbor_encode({Log{a, {t1, t2}, *from_hex("01")}}));
+    log_table->put(log_key(1, 1), cbor_encode({Log{b, {t2}, {}}}));
+    log_table->put(log_key(2, 0), cbor_encode({Log{a, {t2, t1}, {}}}));
+    log_table->put(log_key(5, 1), cbor_encode({Log{b, {t1, t3}, {}}, Log{a, {t1}, *from_hex("05")}}));
+    log_table->put(log_key(9, 0), cbor_encode({Log{a, {t1, t2, t3}, {}}}));
+
+    auto address_index{txn->open(table::kLogAddressIndex)};
+    put_chunk(*address_index, full_view(a), {1, 2}, /*chunk_upper_bound=*/2);
+    put_chunk(*address_index, full_view(a), {5, 9});
+    put_chunk(*address_index, full_view(b), {1, 5});
+    auto topic_index{txn->open(table::kLogTopicIndex)};
+    put_chunk(*topic_index, full_view(t1), {1, 2, 5, 9});
+    put_chunk(*topic_index, full_view(t2), {1, 2, 9});
+    put_chunk(*topic_index, full_view(t3), {5, 9});
+
+    auto positions{[](const std::vector<FilteredLog>& logs) {
+        std::vector<std::tuple<uint64_t, uint32_t, uint32_t>> out;
+        for (const auto& log : logs) {
+            out.emplace_back(log.block_number, log.transaction_index, log.log_index);
+        }
+        return out;
+    }};
+    using Positions = std::vector<std::tuple<uint64_t, uint32_t, uint32_t>>;
+
+    SECTION("Matching blocks") {
+        LogFilter filter;
+        CHECK(!matching_blocks(*txn, filter));
+
+        filter.addresses = {a};
+        filter.topics = {{t3}};
+        std::optional<roaring::Roaring> blocks{matching_blocks(*txn, filter)};
+        REQUIRE(blocks);
+        CHECK(blocks->cardinality() == 2);
+        CHECK((blocks->contains(5) && blocks->contains(9)));
+
+        filter.addresses.clear();
+        filter.topics = {{t1}};
+        filter.from_block = 2;
+        filter.to_block = 5;
+        blocks = matching_blocks(*txn, filter);
+        REQUIRE(blocks);
+        CHECK(blocks->cardinality() == 2);
+        CHECK((blocks->contains(2) && blocks->contains(5)));
+    }
+
+    SECTION("Address and topic positions") {
+        LogFilter filter;
+        filter.addresses = {a};
+        filter.topics = {{t1}, {t2}};
+        std::vector<FilteredLog> logs{get_logs(*txn, filter)};
+        CHECK(positions(logs) == Positions{{1, 0, 0}, {9, 0, 0}});
+        REQUIRE(!logs.empty());
+        CHECK(logs[0].log.address == a);
+        CHECK(logs[0].log.topics == std::vector<evmc::bytes32>{t1, t2});
+        CHECK(logs[0].log.data == *from_hex("01"));
+    }
+
+    SECTION("Wildcard topic") {
+        LogFilter filter;
+        filter.addresses = {a, b};
+        filter.topics = {{}, {t3}};
+        CHECK(positions(get_logs(*txn, filter)) == Positions{{5, 1, 0}});
+    }
+
+    SECTION("Block range") {
+        LogFilter filter;
+        filter.from_block = 3;
+        filter.to_block = 9;
+        filter.addresses = {a};
+        CHECK(positions(get_logs(*txn, filter)) == Positions{{5, 1, 1}, {9, 0, 0}});
+
+        filter.to_block = 8;
+        CHECK(positions(get_logs(*txn, filter)) == Positions{{5, 1, 1}});
+
+        filter.from_block = 10;
+        filter.to_block = 20;
+        CHECK(get_logs(*txn, filter).empty());
+    }
+
+    SECTION("No criteria") {
+        LogFilter filter;
+        filter.from_block = 2;
+        filter.to_block = 5;
+        CHECK(positions(get_logs(*txn, filter)) == Positions{{2, 0, 0}, {5, 1, 0}, {5, 1, 1}});
+
+        filter.from_block = 0;
+        filter.to_block = UINT64_MAX;
+        CHECK(get_logs(*txn, filter).size() == 6);
+    }
+
+    SECTION("Invalid logs") {
+        log_table->put(log_key(9, 0), *from_hex("8301"));
+        LogFilter filter;
+        filter.topics = {{t3}};
+        CHECK_THROWS_AS(get_logs(*txn, filter), std::runtime_error);
+    }
+}
+
+}  // namespace silkworm::db
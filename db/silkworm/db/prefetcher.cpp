@@ -0,0 +1,160 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "prefetcher.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <silkworm/common/log.hpp>
+
+#include "access_layer.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+BlockPrefetcher::BlockPrefetcher(lmdb::Transaction& txn, uint64_t from_block, uint64_t to_block, size_t depth)
+    : from_block_{from_block}, to_block_{to_block}, depth_{std::max<size_t>(depth, 1)} {
+    canonical_hashes_dbi_ = txn.open(table::kCanonicalHashes)->get_dbi();
+    headers_dbi_ = txn.open(table::kHeaders)->get_dbi();
+    bodies_dbi_ = txn.open(table::kBlockBodies)->get_dbi();
+    transactions_dbi_ = txn.open(table::kEthTx)->get_dbi();
+    senders_dbi_ = txn.open(table::kSenders)->get_dbi();
+
+    MDB_env* env{mdb_txn_env(*txn.handle())};
+    thread_ = std::thread([this, env]() { run(env); });
+}
+
+BlockPrefetcher::~BlockPrefetcher() {
+    {
+        std::lock_guard lock{mtx_};
+        stopped_ = true;
+    }
+    not_full_.notify_all();
+    thread_.join();
+}
+
+std::optional<BlockWithHash> BlockPrefetcher::next() {
+    std::unique_lock lock{mtx_};
+    not_empty_.wait(lock, [this]() { return !queue_.empty() || done_; });
+    if (queue_.empty()) {
+        return std::nullopt;
+    }
+    BlockWithHash bh{std::move(queue_.front())};
+    queue_.pop_front();
+    lock.unlock();
+    not_full_.notify_one();
+    return bh;
+}
+
+void BlockPrefetcher::run(MDB_env* env) {
+    MDB_txn* handle{nullptr};
+    std::unique_ptr<lmdb::Transaction> txn{nullptr};
+    bool failed{false};
+    try {
+        lmdb::err_handler(mdb_txn_begin(env, nullptr, MDB_RDONLY, &handle));
+        txn = std::make_unique<lmdb::Transaction>(/*parent=*/nullptr, handle, MDB_RDONLY);
+        // Dbis created by the caller's transaction are not visible until it commits: opening cursors fails then
+        canonical_hashes_ =
+            std::make_unique<lmdb::Table>(txn.get(), canonical_hashes_dbi_, table::kCanonicalHashes.name);
+        headers_ = std::make_unique<lmdb::Table>(txn.get(), headers_dbi_, table::kHeaders.name);
+        bodies_ = std::make_unique<lmdb::Table>(txn.get(), bodies_dbi_, table::kBlockBodies.name);
+        transactions_ = std::make_unique<lmdb::Table>(txn.get(), transactions_dbi_, table::kEthTx.name);
+        senders_ = std::make_unique<lmdb::Table>(txn.get(), senders_dbi_, table::kSenders.name);
+    } catch (const std::exception& ex) {
+        SILKWORM_LOG(LogLevel::Warn) << "Block prefetcher not started : " << ex.what() << std::endl;
+        failed = true;
+    }
+
+    for (uint64_t block_number{from_block_}; !failed && block_number <= to_block_; ++block_number) {
+        std::optional<BlockWithHash> bh;
+        try {
+            bh = read_block(block_number);
+        } catch (const std::exception&) {
+            // Let the consumer hit the same error (if any) on its own transaction
+        }
+        if (!bh) {
+            break;
+        }
+
+        std::unique_lock lock{mtx_};
+        not_full_.wait(lock, [this]() { return stopped_ || queue_.size() < depth_; });
+        if (stopped_) {
+            break;
+        }
+        queue_.push_back(std::move(*bh));
+        lock.unlock();
+        not_empty_.notify_one();
+    }
+
+    // Cursors first, then the transaction which was not begun through an lmdb::Environment
+    canonical_hashes_.reset();
+    headers_.reset();
+    bodies_.reset();
+    transactions_.reset();
+    senders_.reset();
+    if (txn) {
+        txn->release();
+    }
+    if (handle) {
+        mdb_txn_abort(handle);
+    }
+
+    {
+        std::lock_guard lock{mtx_};
+        done_ = true;
+    }
+    not_empty_.notify_all();
+}
+
+// Same as db::read_block with senders but on the prefetcher's own tables
+std::optional<BlockWithHash> BlockPrefetcher::read_block(uint64_t block_number) {
+    std::optional<ByteView> hash{canonical_hashes_->get(block_key(block_number))};
+    if (!hash || hash->size() != kHashLength) {
+        return std::nullopt;
+    }
+
+    BlockWithHash bh{};
+    std::memcpy(bh.hash.bytes, hash->data(), kHashLength);
+
+    Bytes key{block_key(block_number, bh.hash.bytes)};
+    std::optional<ByteView> header_rlp{headers_->get(key)};
+    if (!header_rlp) {
+        return std::nullopt;
+    }
+    rlp::err_handler(rlp::decode(*header_rlp, bh.block.header));
+
+    std::optional<ByteView> body_rlp{bodies_->get(key)};
+    if (!body_rlp) {
+        return std::nullopt;
+    }
+    auto body{detail::decode_stored_block_body(*body_rlp)};
+    bh.block.ommers = std::move(body.ommers);
+    bh.block.transactions = read_transactions(*transactions_, body.base_txn_id, body.txn_count);
+
+    const ByteView senders{senders_->get(key).value_or(ByteView{})};
+    if (senders.size() != bh.block.transactions.size() * kAddressLength) {
+        return std::nullopt;
+    }
+    for (size_t i{0}; i < bh.block.transactions.size(); ++i) {
+        std::memcpy(bh.block.transactions[i].from.emplace().bytes, &senders[i * kAddressLength], kAddressLength);
+    }
+
+    return bh;
+}
+
+}  // namespace silkworm::db
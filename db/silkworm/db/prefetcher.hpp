@@ -0,0 +1,90 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_PREFETCHER_HPP_
+#define SILKWORM_DB_PREFETCHER_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include <silkworm/db/chaindb.hpp>
+#include <silkworm/types/block.hpp>
+
+namespace silkworm::db {
+
+/*
+ * Reads and decodes blocks [from_block, to_block] ahead of their consumer
+ * on a dedicated thread, keeping at most depth decoded blocks in a queue.
+ *
+ * Blocks are read through a read-only transaction of the prefetcher's own, hence
+ * they reflect the last committed state of the database and not any pending change
+ * of the consumer's read-write transaction. Consumer is expected to check the hash of
+ * each prefetched block against its own canonical chain and to fall back to a
+ * synchronous read whenever it does not match or the block has not been prefetched.
+ */
+class BlockPrefetcher {
+  public:
+    // The tables are opened (mdb_dbi_open) in the caller's transaction, the worker only opening cursors on them:
+    // mdb_dbi_open must not be called from another transaction while one having opened dbis is pending.
+    BlockPrefetcher(lmdb::Transaction& txn, uint64_t from_block, uint64_t to_block, size_t depth);
+    ~BlockPrefetcher();
+
+    BlockPrefetcher(const BlockPrefetcher&) = delete;
+    BlockPrefetcher& operator=(const BlockPrefetcher&) = delete;
+
+    /** @brief Returns the next block in sequence (starting from from_block) waiting for it if needed.
+     *
+     * std::nullopt is returned if the block could not be prefetched (i.e. it's not found in the
+     * committed state or any error occurred). In that case no further block is prefetched.
+     */
+    std::optional<BlockWithHash> next();
+
+  private:
+    void run(MDB_env* env);
+    std::optional<BlockWithHash> read_block(uint64_t block_number);
+
+    const uint64_t from_block_;
+    const uint64_t to_block_;
+    const size_t depth_;
+
+    // Handles resolved in the caller's transaction, valid env wise
+    MDB_dbi canonical_hashes_dbi_{0};
+    MDB_dbi headers_dbi_{0};
+    MDB_dbi bodies_dbi_{0};
+    MDB_dbi transactions_dbi_{0};
+    MDB_dbi senders_dbi_{0};
+
+    std::unique_ptr<lmdb::Table> canonical_hashes_{nullptr};
+    std::unique_ptr<lmdb::Table> headers_{nullptr};
+    std::unique_ptr<lmdb::Table> bodies_{nullptr};
+    std::unique_ptr<lmdb::Table> transactions_{nullptr};
+    std::unique_ptr<lmdb::Table> senders_{nullptr};
+
+    std::mutex mtx_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<BlockWithHash> queue_;
+    bool done_{false};     // Worker won't push any further block
+    bool stopped_{false};  // Consumer is no longer interested
+    std::thread thread_;
+};
+
+}  // namespace silkworm::db
+
+#endif  // SILKWORM_DB_PREFETCHER_HPP_
@@ -0,0 +1,285 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "senders.hpp"
+
+#include <algorithm>
+
+#include <boost/endian/conversion.hpp>
+
+#include <silkworm/common/util.hpp>
+#include <silkworm/crypto/ecdsa.hpp>
+#include <silkworm/rlp/encode.hpp>
+
+#include "access_layer.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+SenderRecoverer::SenderRecoverer(size_t max_batch_size, size_t num_threads) : max_batch_size_{max_batch_size} {
+    packages_.reserve(max_batch_size_);
+    senders_.resize(max_batch_size_);
+    for (size_t i{1}; i < num_threads; ++i) {
+        workers_.emplace_back([this]() { run(); });
+    }
+}
+
+SenderRecoverer::~SenderRecoverer() {
+    {
+        std::lock_guard lock{mtx_};
+        stopped_ = true;
+    }
+    work_available_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+bool SenderRecoverer::add_block(uint64_t block_number, const std::vector<Transaction>& transactions,
+                                const ChainConfig& config) {
+    const evmc_revision rev{config.revision(block_number)};
+    const bool has_homestead{rev >= EVMC_HOMESTEAD};
+    const bool has_spurious_dragon{rev >= EVMC_SPURIOUS_DRAGON};
+
+    for (const Transaction& txn : transactions) {
+        if (!ecdsa::is_valid_signature(txn.r, txn.s, has_homestead)) {
+            return false;
+        }
+        if (txn.chain_id && (!has_spurious_dragon || *txn.chain_id != config.chain_id)) {
+            return false;
+        }
+    }
+
+    if (transactions.empty()) {
+        return true;
+    }
+
+    blocks_.push_back({block_number, packages_.size(), transactions.size()});
+    for (const Transaction& txn : transactions) {
+        rlp_.clear();
+        rlp::encode(rlp_, txn, /*for_signing=*/true, /*wrap_eip2718_into_array=*/false);
+
+        Package& package{packages_.emplace_back()};
+        package.hash = keccak256(rlp_);
+        intx::be::unsafe::store(package.signature, txn.r);
+        intx::be::unsafe::store(package.signature + 32, txn.s);
+        package.odd_y_parity = txn.odd_y_parity;
+    }
+    if (senders_.size() < packages_.size()) {
+        senders_.resize(packages_.size());
+    }
+    return true;
+}
+
+std::optional<uint64_t> SenderRecoverer::recover() {
+    if (packages_.empty()) {
+        return std::nullopt;
+    }
+
+    next_package_.store(0, std::memory_order_relaxed);
+    first_failure_.store(SIZE_MAX, std::memory_order_relaxed);
+    busy_workers_.store(workers_.size(), std::memory_order_relaxed);
+    {
+        std::lock_guard lock{mtx_};
+        ++generation_;
+    }
+    work_available_.notify_all();
+
+    recover_chunks();
+
+    {
+        std::unique_lock lock{mtx_};
+        work_done_.wait(lock, [this]() { return busy_workers_.load(std::memory_order_acquire) == 0; });
+    }
+
+    const size_t failure{first_failure_.load(std::memory_order_relaxed)};
+    if (failure == SIZE_MAX) {
+        return std::nullopt;
+    }
+    auto it{std::upper_bound(blocks_.begin(), blocks_.end(), failure,
+                             [](size_t index, const BlockRange& block) { return index < block.first_package; })};
+    return std::prev(it)->block_number;
+}
+
+std::vector<SenderRecoverer::BlockSenders> SenderRecoverer::senders() const {
+    std::vector<BlockSenders> out;
+    out.reserve(blocks_.size());
+    for (const BlockRange& block : blocks_) {
+        const auto* data{senders_[block.first_package].bytes};
+        out.push_back({block.block_number, ByteView{data, block.num_packages * kAddressLength}});
+    }
+    return out;
+}
+
+void SenderRecoverer::clear() noexcept {
+    packages_.clear();
+    blocks_.clear();
+}
+
+void SenderRecoverer::run() {
+    uint64_t generation{0};
+    while (true) {
+        {
+            std::unique_lock lock{mtx_};
+            work_available_.wait(lock, [&]() { return stopped_ || generation_ != generation; });
+            if (stopped_) {
+                return;
+            }
+            generation = generation_;
+        }
+
+        recover_chunks();
+
+        if (busy_workers_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard lock{mtx_};
+            work_done_.notify_one();
+        }
+    }
+}
+
+void SenderRecoverer::recover_chunks() {
+    const size_t num_packages{packages_.size()};
+    while (first_failure_.load(std::memory_order_relaxed) == SIZE_MAX) {
+        const size_t begin{next_package_.fetch_add(kChunkSize, std::memory_order_relaxed)};
+        if (begin >= num_packages) {
+            break;
+        }
+        const size_t end{std::min(begin + kChunkSize, num_packages)};
+        for (size_t i{begin}; i < end; ++i) {
+            const Package& package{packages_[i]};
+            std::optional<evmc::address> sender{
+                ecdsa::recover_address(package.hash.bytes, package.signature, package.odd_y_parity)};
+            if (!sender) {
+                // Keep the lowest failing index
+                size_t failure{first_failure_.load(std::memory_order_relaxed)};
+                while (i < failure && !first_failure_.compare_exchange_weak(failure, i, std::memory_order_relaxed)) {
+                }
+                break;
+            }
+            senders_[i] = *sender;
+        }
+    }
+}
+
+BlockBatchReader::BlockBatchReader(lmdb::Environment& env, size_t max_batch_size)
+    : env_{env}, max_batch_size_{max_batch_size} {
+    auto txn{env_.begin_ro_transaction()};
+    bodies_dbi_ = txn->open(table::kBlockBodies)->get_dbi();
+    transactions_dbi_ = txn->open(table::kEthTx)->get_dbi();
+    lmdb::err_handler(txn->commit());
+}
+
+std::optional<uint64_t> BlockBatchReader::read(uint64_t from, const std::vector<evmc::bytes32>& hashes,
+                                               const std::function<bool(BlockBatch&&)>& consumer) const {
+    auto txn{env_.begin_ro_transaction()};
+    lmdb::Table bodies{txn.get(), bodies_dbi_, table::kBlockBodies.name};
+    lmdb::Table transactions{txn.get(), transactions_dbi_, table::kEthTx.name};
+
+    BlockBatch batch{};
+    for (size_t i{0}; i < hashes.size(); ++i) {
+        const uint64_t block_number{from + i};
+        std::optional<ByteView> body_rlp{bodies.get(block_key(block_number, hashes[i].bytes))};
+        if (!body_rlp) {
+            return block_number;
+        }
+
+        const detail::BlockBodyForStorage body{detail::decode_stored_block_body(*body_rlp)};
+        std::vector<Transaction> block_transactions{read_transactions(transactions, body.base_txn_id, body.txn_count)};
+        if (block_transactions.empty()) {
+            continue;
+        }
+
+        if (batch.txn_count && batch.txn_count + block_transactions.size() > max_batch_size_) {
+            if (!consumer(std::move(batch))) {
+                return std::nullopt;
+            }
+            batch = BlockBatch{};
+        }
+        batch.txn_count += block_transactions.size();
+        batch.blocks.emplace_back(block_number, std::move(block_transactions));
+    }
+
+    if (batch.txn_count) {
+        consumer(std::move(batch));
+    }
+    return std::nullopt;
+}
+
+std::optional<uint64_t> recover_senders(lmdb::Transaction& txn, const ChainConfig& config, uint64_t from, uint64_t to,
+                                        SenderRecoverer& recoverer) {
+    auto canonical_hashes{txn.open(table::kCanonicalHashes)};
+    auto bodies{txn.open(table::kBlockBodies)};
+    auto transactions{txn.open(table::kEthTx)};
+    auto senders{txn.open(table::kSenders, MDB_CREATE)};
+
+    // Blocks past the last one recorded can be appended
+    std::optional<uint64_t> last_recorded;
+    MDB_val mdb_key{}, mdb_data{};
+    const int rc{senders->get_last(&mdb_key, &mdb_data)};
+    if (rc != MDB_NOTFOUND) {
+        lmdb::err_handler(rc);
+        last_recorded = boost::endian::load_big_u64(static_cast<uint8_t*>(mdb_key.mv_data));
+    }
+
+    uint64_t batch_from{from};
+    std::vector<evmc::bytes32> hashes;  // of blocks [batch_from, last_processed]
+
+    auto flush{[&]() {
+        if (std::optional<uint64_t> failed_block{recoverer.recover()}; failed_block) {
+            throw SenderRecoveryError(*failed_block, "Unrecoverable sender at block " + std::to_string(*failed_block));
+        }
+        for (const SenderRecoverer::BlockSenders& block : recoverer.senders()) {
+            const Bytes key{block_key(block.block_number, hashes[block.block_number - batch_from].bytes)};
+            const bool append{!last_recorded || block.block_number > *last_recorded};
+            senders->put(key, block.senders, append ? MDB_APPEND : 0u);
+        }
+        recoverer.clear();
+        hashes.clear();
+    }};
+
+    std::optional<uint64_t> last_processed;
+    for (uint64_t block_number{from}; block_number <= to; ++block_number) {
+        std::optional<ByteView> hash_view{canonical_hashes->get(block_key(block_number))};
+        if (!hash_view || hash_view->length() != kHashLength) {
+            break;
+        }
+        const evmc::bytes32 hash{to_bytes32(*hash_view)};
+
+        std::optional<ByteView> body_rlp{bodies->get(block_key(block_number, hash.bytes))};
+        if (!body_rlp) {
+            break;
+        }
+        const detail::BlockBodyForStorage body{detail::decode_stored_block_body(*body_rlp)};
+        const std::vector<Transaction> block_transactions{
+            read_transactions(*transactions, body.base_txn_id, body.txn_count)};
+
+        if (!recoverer.fits(block_transactions.size())) {
+            flush();
+            batch_from = block_number;
+        }
+        if (!recoverer.add_block(block_number, block_transactions, config)) {
+            throw SenderRecoveryError(block_number, "Invalid signature at block " + std::to_string(block_number));
+        }
+        hashes.push_back(hash);
+        last_processed = block_number;
+    }
+    flush();
+
+    return last_processed;
+}
+
+}  // namespace silkworm::db
@@ -0,0 +1,184 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_SENDERS_HPP_
+#define SILKWORM_DB_SENDERS_HPP_
+
+// Batched recovery of transaction senders (see TG Senders stage)
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <ethash/hash_types.hpp>
+
+#include <silkworm/chain/config.hpp>
+#include <silkworm/db/chaindb.hpp>
+#include <silkworm/types/transaction.hpp>
+
+namespace silkworm::db {
+
+// Thrown when a transaction signature is invalid or its sender can't be recovered
+class SenderRecoveryError : public std::runtime_error {
+  public:
+    SenderRecoveryError(uint64_t block_number, const std::string& what)
+        : std::runtime_error{what}, block_number_{block_number} {}
+
+    uint64_t block_number() const noexcept { return block_number_; }
+
+  private:
+    uint64_t block_number_;
+};
+
+/*
+ * Recovers the senders of a batch of blocks' transactions over a fixed set of threads.
+ *
+ * Blocks are added to the batch by the owner thread, which computes their signing hashes; recover() then
+ * lets the worker threads and the owner one claim chunks of kChunkSize signatures off a shared atomic cursor,
+ * hence no lock is taken (and nothing is allocated) per signature. Each recovered address is written at
+ * the signature's index into an output buffer preallocated for max_batch_size transactions, so the senders
+ * of each block are readily available in the txSenders value format.
+ *
+ * A recoverer must only be used by one thread at a time; worker threads are kept alive across batches.
+ */
+class SenderRecoverer {
+  public:
+    static constexpr size_t kChunkSize{64};
+
+    // num_threads is the overall number of recovering threads, the owner one included
+    SenderRecoverer(size_t max_batch_size, size_t num_threads);
+    ~SenderRecoverer();
+
+    SenderRecoverer(const SenderRecoverer&) = delete;
+    SenderRecoverer& operator=(const SenderRecoverer&) = delete;
+
+    struct BlockSenders {
+        uint64_t block_number{0};
+        ByteView senders;  // concatenated addresses; valid until the next call to add_block or clear
+    };
+
+    /** @brief Validates the signatures of a block's transactions against chain rules and adds them to the batch.
+     *
+     * Returns false, leaving the batch untouched, if any signature is invalid. A block with more transactions
+     * than max_batch_size is still accepted, making buffers grow.
+     */
+    bool add_block(uint64_t block_number, const std::vector<Transaction>& transactions, const ChainConfig& config);
+
+    // Whether n more transactions fit in the batch without exceeding max_batch_size
+    bool fits(size_t n) const noexcept { return packages_.size() + n <= max_batch_size_; }
+
+    // Number of transactions in the batch
+    size_t size() const noexcept { return packages_.size(); }
+
+    /** @brief Recovers the senders of all the transactions in the batch.
+     *
+     * Returns the number of the first block a sender of which can't be recovered, if any.
+     */
+    std::optional<uint64_t> recover();
+
+    // Senders of each block in the batch with at least one transaction, as of the last call to recover
+    std::vector<BlockSenders> senders() const;
+
+    // Empties the batch keeping the buffers allocated
+    void clear() noexcept;
+
+  private:
+    struct Package {
+        ethash::hash256 hash;  // signing hash
+        uint8_t signature[64];
+        bool odd_y_parity{false};
+    };
+
+    struct BlockRange {
+        uint64_t block_number{0};
+        size_t first_package{0};
+        size_t num_packages{0};
+    };
+
+    void run();
+    void recover_chunks();
+
+    const size_t max_batch_size_;
+
+    std::vector<Package> packages_;
+    std::vector<evmc::address> senders_;
+    std::vector<BlockRange> blocks_;
+    Bytes rlp_;
+
+    std::atomic<size_t> next_package_{0};
+    std::atomic<size_t> first_failure_{SIZE_MAX};
+    std::atomic<size_t> busy_workers_{0};
+
+    std::mutex mtx_;
+    std::condition_variable work_available_;
+    std::condition_variable work_done_;
+    uint64_t generation_{0};  // incremented at each batch, guarded by mtx_
+    bool stopped_{false};
+    std::vector<std::thread> workers_;
+};
+
+// Transactions of consecutive canonical blocks read ahead of their recovery
+struct BlockBatch {
+    std::vector<std::pair<uint64_t, std::vector<Transaction>>> blocks;  // Block number and its transactions (if any)
+    size_t txn_count{0};                                                // Overall number of transactions
+};
+
+/*
+ * Reads the transactions of canonical blocks into batches through a read-only transaction of its own,
+ * so that it can run on another thread ahead of a read-write transaction recording their senders.
+ *
+ * A dbi opened by a transaction stays private to it until it commits: the tables read are thus opened
+ * on construction in a short read-only transaction committed at once, which must happen before the calling
+ * thread begins its read-write transaction.
+ */
+class BlockBatchReader {
+  public:
+    BlockBatchReader(lmdb::Environment& env, size_t max_batch_size);
+
+    /** @brief Reads blocks [from, from + hashes.size()), hashes being their canonical ones, into batches of
+     * up to max_batch_size transactions (a larger block still makes a batch on its own) handed to consumer,
+     * which returns false to stop reading. Blocks with no transactions are skipped.
+     *
+     * Returns the number of the first block whose body is not found, if any.
+     */
+    std::optional<uint64_t> read(uint64_t from, const std::vector<evmc::bytes32>& hashes,
+                                 const std::function<bool(BlockBatch&&)>& consumer) const;
+
+  private:
+    lmdb::Environment& env_;
+    const size_t max_batch_size_;
+    MDB_dbi bodies_dbi_{0};
+    MDB_dbi transactions_dbi_{0};
+};
+
+/** @brief Recovers the senders of canonical blocks [from, to] and writes them into table::kSenders.
+ *
+ * Blocks are read, recovered and written one recoverer batch at a time; the senders of each block
+ * are appended with MDB_APPEND whenever the block lies past the last one in table::kSenders.
+ * Stops at the first canonical block not found and returns the number of the last block processed, if any.
+ * Throws SenderRecoveryError on invalid signatures.
+ */
+std::optional<uint64_t> recover_senders(lmdb::Transaction& txn, const ChainConfig& config, uint64_t from, uint64_t to,
+                                        SenderRecoverer& recoverer);
+
+}  // namespace silkworm::db
+
+#endif  // SILKWORM_DB_SENDERS_HPP_
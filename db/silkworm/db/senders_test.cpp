@@ -0,0 +1,291 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "senders.hpp"
+
+#include <thread>
+
+#include <boost/endian/conversion.hpp>
+#include <catch2/catch.hpp>
+
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/rlp/encode.hpp>
+
+#include "access_layer.hpp"
+#include "tables.hpp"
+#include "util.hpp"
+
+namespace silkworm::db {
+
+// Mainnet transactions sent by 0xa1e4380a3b1f749673e270229993ee55f35663b4
+static std::vector<Transaction> sample_transactions() {
+    std::vector<Transaction> transactions(2);
+
+    transactions[0].nonce = 0;
+    transactions[0].gas_price = 50'000 * kGiga;
+    transactions[0].gas_limit = 21'000;
+    transactions[0].to = 0x5df9b87991262f6ba471f09758cde1c0fc1de734_address;
+    transactions[0].value = 31337;
+    transactions[0].odd_y_parity = true;
+    transactions[0].r =
+        intx::from_string<intx::uint256>("0x88ff6cf0fefd94db46111149ae4bfc179e9b94721fffd821d38d16464b3f71d0");
+    transactions[0].s =
+        intx::from_string<intx::uint256>("0x45e0aff800961cfce805daef7016b9b675c137a6a41a548f7b60a3484c06a33a");
+
+    transactions[1].nonce = 1;
+    transactions[1].gas_price = 50'000 * kGiga;
+    transactions[1].gas_limit = 21'750;
+    transactions[1].to = 0xc9d4035f4a9226d50f79b73aafb5d874a1b6537e_address;
+    transactions[1].value = 31337;
+    transactions[1].data = *from_hex("0x74796d3474406469676978");
+    transactions[1].odd_y_parity = true;
+    transactions[1].r =
+        intx::from_string<intx::uint256>("0x1c48defe76d367bb92b4fc0628aca42a4d8037062865635d955673e57eddfbfa");
+    transactions[1].s =
+        intx::from_string<intx::uint256>("0x65f766849f97b15f01d0877636fbed0fa4e39f8834896c0354f56ac44dcb50a6");
+
+    return transactions;
+}
+
+static constexpr auto kSender{0xa1e4380a3b1f749673e270229993ee55f35663b4_address};
+
+static Bytes senders_of(size_t n) {
+    Bytes out;
+    for (size_t i{0}; i < n; ++i) {
+        out.append(full_view(kSender));
+    }
+    return out;
+}
+
+TEST_CASE("Sender recoverer") {
+    const std::vector<Transaction> transactions{sample_transactions()};
+
+    for (size_t num_threads : {1u, 4u}) {
+        SenderRecoverer recoverer{/*max_batch_size=*/2 * SenderRecoverer::kChunkSize, num_threads};
+
+        // Batch spanning several chunks
+        uint64_t block_number{1};
+        while (recoverer.fits(transactions.size())) {
+            REQUIRE(recoverer.add_block(block_number++, transactions, kMainnetConfig));
+            REQUIRE(recoverer.add_block(block_number++, {}, kMainnetConfig));
+        }
+        CHECK(recoverer.size() == 2 * SenderRecoverer::kChunkSize);
+        CHECK(!recoverer.recover());
+
+        std::vector<SenderRecoverer::BlockSenders> senders{recoverer.senders()};
+        REQUIRE(senders.size() == SenderRecoverer::kChunkSize);
+        for (size_t i{0}; i < senders.size(); ++i) {
+            CHECK(senders[i].block_number == 2 * i + 1);
+            CHECK(senders[i].senders == senders_of(2));
+        }
+
+        // Recoverer is reusable
+        recoverer.clear();
+        CHECK(recoverer.size() == 0);
+        CHECK(!recoverer.recover());
+        CHECK(recoverer.senders().empty());
+        REQUIRE(recoverer.add_block(1'000, {transactions[1]}, kMainnetConfig));
+        CHECK(!recoverer.recover());
+        senders = recoverer.senders();
+        REQUIRE(senders.size() == 1);
+        CHECK(senders[0].block_number == 1'000);
+        CHECK(senders[0].senders == senders_of(1));
+
+        // Invalid signatures leave the batch untouched
+        std::vector<Transaction> invalid{transactions};
+        invalid[1].r = 0;
+        CHECK(!recoverer.add_block(1'001, invalid, kMainnetConfig));
+        invalid = transactions;
+        invalid[0].chain_id = 1;  // before Spurious Dragon
+        CHECK(!recoverer.add_block(1'001, invalid, kMainnetConfig));
+        CHECK(recoverer.size() == 1);
+    }
+}
+
+TEST_CASE("Recover senders into the database") {
+    TemporaryDirectory tmp_dir;
+
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 * kMebi};
+    db_config.set_readonly(false);
+    auto env{lmdb::get_env(db_config)};
+    auto txn{env->begin_rw_transaction()};
+    table::create_all(*txn);
+
+    const std::vector<Transaction> transactions{sample_transactions()};
+
+    // Blocks 1..10 with block_number % 3 transactions each
+    auto canonical_hashes{txn->open(table::kCanonicalHashes)};
+    auto bodies{txn->open(table::kBlockBodies)};
+    auto txn_table{txn->open(table::kEthTx)};
+    uint64_t txn_id{0};
+    for (uint64_t block_number{1}; block_number <= 10; ++block_number) {
+        evmc::bytes32 hash;
+        hash.bytes[0] = static_cast<uint8_t>(block_number);
+        canonical_hashes->put(block_key(block_number), full_view(hash));
+
+        detail::BlockBodyForStorage body;
+        body.base_txn_id = txn_id;
+        body.txn_count = block_number % 3;
+        bodies->put(block_key(block_number, hash.bytes), body.encode());
+
+        Bytes txn_key(8, '\0');
+        for (size_t i{0}; i < body.txn_count; ++i) {
+            boost::endian::store_big_u64(txn_key.data(), txn_id++);
+            Bytes rlp;
+            rlp::encode(rlp, transactions[i]);
+            txn_table->put(txn_key, rlp);
+        }
+    }
+
+    SenderRecoverer recoverer{/*max_batch_size=*/4, /*num_threads=*/2};
+
+    auto check_senders{[&](uint64_t from, uint64_t to) {
+        for (uint64_t block_number{from}; block_number <= to; ++block_number) {
+            std::optional<evmc::bytes32> hash{read_canonical_hash(*txn, block_number)};
+            REQUIRE(hash);
+            std::vector<evmc::address> senders{read_senders(*txn, block_number, hash->bytes)};
+            CHECK(senders == std::vector<evmc::address>(block_number % 3, kSender));
+        }
+    }};
+
+    CHECK(recover_senders(*txn, kMainnetConfig, 4, 7, recoverer) == 7);
+    check_senders(4, 7);
+
+    // Blocks past the last one recorded are appended, the others overwritten
+    CHECK(recover_senders(*txn, kMainnetConfig, 1, 8, recoverer) == 8);
+    check_senders(1, 8);
+
+    // Stops at the first block not found
+    CHECK(recover_senders(*txn, kMainnetConfig, 9, 20, recoverer) == 10);
+    check_senders(1, 10);
+    CHECK(!recover_senders(*txn, kMainnetConfig, 11, 20, recoverer));
+
+    // Invalid signature
+    Transaction invalid{transactions[0]};
+    invalid.r = 0;
+    Bytes rlp;
+    rlp::encode(rlp, invalid);
+    txn_table->put(block_key(txn_id), rlp);
+    canonical_hashes->put(block_key(11), full_view(evmc::bytes32{}));
+    detail::BlockBodyForStorage body;
+    body.base_txn_id = txn_id;
+    body.txn_count = 1;
+    bodies->put(block_key(11, evmc::bytes32{}.bytes), body.encode());
+    CHECK_THROWS_AS(recover_senders(*txn, kMainnetConfig, 11, 11, recoverer), SenderRecoveryError);
+}
+
+TEST_CASE("Read block batches ahead of recovery on a freshly opened environment") {
+    TemporaryDirectory tmp_dir;
+
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 * kMebi};
+    db_config.set_readonly(false);
+
+    const std::vector<Transaction> transactions{sample_transactions()};
+
+    // Blocks 1..10 with block_number % 3 transactions each
+    std::vector<evmc::bytes32> hashes;
+    {
+        auto env{lmdb::get_env(db_config)};
+        auto txn{env->begin_rw_transaction()};
+        table::create_all(*txn);
+        auto bodies{txn->open(table::kBlockBodies)};
+        auto txn_table{txn->open(table::kEthTx)};
+        uint64_t txn_id{0};
+        for (uint64_t block_number{1}; block_number <= 10; ++block_number) {
+            evmc::bytes32 hash;
+            hash.bytes[0] = static_cast<uint8_t>(block_number);
+            hashes.push_back(hash);
+
+            detail::BlockBodyForStorage body;
+            body.base_txn_id = txn_id;
+            body.txn_count = block_number % 3;
+            bodies->put(block_key(block_number, hash.bytes), body.encode());
+
+            Bytes txn_key(8, '\0');
+            for (size_t i{0}; i < body.txn_count; ++i) {
+                boost::endian::store_big_u64(txn_key.data(), txn_id++);
+                Bytes rlp;
+                rlp::encode(rlp, transactions[i]);
+                txn_table->put(txn_key, rlp);
+            }
+        }
+        lmdb::err_handler(txn->commit());
+        env->close();
+    }
+
+    // No dbi is known to the new environment, so any the reader uses must be published before the rw txn begins
+    auto env{lmdb::get_env(db_config)};
+    BlockBatchReader reader{*env, /*max_batch_size=*/3};
+    auto txn{env->begin_rw_transaction()};
+    auto senders{txn->open(table::kSenders, MDB_CREATE)};
+
+    std::vector<BlockBatch> batches;
+    std::optional<uint64_t> missing_block;
+    std::thread reader_thread{[&]() {
+        missing_block = reader.read(1, hashes, [&](BlockBatch&& batch) {
+            batches.push_back(std::move(batch));
+            return true;
+        });
+    }};
+    reader_thread.join();
+
+    CHECK(!missing_block);
+    REQUIRE(batches.size() == 4);  // {1, 2}, {4, 5}, {7, 8}, {10}
+    CHECK(batches[0].txn_count == 3);
+    CHECK(batches[3].txn_count == 1);
+
+    SenderRecoverer recoverer{/*max_batch_size=*/3, /*num_threads=*/2};
+    for (const BlockBatch& batch : batches) {
+        for (const auto& [block_number, block_transactions] : batch.blocks) {
+            CHECK(block_transactions.size() == block_number % 3);
+            REQUIRE(recoverer.add_block(block_number, block_transactions, kMainnetConfig));
+        }
+        CHECK(!recoverer.recover());
+        for (const SenderRecoverer::BlockSenders& block : recoverer.senders()) {
+            senders->put(block_key(block.block_number, hashes[block.block_number - 1].bytes), block.senders);
+        }
+        recoverer.clear();
+    }
+    for (uint64_t block_number{1}; block_number <= 10; ++block_number) {
+        CHECK(read_senders(*txn, block_number, hashes[block_number - 1].bytes) ==
+              std::vector<evmc::address>(block_number % 3, kSender));
+    }
+
+    // Reading stops at the first block not found or once the consumer declines a batch
+    hashes[4] = evmc::bytes32{};
+    size_t num_batches{0};
+    std::thread{[&]() {
+        missing_block = reader.read(1, hashes, [&](BlockBatch&&) {
+            ++num_batches;
+            return true;
+        });
+    }}.join();
+    CHECK(missing_block == 5);
+    CHECK(num_batches == 1);
+
+    num_batches = 0;
+    std::thread{[&]() {
+        missing_block = reader.read(1, hashes, [&](BlockBatch&&) {
+            ++num_batches;
+            return false;
+        });
+    }}.join();
+    CHECK(!missing_block);
+    CHECK(num_batches == 1);
+}
+
+}  // namespace silkworm::db
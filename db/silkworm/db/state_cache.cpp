@@ -0,0 +1,133 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "state_cache.hpp"
+
+#include <algorithm>
+#include <climits>
+
+namespace silkworm::db {
+
+namespace {
+
+    // Top bits of the hash select the shard: lower ones are used by the shard's own hash map
+    size_t shard_of(size_t hash, unsigned shard_bits) noexcept {
+        return shard_bits ? hash >> (sizeof(size_t) * CHAR_BIT - shard_bits) : 0;
+    }
+
+}  // namespace
+
+size_t StateCache::StorageKeyHash::operator()(const StorageKey& key) const noexcept {
+    size_t h{std::hash<evmc::bytes32>{}(key.location)};
+    h ^= std::hash<evmc::address>{}(key.address) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    h ^= std::hash<uint64_t>{}(key.incarnation) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    return h;
+}
+
+StateCache::StateCache(size_t max_accounts, size_t max_storage_slots, size_t num_shards)
+    : max_accounts_{max_accounts}, max_storage_slots_{max_storage_slots} {
+    while ((size_t{1} << shard_bits_) < num_shards && shard_bits_ < 16) {
+        ++shard_bits_;
+    }
+    num_shards = size_t{1} << shard_bits_;
+    const size_t accounts_per_shard{std::max<size_t>(max_accounts / num_shards, 1)};
+    const size_t slots_per_shard{std::max<size_t>(max_storage_slots / num_shards, 1)};
+    shards_.reserve(num_shards);
+    for (size_t i{0}; i < num_shards; ++i) {
+        shards_.push_back(std::make_unique<Shard>(accounts_per_shard, slots_per_shard));
+    }
+}
+
+StateCache::Shard& StateCache::account_shard(const evmc::address& address) const noexcept {
+    return *shards_[shard_of(std::hash<evmc::address>{}(address), shard_bits_)];
+}
+
+StateCache::Shard& StateCache::storage_shard(const StorageKey& key) const noexcept {
+    return *shards_[shard_of(StorageKeyHash{}(key), shard_bits_)];
+}
+
+std::optional<std::optional<Account>> StateCache::get_account(const evmc::address& address) {
+    Shard& shard{account_shard(address)};
+    std::lock_guard lock{shard.mtx};
+    if (const std::optional<Account>* account{shard.accounts.get(address)}) {
+        ++shard.stats.account_hits;
+        return *account;
+    }
+    ++shard.stats.account_misses;
+    return std::nullopt;
+}
+
+void StateCache::put_account(const evmc::address& address, const std::optional<Account>& account) {
+    Shard& shard{account_shard(address)};
+    std::lock_guard lock{shard.mtx};
+    shard.accounts.put(address, account);
+}
+
+std::optional<evmc::bytes32> StateCache::get_storage(const evmc::address& address, uint64_t incarnation,
+                                                     const evmc::bytes32& location) {
+    const StorageKey key{address, incarnation, location};
+    Shard& shard{storage_shard(key)};
+    std::lock_guard lock{shard.mtx};
+    if (const evmc::bytes32* value{shard.storage.get(key)}) {
+        ++shard.stats.storage_hits;
+        return *value;
+    }
+    ++shard.stats.storage_misses;
+    return std::nullopt;
+}
+
+void StateCache::put_storage(const evmc::address& address, uint64_t incarnation, const evmc::bytes32& location,
+                             const evmc::bytes32& value) {
+    const StorageKey key{address, incarnation, location};
+    Shard& shard{storage_shard(key)};
+    std::lock_guard lock{shard.mtx};
+    shard.storage.put(key, value);
+}
+
+void StateCache::set_block(uint64_t block_number, const evmc::bytes32& block_hash) {
+    std::lock_guard lock{block_mtx_};
+    block_number_ = block_number;
+    block_hash_ = block_hash;
+}
+
+bool StateCache::extends(const BlockHeader& header) const {
+    std::lock_guard lock{block_mtx_};
+    return block_number_.has_value() && header.number == *block_number_ + 1 && header.parent_hash == block_hash_;
+}
+
+void StateCache::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard lock{shard->mtx};
+        shard->accounts.clear();
+        shard->storage.clear();
+    }
+    std::lock_guard lock{block_mtx_};
+    block_number_.reset();
+}
+
+StateCache::Stats StateCache::stats() const {
+    Stats res{};
+    for (const auto& shard : shards_) {
+        std::lock_guard lock{shard->mtx};
+        res.account_hits += shard->stats.account_hits;
+        res.account_misses += shard->stats.account_misses;
+        res.storage_hits += shard->stats.storage_hits;
+        res.storage_misses += shard->stats.storage_misses;
+    }
+    return res;
+}
+
+}  // namespace silkworm::db
@@ -0,0 +1,135 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKWORM_DB_STATE_CACHE_HPP_
+#define SILKWORM_DB_STATE_CACHE_HPP_
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <silkworm/common/base.hpp>
+#include <silkworm/common/clock_cache.hpp>
+#include <silkworm/types/account.hpp>
+#include <silkworm/types/block.hpp>
+
+namespace silkworm::db {
+
+/*
+ * A size-bounded cache of current (i.e. non historical) plain state values shared
+ * by subsequent db::Buffer instances, so that hot accounts and storage slots
+ * need not be read from the database again after each batch.
+ *
+ * Entries are spread by key hash over num_shards independently locked CLOCK (approximated
+ * LRU) shards, hence the cache may be safely used from multiple threads and the storage of
+ * a single hot contract does not contend on one lock. Non existent accounts and zero storage
+ * values are cached as well.
+ *
+ * The cache reflects the plain state as of the block it has been last updated at (see
+ * set_block/extends); it's up to the owner to clear it whenever the state to be read
+ * does not descend from that block (e.g. after an unwind or an aborted transaction).
+ *
+ * Capacities are a matter of tuning: the hit/miss counters (see stats) tell whether they're worth growing.
+ */
+class StateCache {
+  public:
+    static constexpr size_t kDefaultNumShards{16};
+
+    struct Stats {
+        uint64_t account_hits{0};
+        uint64_t account_misses{0};
+        uint64_t storage_hits{0};
+        uint64_t storage_misses{0};
+    };
+
+    // Capacities are in number of entries over all shards; num_shards is rounded up to a power of 2
+    StateCache(size_t max_accounts, size_t max_storage_slots, size_t num_shards = kDefaultNumShards);
+
+    StateCache(const StateCache&) = delete;
+    StateCache& operator=(const StateCache&) = delete;
+
+    /** @brief Returns the cached account, if any.
+     *
+     * The outer std::nullopt means a cache miss; an inner std::nullopt means a cached non-existent account.
+     */
+    std::optional<std::optional<Account>> get_account(const evmc::address& address);
+
+    void put_account(const evmc::address& address, const std::optional<Account>& account);
+
+    // Returns std::nullopt on cache miss
+    std::optional<evmc::bytes32> get_storage(const evmc::address& address, uint64_t incarnation,
+                                             const evmc::bytes32& location);
+
+    void put_storage(const evmc::address& address, uint64_t incarnation, const evmc::bytes32& location,
+                     const evmc::bytes32& value);
+
+    // Marks the cache as reflecting the state right after the execution of the given block
+    void set_block(uint64_t block_number, const evmc::bytes32& block_hash);
+
+    // Whether the cache reflects the state right before the execution of the given block
+    bool extends(const BlockHeader& header) const;
+
+    // Drops all entries (but not the counters)
+    void clear();
+
+    Stats stats() const;
+
+    size_t max_accounts() const noexcept { return max_accounts_; }
+    size_t max_storage_slots() const noexcept { return max_storage_slots_; }
+    size_t num_shards() const noexcept { return shards_.size(); }
+
+  private:
+    struct StorageKey {
+        evmc::address address;
+        uint64_t incarnation{0};
+        evmc::bytes32 location;
+
+        friend bool operator==(const StorageKey& a, const StorageKey& b) {
+            return a.address == b.address && a.incarnation == b.incarnation && a.location == b.location;
+        }
+    };
+
+    struct StorageKeyHash {
+        size_t operator()(const StorageKey& key) const noexcept;
+    };
+
+    struct Shard {
+        Shard(size_t max_accounts, size_t max_storage_slots)
+            : accounts{max_accounts}, storage{max_storage_slots} {}
+
+        std::mutex mtx;
+        ClockCache<evmc::address, std::optional<Account>> accounts;
+        ClockCache<StorageKey, evmc::bytes32, StorageKeyHash> storage;
+        Stats stats;
+    };
+
+    Shard& account_shard(const evmc::address& address) const noexcept;
+    Shard& storage_shard(const StorageKey& key) const noexcept;
+
+    size_t max_accounts_;
+    size_t max_storage_slots_;
+    unsigned shard_bits_{0};  // log2 of the number of shards
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    mutable std::mutex block_mtx_;
+    std::optional<uint64_t> block_number_;
+    evmc::bytes32 block_hash_;
+};
+
+}  // namespace silkworm::db
+
+#endif  // SILKWORM_DB_STATE_CACHE_HPP_
@@ -0,0 +1,156 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "state_cache.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <silkworm/common/temp_dir.hpp>
+#include <silkworm/db/buffer.hpp>
+
+#include "tables.hpp"
+
+namespace silkworm::db {
+
+TEST_CASE("State cache") {
+    StateCache cache{/*max_accounts=*/1'000, /*max_storage_slots=*/1'000};
+
+    const auto address{0xbe00000000000000000000000000000000000000_address};
+    const auto location{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+    const auto value{0x00000000000000000000000000000000000000000000000000000000000000ff_bytes32};
+
+    CHECK(!cache.get_account(address));
+    cache.put_account(address, std::nullopt);
+    std::optional<std::optional<Account>> cached{cache.get_account(address)};
+    REQUIRE(cached);
+    CHECK(!cached->has_value());
+
+    Account account;
+    account.nonce = 12;
+    account.incarnation = 1;
+    cache.put_account(address, account);
+    cached = cache.get_account(address);
+    REQUIRE(cached);
+    CHECK(*cached == account);
+
+    CHECK(!cache.get_storage(address, 1, location));
+    cache.put_storage(address, 1, location, value);
+    CHECK(cache.get_storage(address, 1, location) == value);
+    CHECK(!cache.get_storage(address, 2, location));
+
+    StateCache::Stats stats{cache.stats()};
+    CHECK(stats.account_hits == 2);
+    CHECK(stats.account_misses == 1);
+    CHECK(stats.storage_hits == 1);
+    CHECK(stats.storage_misses == 2);
+
+    BlockHeader header;
+    header.number = 11;
+    header.parent_hash = 0x5e09a8ef4d5cbeb8fbd2ef5caf9d2bd1c79c5bd0d3a85d0b2a1f0d4c55e0ee9d_bytes32;
+    CHECK(!cache.extends(header));
+    cache.set_block(10, header.parent_hash);
+    CHECK(cache.extends(header));
+    header.number = 12;
+    CHECK(!cache.extends(header));
+
+    cache.clear();
+    header.number = 11;
+    CHECK(!cache.extends(header));
+    CHECK(!cache.get_account(address));
+    CHECK(!cache.get_storage(address, 1, location));
+}
+
+TEST_CASE("State cache size is bounded") {
+    static constexpr size_t kMaxAccounts{StateCache::kDefaultNumShards * 4};
+    StateCache cache{kMaxAccounts, /*max_storage_slots=*/1};
+
+    for (uint8_t i{0}; i < 200; ++i) {
+        evmc::address address;
+        address.bytes[0] = i;
+        cache.put_account(address, Account{});
+    }
+
+    size_t cached{0};
+    for (uint8_t i{0}; i < 200; ++i) {
+        evmc::address address;
+        address.bytes[0] = i;
+        cached += cache.get_account(address).has_value();
+    }
+    CHECK(cached <= kMaxAccounts);
+}
+
+TEST_CASE("State cache shards") {
+    const auto address{0xbe00000000000000000000000000000000000000_address};
+
+    StateCache single{/*max_accounts=*/10, /*max_storage_slots=*/10, /*num_shards=*/1};
+    CHECK(single.num_shards() == 1);
+    single.put_account(address, Account{});
+    CHECK(single.get_account(address));
+
+    StateCache cache{/*max_accounts=*/100, /*max_storage_slots=*/10, /*num_shards=*/3};
+    CHECK(cache.num_shards() == 4);
+    CHECK(cache.max_accounts() == 100);
+    cache.put_account(address, Account{});
+    CHECK(cache.get_account(address));
+}
+
+TEST_CASE("Buffer reads through state cache") {
+    TemporaryDirectory tmp_dir;
+    lmdb::DatabaseConfig db_config{tmp_dir.path(), 32 * kMebi};
+    db_config.set_readonly(false);
+    auto env{lmdb::get_env(db_config)};
+    auto txn{env->begin_rw_transaction()};
+    table::create_all(*txn);
+
+    StateCache cache{/*max_accounts=*/1'000, /*max_storage_slots=*/1'000};
+
+    const auto address{0xbe00000000000000000000000000000000000000_address};
+    const auto location{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+    const auto value{0x00000000000000000000000000000000000000000000000000000000000000ff_bytes32};
+    Account account;
+    account.balance = kEther;
+    account.incarnation = 1;
+
+    {
+        Buffer buffer{txn.get(), /*historical_block=*/std::nullopt, &cache};
+        buffer.begin_block(1);
+        CHECK(!buffer.read_account(address));
+        buffer.update_account(address, std::nullopt, account);
+        buffer.update_storage(address, 1, location, {}, value);
+        buffer.write_to_db();
+    }
+
+    // Written values have been cached : remove them from the DB behind the cache's back
+    auto state_table{txn->open(table::kPlainState)};
+    state_table->del(full_view(address));
+
+    Buffer buffer{txn.get(), /*historical_block=*/std::nullopt, &cache};
+    CHECK(buffer.read_account(address) == account);
+    CHECK(buffer.read_storage(address, 1, location) == value);
+
+    StateCache::Stats stats{cache.stats()};
+    CHECK(stats.account_hits == 1);
+    CHECK(stats.account_misses == 1);
+    CHECK(stats.storage_hits == 1);
+    CHECK(stats.storage_misses == 0);
+
+    // Historical readers don't use the cache
+    Buffer historical_buffer{txn.get(), /*historical_block=*/1, &cache};
+    CHECK(!historical_buffer.read_account(address));
+    CHECK(cache.stats().account_hits == 1);
+}
+
+}  // namespace silkworm::db
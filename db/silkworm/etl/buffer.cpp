@@ -17,6 +17,7 @@
 #include "buffer.hpp"
 
 #include <cassert>
+#include <future>
 
 namespace silkworm::etl {
 
@@ -33,7 +34,54 @@ void Buffer::put(const Entry& entry) {
     ++length_;
 }
 
-void Buffer::sort() { std::sort(buffer_.data(), buffer_.data() + length_); }
+void Buffer::sort(size_t num_threads) {
+    const auto begin{buffer_.begin()};
+    if (num_threads < 2 || length_ < kParallelSortThreshold) {
+        std::sort(begin, begin + static_cast<ptrdiff_t>(length_));
+        return;
+    }
+
+    // Split entries in contiguous runs and sort each of them on its own thread
+    const size_t run_length{(length_ + num_threads - 1) / num_threads};
+    std::vector<size_t> bounds;
+    for (size_t i{0}; i < length_; i += run_length) {
+        bounds.push_back(i);
+    }
+    bounds.push_back(length_);
+
+    std::vector<std::future<void>> tasks;
+    for (size_t i{0}; i + 1 < bounds.size(); ++i) {
+        tasks.push_back(std::async(std::launch::async, [begin, from{bounds[i]}, to{bounds[i + 1]}]() {
+            std::sort(begin + static_cast<ptrdiff_t>(from), begin + static_cast<ptrdiff_t>(to));
+        }));
+    }
+    for (auto& task : tasks) {
+        task.get();
+    }
+
+    // Merge adjacent sorted runs pairwise until only one is left
+    while (bounds.size() > 2) {
+        tasks.clear();
+        std::vector<size_t> merged_bounds;
+        for (size_t i{0}; i < bounds.size(); i += 2) {
+            merged_bounds.push_back(bounds[i]);
+            if (i + 2 < bounds.size()) {
+                tasks.push_back(std::async(
+                    std::launch::async, [begin, from{bounds[i]}, middle{bounds[i + 1]}, to{bounds[i + 2]}]() {
+                        std::inplace_merge(begin + static_cast<ptrdiff_t>(from), begin + static_cast<ptrdiff_t>(middle),
+                                           begin + static_cast<ptrdiff_t>(to));
+                    }));
+            }
+        }
+        if (merged_bounds.back() != bounds.back()) {
+            merged_bounds.push_back(bounds.back());
+        }
+        for (auto& task : tasks) {
+            task.get();
+        }
+        bounds.swap(merged_bounds);
+    }
+}
 
 size_t Buffer::size() const noexcept { return size_; }
 
@@ -29,6 +29,9 @@ namespace silkworm::etl {
 
 constexpr size_t kInitialBufferCapacity = 32768;
 
+// Below this number of entries a multi-threaded sort is not worth the threads overhead
+constexpr size_t kParallelSortThreshold = 65536;
+
 // In ETL, a buffer must be used stores entries, sort them and write them to file
 class Buffer {
   public:
@@ -38,11 +41,11 @@ class Buffer {
 
     explicit Buffer(size_t optimal_size) : optimal_size_(optimal_size), buffer_(kInitialBufferCapacity) {}
 
-    void put(const Entry& entry);     // Add a new entry to the buffer
-    void clear() noexcept;            // Set the buffer to contain 0 entries
-    bool overflows() const noexcept;  // Whether or not accounted size overflows optimal_size_ (i.e. time to flush)
-    void sort();                      // Sort buffer in increasing order by key comparison
-    size_t size() const noexcept;     // Actual size of accounted data
+    void put(const Entry& entry);       // Add a new entry to the buffer
+    void clear() noexcept;              // Set the buffer to contain 0 entries
+    bool overflows() const noexcept;    // Whether or not accounted size overflows optimal_size_ (i.e. time to flush)
+    void sort(size_t num_threads = 1);  // Sort buffer in increasing order by key comparison
+    size_t size() const noexcept;       // Actual size of accounted data
     gsl::span<const Entry> entries() const noexcept;
 
   private:
@@ -13,9 +13,11 @@
 
 #include "collector.hpp"
 
+#include <algorithm>
 #include <filesystem>
 #include <iomanip>
-#include <queue>
+#include <optional>
+#include <thread>
 
 #include <silkworm/common/log.hpp>
 #include <silkworm/common/temp_dir.hpp>
@@ -24,7 +26,95 @@ namespace silkworm::etl {
 
 namespace fs = std::filesystem;
 
+namespace {
+
+    /*
+     * A tournament tree of losers used to k-way merge sorted runs.
+     * Each leaf holds a view of the current head entry of one run: internal nodes
+     * hold the index of the run which lost the match in that subtree and the root
+     * holds the overall winner (i.e. the smallest key).
+     * Replacing the winner requires only log2(k) comparisons on key views and
+     * no entry is ever copied or moved across the tree.
+     */
+    class LoserTree {
+      public:
+        explicit LoserTree(std::vector<std::optional<EntryView>>& heads) : heads_{heads}, tree_(heads.size(), 0) {
+            const size_t k{heads_.size()};
+            if (k == 1) {
+                return;
+            }
+            // Bottom-up build : leaves are at positions [k, 2k)
+            std::vector<size_t> winners(2 * k);
+            for (size_t i{0}; i < k; ++i) {
+                winners[k + i] = i;
+            }
+            for (size_t node{k - 1}; node > 0; --node) {
+                const size_t left{winners[2 * node]};
+                const size_t right{winners[2 * node + 1]};
+                if (precedes(right, left)) {
+                    winners[node] = right;
+                    tree_[node] = left;
+                } else {
+                    winners[node] = left;
+                    tree_[node] = right;
+                }
+            }
+            tree_[0] = winners[1];
+        }
+
+        // Index of the run holding the smallest entry
+        size_t winner() const noexcept { return tree_[0]; }
+
+        // Whether or not all runs have been consumed
+        bool empty() const noexcept { return !heads_[tree_[0]].has_value(); }
+
+        // Replays the matches from the winner's leaf up to the root after its head has been replaced
+        void replay() {
+            const size_t k{heads_.size()};
+            size_t winner{tree_[0]};
+            for (size_t node{(winner + k) / 2}; node > 0; node /= 2) {
+                if (precedes(tree_[node], winner)) {
+                    std::swap(tree_[node], winner);
+                }
+            }
+            tree_[0] = winner;
+        }
+
+      private:
+        // Whether the head of run a has to be processed before the head of run b
+        // Exhausted runs always lose. Ties are resolved by run index to keep the merge stable
+        bool precedes(size_t a, size_t b) const {
+            const auto& entry_a{heads_[a]};
+            const auto& entry_b{heads_[b]};
+            if (!entry_a.has_value()) {
+                return false;
+            }
+            if (!entry_b.has_value()) {
+                return true;
+            }
+            const int diff{entry_a->key.compare(entry_b->key)};
+            if (diff != 0) {
+                return diff < 0;
+            }
+            const int value_diff{entry_a->value.compare(entry_b->value)};
+            if (value_diff != 0) {
+                return value_diff < 0;
+            }
+            return a < b;
+        }
+
+        std::vector<std::optional<EntryView>>& heads_;
+        std::vector<size_t> tree_;
+    };
+
+}  // namespace
+
 Collector::~Collector() {
+    try {
+        wait_pending_flush();
+    } catch (const std::exception& ex) {
+        SILKWORM_LOG(LogLevel::Error) << "ETL background flush failed : " << ex.what() << std::endl;
+    }
     file_providers_.clear();  // Will ensure all files (if any) have been orderly closed and deleted before we remove
                               // the working dir
     fs::path path(work_path_);
@@ -34,27 +124,62 @@ Collector::~Collector() {
 }
 
 void Collector::flush_buffer() {
-    if (buffer_.size()) {
-        SILKWORM_LOG(LogLevel::Info) << "Flushing Buffer File..." << std::endl;
-        buffer_.sort();
-
+    if (buffer_->size()) {
         /* Build a unique file name to pass FileProvider */
         fs::path new_file_path{fs::path(work_path_) / fs::path(std::to_string(unique_id_) + "-" +
                                                                std::to_string(file_providers_.size()) + ".bin")};
 
-        file_providers_.emplace_back(new FileProvider(new_file_path.string(), file_providers_.size()));
-        file_providers_.back()->flush(buffer_);
-        buffer_.clear();
+        // File providers are only ever added on calling thread
+        file_providers_.emplace_back(new FileProvider(new_file_path.string(), file_providers_.size(), file_format_));
+
+        if (!parallel_) {
+            SILKWORM_LOG(LogLevel::Info) << "Flushing Buffer File..." << std::endl;
+            buffer_->sort();
+            file_providers_.back()->flush(*buffer_);
+            buffer_->clear();
+            SILKWORM_LOG(LogLevel::Info) << "Buffer Flushed" << std::endl;
+            return;
+        }
+
+        // Only one flush at a time in background : the other buffer must be available
+        // to keep collecting
+        wait_pending_flush();
+        if (!flushing_buffer_) {
+            flushing_buffer_ = std::make_unique<Buffer>(optimal_size_);
+        }
+        buffer_.swap(flushing_buffer_);
+
+        SILKWORM_LOG(LogLevel::Info) << "Flushing Buffer File in background..." << std::endl;
+        pending_flush_ = std::async(std::launch::async, [buffer{flushing_buffer_.get()},
+                                                         file_provider{file_providers_.back().get()},
+                                                         num_threads{sort_threads()}]() {
+            buffer->sort(num_threads);
+            file_provider->flush(*buffer);
+            buffer->clear();
+        });
+    }
+}
+
+void Collector::wait_pending_flush() {
+    if (pending_flush_.valid()) {
+        pending_flush_.get();  // Rethrows any exception occurred in background
         SILKWORM_LOG(LogLevel::Info) << "Buffer Flushed" << std::endl;
     }
 }
 
+size_t Collector::sort_threads() const {
+    if (!parallel_) {
+        return 1;
+    }
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
 size_t Collector::size() const { return size_; }
 
 void Collector::collect(const Entry& entry) {
-    buffer_.put(entry);
+    buffer_->put(entry);
     ++size_;
-    if (buffer_.overflows()) {
+    if (buffer_->overflows()) {
         flush_buffer();
     }
 }
@@ -74,11 +199,11 @@ void Collector::load(silkworm::lmdb::Table* table, LoadFunc load_func, unsigned
     uint32_t actual_progress{0};
 
     if (file_providers_.empty()) {
-        buffer_.sort();
+        buffer_->sort(sort_threads());
 
-        for (const auto& etl_entry : buffer_.entries()) {
+        for (const auto& etl_entry : buffer_->entries()) {
             if (load_func) {
-                load_func(etl_entry, table, db_flags);
+                load_func(EntryView{etl_entry.key, etl_entry.value}, table, db_flags);
             } else {
                 table->put(etl_entry.key, etl_entry.value, db_flags);
             }
@@ -91,32 +216,29 @@ void Collector::load(silkworm::lmdb::Table* table, LoadFunc load_func, unsigned
             }
         }
 
-        buffer_.clear();
+        buffer_->clear();
         return;
     }
 
     // Flush not overflown buffer data to file
+    // and ensure all files have been completely written
     flush_buffer();
+    wait_pending_flush();
+    flushing_buffer_.reset();
 
-    // Define a priority queue based on smallest available key
-    auto key_comparer = [](std::pair<Entry, int> left, std::pair<Entry, int> right) {
-        return right.first < left.first;
-    };
-    std::priority_queue<std::pair<Entry, int>, std::vector<std::pair<Entry, int>>, decltype(key_comparer)> queue(
-        key_comparer);
-
-    // Read one "record" from each data_provider and let the queue
-    // sort them. On top of the queue the smallest key
+    // Read one "record" from each data_provider and let the
+    // tree sort them. On top of the tree the smallest key
+    std::vector<std::optional<EntryView>> heads;
+    heads.reserve(file_providers_.size());
     for (auto& file_provider : file_providers_) {
-        auto item{file_provider->read_entry()};
-        if (item.has_value()) {
-            queue.push(*item);
-        }
+        heads.push_back(file_provider->read_entry());
     }
+    LoserTree tree(heads);
 
-    // Process the queue from smallest to largest key
-    while (queue.size()) {
-        auto& [etl_entry, provider_index]{queue.top()};           // Pick smallest key by reference
+    // Process the tree from smallest to largest key
+    while (!tree.empty()) {
+        const size_t provider_index{tree.winner()};               // Pick smallest key
+        const EntryView etl_entry{*heads[provider_index]};        // (a view into mapped file)
         auto& file_provider{file_providers_.at(provider_index)};  // and set current file provider
 
         // Process linked pairs
@@ -135,20 +257,12 @@ void Collector::load(silkworm::lmdb::Table* table, LoadFunc load_func, unsigned
         }
 
         // From the provider which has served the current key
-        // read next "record"
-        auto next{file_provider->read_entry()};
-
-        // At this point `current` has been processed.
-        // We can remove it from the queue
-        queue.pop();
-
-        // Add next item to the queue only if it has
-        // meaningful data
-        if (next.has_value()) {
-            queue.push(*next);
-        } else {
+        // read next "record" and let it replace the processed one
+        heads[provider_index] = file_provider->read_entry();
+        if (!heads[provider_index].has_value()) {
             file_provider.reset();
         }
+        tree.replay();
     }
     size_ = 0;  // We have consumed all items
 }
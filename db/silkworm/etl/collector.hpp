@@ -14,6 +14,8 @@
 #ifndef SILKWORM_ETL_COLLECTOR_HPP_
 #define SILKWORM_ETL_COLLECTOR_HPP_
 
+#include <future>
+
 #include <silkworm/db/chaindb.hpp>
 #include <silkworm/etl/buffer.hpp>
 #include <silkworm/etl/file_provider.hpp>
@@ -27,7 +29,8 @@ namespace silkworm::etl {
 constexpr size_t kOptimalBufferSize = 256 * kMebi;
 
 // Function pointer to process Load on before Load data into tables
-typedef void (*LoadFunc)(Entry, lmdb::Table*, unsigned int);
+// Views passed to the function are valid only for the duration of the call
+typedef void (*LoadFunc)(EntryView, lmdb::Table*, unsigned int);
 
 // Collects data Extracted from db
 class Collector {
@@ -36,8 +39,21 @@ class Collector {
     Collector(const Collector&) = delete;
     Collector& operator=(const Collector&) = delete;
 
-    explicit Collector(const char* work_path = nullptr, size_t optimal_size = kOptimalBufferSize)
-        : work_path_{set_work_path(work_path)}, buffer_{optimal_size} {}
+    /** @brief Creates a new collector
+     *
+     * @param work_path : Directory where buffers get flushed. If NULL a unique temporary directory is created
+     * @param optimal_size : Accounted size of a buffer triggering a flush to disk
+     * @param parallel : When true flushes are sorted (on multiple threads) and written in background while a second
+     * buffer keeps collecting entries. Requires up to twice optimal_size of memory.
+     * @param file_format : Format of flushed files. FileFormat::kCompressed trades some CPU for less disk usage and I/O
+     */
+    explicit Collector(const char* work_path = nullptr, size_t optimal_size = kOptimalBufferSize, bool parallel = false,
+                       FileFormat file_format = FileFormat::kRaw)
+        : work_path_{set_work_path(work_path)},
+          optimal_size_{optimal_size},
+          parallel_{parallel},
+          file_format_{file_format},
+          buffer_{std::make_unique<Buffer>(optimal_size)} {}
 
     ~Collector();
 
@@ -59,10 +75,18 @@ class Collector {
 
   private:
     std::string set_work_path(const char* provided_work_path);
-    void flush_buffer();  // Write buffer to file
+    void flush_buffer();          // Write buffer to file (in background if parallel_)
+    void wait_pending_flush();    // Blocks until background flush (if any) has completed
+    size_t sort_threads() const;  // Number of threads to sort a buffer with
 
     std::string work_path_;
-    Buffer buffer_;
+    size_t optimal_size_;
+    bool parallel_;
+    FileFormat file_format_;
+
+    std::unique_ptr<Buffer> buffer_;           // Buffer actually collecting entries
+    std::unique_ptr<Buffer> flushing_buffer_;  // Buffer being flushed in background (parallel_ only)
+    std::future<void> pending_flush_;          // Completion of background flush (parallel_ only)
 
     /*
      * TL;DR; In no way two instances of collector can have
@@ -13,6 +13,7 @@
 
 #include "collector.hpp"
 
+#include <algorithm>
 #include <filesystem>
 #include <set>
 
@@ -47,7 +48,7 @@ static std::vector<Entry> generate_entry_set(size_t size) {
     return pairs;
 }
 
-void run_collector_test(LoadFunc load_func) {
+void run_collector_test(LoadFunc load_func, bool parallel = false, FileFormat file_format = FileFormat::kRaw) {
     TemporaryDirectory db_tmp_dir;
     TemporaryDirectory etl_tmp_dir;
     // Initialize random seed
@@ -59,28 +60,53 @@ void run_collector_test(LoadFunc load_func) {
     auto txn{env->begin_rw_transaction()};
     // Generate Test Entries
     auto set{generate_entry_set(1000)};                       // 1000 entries in total
-    auto collector{Collector(etl_tmp_dir.path(), 100 * 16)};  // 100 entries per file (16 bytes per entry)
+    // 100 entries per file (16 bytes per entry)
+    auto collector{Collector(etl_tmp_dir.path(), 100 * 16, parallel, file_format)};
     db::table::create_all(*txn);
     // Collection
     for (auto entry : set) {
         collector.collect(entry);
     }
     // Check whether temporary files were generated
-    CHECK(std::distance(fs::directory_iterator{etl_tmp_dir.path()}, fs::directory_iterator{}) == 10);
+    // (in parallel mode last file may still be in the making)
+    if (!parallel) {
+        CHECK(std::distance(fs::directory_iterator{etl_tmp_dir.path()}, fs::directory_iterator{}) == 10);
+    }
     // Load data
     auto to{txn->open(db::table::kHeaderNumbers)};
     collector.load(to.get(), load_func);
     // Check wheter temporary files were cleaned
     CHECK(std::distance(fs::directory_iterator{etl_tmp_dir.path()}, fs::directory_iterator{}) == 0);
+    // Check all entries have been loaded in order
+    if (!load_func) {
+        size_t count{0};
+        CHECK(to->get_rcount(&count) == MDB_SUCCESS);
+        CHECK(count == set.size());
+        std::sort(set.begin(), set.end());
+        auto data{to->seek(ByteView{})};
+        for (const auto& entry : set) {
+            REQUIRE(data.has_value());
+            CHECK(data->key == entry.key);
+            CHECK(data->value == entry.value);
+            data = to->get_next();
+        }
+    }
 }
 
 TEST_CASE("collect_and_default_load") { run_collector_test(nullptr); }
 
 TEST_CASE("collect_and_load") {
-    run_collector_test([](Entry entry, lmdb::Table* table, unsigned int) {
-        entry.key.at(0) = 1;
-        table->put(entry.key, entry.value);
+    run_collector_test([](EntryView entry, lmdb::Table* table, unsigned int) {
+        Bytes key{entry.key};
+        key.at(0) = 1;
+        table->put(key, entry.value);
     });
 }
 
+TEST_CASE("collect_and_default_load_parallel") { run_collector_test(nullptr, /*parallel=*/true); }
+
+TEST_CASE("collect_and_default_load_compressed") {
+    run_collector_test(nullptr, /*parallel=*/false, FileFormat::kCompressed);
+}
+
 }  // namespace silkworm::etl
\ No newline at end of file
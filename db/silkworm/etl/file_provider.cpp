@@ -16,22 +16,54 @@
 
 #include "file_provider.hpp"
 
+#include <cstring>
 #include <filesystem>
 
+#include <lz4.h>
+
 #include <silkworm/common/cast.hpp>
+#include <silkworm/common/util.hpp>
 
 namespace silkworm::etl {
 
 namespace fs = std::filesystem;
 
+namespace {
+
+    // LEB128 encoding of unsigned integers
+    void encode_varint(Bytes& out, size_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool decode_varint(ByteView& in, size_t& value) {
+        value = 0;
+        for (unsigned shift{0}; shift < 64; shift += 7) {
+            if (in.empty()) {
+                return false;
+            }
+            const uint8_t byte{in[0]};
+            in.remove_prefix(1);
+            value |= static_cast<size_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+}  // namespace
+
 // https://abseil.io/tips/117
-FileProvider::FileProvider(std::string file_name, size_t id) : id_{id}, file_name_{std::move(file_name)} {}
+FileProvider::FileProvider(std::string file_name, size_t id, FileFormat format)
+    : id_{id}, format_{format}, file_name_{std::move(file_name)} {}
 
 FileProvider::~FileProvider(void) { reset(); }
 
 void FileProvider::flush(Buffer &buffer) {
-    head_t head{};
-
     // Check we have enough space to store all data
     auto entries{buffer.entries()};
     file_size_ = {buffer.size() + entries.size() * sizeof(head_t)};
@@ -48,58 +80,197 @@ void FileProvider::flush(Buffer &buffer) {
         throw etl_error(strerror(errno));
     };
 
+    if (format_ == FileFormat::kCompressed) {
+        write_compressed(entries);
+    } else {
+        write_raw(entries);
+    }
+
+    // Close file in output mode and map it for input
+    // Closing is actually not strictly needed but amends an odd behavior on Windows
+    // which prevents correct display of file size if the handle
+    // has not been closed
+    file_.close();
+    map_file();
+}
+
+void FileProvider::write_raw(gsl::span<const Entry> entries) {
+    head_t head{};
     for (const auto &entry : entries) {
         head.lengths[0] = entry.key.size();
         head.lengths[1] = entry.value.size();
         if (!file_.write(byte_ptr_cast(head.bytes), 8) ||
             !file_.write(byte_ptr_cast(entry.key.data()), entry.key.size()) ||
             !file_.write(byte_ptr_cast(entry.value.data()), entry.value.size())) {
-            auto err{errno};
-            reset();
-            throw etl_error(strerror(err));
+            throw_error(strerror(errno));
         }
     }
+}
 
-    // Close file in output mode and reopen for input mode
-    // This is actually not strictly needed but amends an odd behavior on Windows
-    // which prevents correct display of file size if the handle
-    // has not been closed
-    file_.close();
-    file_.open(file_name_, std::ios_base::in | std::ios_base::binary);
-    if (!file_.is_open()) {
-        auto err{errno};
-        reset();
-        throw etl_error(strerror(err));
-    };
+/*
+ * Entries are grouped in blocks of about kCompressedBlockSize bytes. Within a block
+ * each entry is encoded as
+ * [varint shared key prefix length][varint key suffix length][varint value length][key suffix][value]
+ * where the shared prefix is relative to the previous key in the same block (so each block
+ * can be decoded on its own). Each block is then LZ4 compressed and written as
+ * [8-byte header : raw size, compressed size][compressed block]
+ */
+void FileProvider::write_compressed(gsl::span<const Entry> entries) {
+    file_size_ = 0;  // Compressed size is only known while writing
+
+    Bytes block;
+    block.reserve(kCompressedBlockSize + kCompressedBlockSize / 2);
+    Bytes compressed;
+    ByteView previous_key{};
+
+    auto write_block{[&]() {
+        const int bound{LZ4_compressBound(static_cast<int>(block.size()))};
+        compressed.resize(static_cast<size_t>(bound));
+        const int compressed_size{LZ4_compress_default(byte_ptr_cast(block.data()), byte_ptr_cast(compressed.data()),
+                                                       static_cast<int>(block.size()), bound)};
+        if (compressed_size <= 0) {
+            throw_error("Block compression failed");
+        }
+        head_t head{};
+        head.lengths[0] = static_cast<uint32_t>(block.size());
+        head.lengths[1] = static_cast<uint32_t>(compressed_size);
+        if (!file_.write(byte_ptr_cast(head.bytes), 8) ||
+            !file_.write(byte_ptr_cast(compressed.data()), compressed_size)) {
+            throw_error(strerror(errno));
+        }
+        file_size_ += sizeof(head_t) + static_cast<size_t>(compressed_size);
+        block.clear();
+    }};
+
+    for (const auto &entry : entries) {
+        const size_t shared{block.empty() ? 0 : prefix_length(previous_key, entry.key)};
+        encode_varint(block, shared);
+        encode_varint(block, entry.key.size() - shared);
+        encode_varint(block, entry.value.size());
+        block.append(entry.key, shared);
+        block.append(entry.value);
+        previous_key = entry.key;
+        if (block.size() >= kCompressedBlockSize) {
+            write_block();
+        }
+    }
+    if (!block.empty()) {
+        write_block();
+    }
 }
 
-std::optional<std::pair<Entry, int>> FileProvider::read_entry() {
-    head_t head{};
+void FileProvider::map_file() {
+    namespace bip = boost::interprocess;
+    try {
+        file_mapping_ = std::make_unique<bip::file_mapping>(file_name_.c_str(), bip::read_only);
+        mapped_region_ = std::make_unique<bip::mapped_region>(*file_mapping_, bip::read_only, 0, file_size_);
+    } catch (const bip::interprocess_exception &ex) {
+        reset();
+        throw etl_error(ex.what());
+    }
+
+    // Data is consumed strictly sequentially: let the OS read ahead aggressively
+    // and drop pages behind (i.e. madvise(MADV_SEQUENTIAL))
+    (void)mapped_region_->advise(bip::mapped_region::advice_sequential);
+    read_offset_ = 0;
+}
 
-    if (!file_.is_open() || !file_size_) {
+std::optional<EntryView> FileProvider::read_entry() {
+    if (!mapped_region_ || !file_size_) {
         throw etl_error("Invalid file handle");
     }
 
-    if (!file_.read(byte_ptr_cast(head.bytes), 8)) {
+    if (format_ == FileFormat::kCompressed) {
+        return read_compressed_entry();
+    }
+
+    if (read_offset_ == file_size_) {
         reset();
         return std::nullopt;
     }
 
-    Entry entry{Bytes(head.lengths[0], '\0'), Bytes(head.lengths[1], '\0')};
-    if (!file_.read(byte_ptr_cast(entry.key.data()), head.lengths[0]) ||
-        !file_.read(byte_ptr_cast(entry.value.data()), head.lengths[1])) {
-        auto err{errno};
-        reset();
-        throw etl_error(strerror(err));
+    const auto data{static_cast<const uint8_t *>(mapped_region_->get_address())};
+    head_t head{};
+    if (file_size_ - read_offset_ < sizeof(head_t)) {
+        throw_error("Unexpected end of file");
+    }
+    std::memcpy(head.bytes, &data[read_offset_], sizeof(head_t));
+    read_offset_ += sizeof(head_t);
+
+    const size_t entry_size{static_cast<size_t>(head.lengths[0]) + head.lengths[1]};
+    if (file_size_ - read_offset_ < entry_size) {
+        throw_error("Unexpected end of file");
+    }
+    EntryView entry{ByteView{&data[read_offset_], head.lengths[0]},
+                    ByteView{&data[read_offset_ + head.lengths[0]], head.lengths[1]}};
+    read_offset_ += entry_size;
+    return entry;
+}
+
+std::optional<EntryView> FileProvider::read_compressed_entry() {
+    if (block_offset_ == block_.size()) {
+        if (read_offset_ == file_size_) {
+            reset();
+            return std::nullopt;
+        }
+
+        // Decompress next block
+        const auto data{static_cast<const uint8_t *>(mapped_region_->get_address())};
+        head_t head{};
+        if (file_size_ - read_offset_ < sizeof(head_t)) {
+            throw_error("Unexpected end of file");
+        }
+        std::memcpy(head.bytes, &data[read_offset_], sizeof(head_t));
+        read_offset_ += sizeof(head_t);
+        if (file_size_ - read_offset_ < head.lengths[1]) {
+            throw_error("Unexpected end of file");
+        }
+        block_.resize(head.lengths[0]);
+        const int raw_size{LZ4_decompress_safe(byte_ptr_cast(&data[read_offset_]), byte_ptr_cast(block_.data()),
+                                               static_cast<int>(head.lengths[1]), static_cast<int>(head.lengths[0]))};
+        if (raw_size < 0 || static_cast<size_t>(raw_size) != head.lengths[0]) {
+            throw_error("Block decompression failed");
+        }
+        read_offset_ += head.lengths[1];
+        block_offset_ = 0;
+    }
+
+    ByteView data{block_};
+    data.remove_prefix(block_offset_);
+    const size_t available{data.size()};
+    size_t shared{0}, suffix_length{0}, value_length{0};
+    if (!decode_varint(data, shared) || !decode_varint(data, suffix_length) || !decode_varint(data, value_length) ||
+        shared > key_.size() || data.size() < suffix_length || data.size() - suffix_length < value_length) {
+        throw_error("Corrupted block");
     }
 
-    return std::make_pair(entry, id_);
+    key_.resize(shared);
+    key_.append(data.substr(0, suffix_length));
+    EntryView entry{key_, data.substr(suffix_length, value_length)};
+    block_offset_ += available - data.size() + suffix_length + value_length;
+    return entry;
+}
+
+void FileProvider::throw_error(const char *message) {
+    const std::string what{message};  // Copy before reset() possibly alters errno description
+    reset();
+    throw etl_error(what);
 }
 
 void FileProvider::reset() {
+    const bool has_file{file_.is_open() || file_size_ != 0};
     file_size_ = 0;
+    read_offset_ = 0;
+    block_.clear();
+    block_offset_ = 0;
+    key_.clear();
+    // Mapping must be released before file gets removed
+    mapped_region_.reset();
+    file_mapping_.reset();
     if (file_.is_open()) {
         file_.close();
+    }
+    if (has_file) {
         fs::remove(file_name_.c_str());
     }
 }
@@ -108,4 +279,6 @@ std::string FileProvider::get_file_name(void) const { return file_name_; }
 
 size_t FileProvider::get_file_size(void) const { return file_size_; }
 
+size_t FileProvider::get_id(void) const { return id_; }
+
 }  // namespace silkworm::etl
@@ -21,31 +21,68 @@
 #include <memory>
 #include <optional>
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
 #include <silkworm/etl/buffer.hpp>
 #include <silkworm/etl/util.hpp>
 
 namespace silkworm::etl {
 
+// Format of data flushed to disk
+enum class FileFormat {
+    kRaw,         // Sequence of [8-byte header][key][value]
+    kCompressed,  // Sequence of [8-byte header][LZ4 block] each holding prefix compressed keys and their values
+};
+
+// Target size of uncompressed data in each block of FileFormat::kCompressed
+constexpr size_t kCompressedBlockSize = 64 * kKibi;
+
 /**
  * Provides an abstraction to flush data to disk
- * and re-read flushed data sequentially
+ * and re-read flushed data sequentially.
+ * Flushed data is read back through a memory mapping
+ * hence no copy nor allocation occurs while reading.
  */
 class FileProvider {
   public:
-    FileProvider(std::string file_name, size_t id);
+    FileProvider(std::string file_name, size_t id, FileFormat format = FileFormat::kRaw);
     ~FileProvider(void);
-    void flush(Buffer& buffer);                         // Write buffer's contents to disk
-    std::optional<std::pair<Entry, int>> read_entry();  // Read next data element from file starting from position 0
-    void reset();                                       // Remove the file when eof is met
+    void flush(Buffer& buffer);  // Write buffer's contents to disk
+
+    /** @brief Reads next data element from file starting from position 0
+     *
+     * Warning: returned views point into the memory mapped file and are valid
+     * only until next call to read_entry() or reset()
+     */
+    std::optional<EntryView> read_entry();
+
+    void reset();  // Remove the file when eof is met
 
     std::string get_file_name(void) const;
     size_t get_file_size(void) const;
+    size_t get_id(void) const;
 
   private:
+    void write_raw(gsl::span<const Entry> entries);         // Writes entries as FileFormat::kRaw
+    void write_compressed(gsl::span<const Entry> entries);  // Writes entries as FileFormat::kCompressed
+    void map_file();                                        // Maps flushed file in memory for sequential reading
+    std::optional<EntryView> read_compressed_entry();       // Reads next data element in FileFormat::kCompressed
+    [[noreturn]] void throw_error(const char* message);     // Removes the file and throws
+
     size_t id_;
-    std::fstream file_;      // Actual file stream
+    FileFormat format_;
+    std::fstream file_;      // Actual file stream (used only for writing)
     std::string file_name_;  // Actual name of file
     size_t file_size_{0};    // Actual size of written data
+
+    std::unique_ptr<boost::interprocess::file_mapping> file_mapping_{nullptr};   // Mapping of file
+    std::unique_ptr<boost::interprocess::mapped_region> mapped_region_{nullptr};  // Mapped view of whole file
+    size_t read_offset_{0};                                                       // Position of next data element
+
+    Bytes block_;             // Decompressed current block (FileFormat::kCompressed only)
+    size_t block_offset_{0};  // Position of next data element in current block
+    Bytes key_;               // Last decoded key (FileFormat::kCompressed only)
 };
 
 }  // namespace silkworm::etl
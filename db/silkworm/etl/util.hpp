@@ -43,6 +43,12 @@ struct Entry {
 
 bool operator<(const Entry& a, const Entry& b);
 
+// A non owning view of a data chunk in buffer or in a memory mapped file
+struct EntryView {
+    ByteView key;
+    ByteView value;
+};
+
 }  // namespace silkworm::etl
 
 #endif  // SILKWORM_ETL_UTIL_HPP_
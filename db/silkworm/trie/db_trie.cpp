@@ -16,62 +16,258 @@
 
 #include "db_trie.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <cassert>
+#include <thread>
 
 #include <boost/endian/conversion.hpp>
 
 #include <silkworm/common/log.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/db/access_layer.hpp>
 #include <silkworm/db/tables.hpp>
 
 namespace silkworm::trie {
 
-AccountTrieCursor::AccountTrieCursor(lmdb::Transaction&) {}
+void PrefixSet::insert(ByteView key) {
+    keys_.emplace_back(key);
+    sorted_ = false;
+}
 
-Bytes AccountTrieCursor::first_uncovered_prefix() {
-    // TODO[Issue 179] implement
-    return {};
+void PrefixSet::ensure_sorted() {
+    if (!sorted_) {
+        std::sort(keys_.begin(), keys_.end());
+        keys_.erase(std::unique(keys_.begin(), keys_.end()), keys_.end());
+        sorted_ = true;
+        index_ = 0;
+    }
 }
 
-std::optional<Bytes> AccountTrieCursor::key() const {
-    // TODO[Issue 179] implement
-    return std::nullopt;
+bool PrefixSet::contains(ByteView prefix) {
+    ensure_sorted();
+    if (keys_.empty()) {
+        return false;
+    }
+
+    // index_ points at the first key >= the previous prefix
+    while (index_ > 0 && keys_[index_ - 1] >= prefix) {
+        --index_;
+    }
+    while (index_ < keys_.size() && keys_[index_] < prefix) {
+        ++index_;
+    }
+    return index_ < keys_.size() && has_prefix(keys_[index_], prefix);
 }
 
-void AccountTrieCursor::next() {
-    // TODO[Issue 179] implement
+TrieCursor::TrieCursor(std::unique_ptr<lmdb::Table> table, PrefixSet& changed)
+    : table_{std::move(table)}, changed_{changed} {}
+
+void TrieCursor::start(ByteView prefix) {
+    prefix_ = prefix;
+    stack_.clear();
+    consume_node(/*to=*/{}, /*exact=*/true);
 }
 
-bool AccountTrieCursor::can_skip_state() const {
-    // TODO[Issue 179] implement
-    return false;
+void TrieCursor::consume_node(ByteView to, bool exact) {
+    Bytes db_key{prefix_};
+    db_key.append(to);
+
+    std::optional<db::Entry> entry;
+    if (exact) {
+        // LMDB doesn't allow empty keys, hence there's no stored root in the account trie
+        if (!db_key.empty()) {
+            if (std::optional<ByteView> value{table_->get(db_key)}; value) {
+                entry = db::Entry{db_key, *value};
+            }
+        }
+    } else {
+        entry = table_->seek(db_key);
+        if (!entry || !has_prefix(entry->key, prefix_)) {
+            stack_.clear();  // end of the trie
+            return;
+        }
+    }
+
+    Bytes key;
+    key.append(exact ? to : entry->key.substr(prefix_.length()));
+
+    std::optional<Node> node;
+    if (entry) {
+        node = unmarshal_node(entry->value);
+        assert(node->state_mask());
+    }
+
+    int nibble{-1};
+    if (node && !node->root_hash()) {
+        nibble = 0;
+        while ((node->state_mask() & (1u << nibble)) == 0) {
+            ++nibble;
+        }
+    }
+
+    if (!key.empty() && !stack_.empty()) {
+        // The root might have no node and thus no state bits, so we rely on the DB
+        stack_[0].nibble = key[0];
+    }
+
+    stack_.push_back(SubNode{std::move(key), std::move(node), nibble});
+
+    update_skip_state();
+
+    // The node is going to be regenerated unless it's a root skipped over entirely
+    if (entry && (!can_skip_state_ || nibble != -1)) {
+        lmdb::err_handler(table_->del_current());
+    }
 }
 
-StorageTrieCursor::StorageTrieCursor(lmdb::Transaction&) {}
+void TrieCursor::next() {
+    if (stack_.empty()) {
+        return;  // end of the trie
+    }
 
-Bytes StorageTrieCursor::seek_to_account(ByteView) {
-    // TODO[Issue 179] implement
-    return {};
+    if (!can_skip_state_ && children_are_in_trie()) {
+        // go to the child node
+        if (stack_.back().nibble < 0) {
+            move_to_next_sibling(/*allow_root_to_child_nibble_within_subnode=*/true);
+        } else {
+            consume_node(*key(), /*exact=*/false);
+        }
+    } else {
+        move_to_next_sibling(/*allow_root_to_child_nibble_within_subnode=*/false);
+    }
+
+    update_skip_state();
 }
 
-Bytes StorageTrieCursor::first_uncovered_prefix() {
-    // TODO[Issue 179] implement
-    return Bytes(1, '\0');
+void TrieCursor::move_to_next_sibling(bool allow_root_to_child_nibble_within_subnode) {
+    while (!stack_.empty()) {
+        SubNode& sn{stack_.back()};
+
+        if (sn.nibble >= 15 || (sn.nibble < 0 && !allow_root_to_child_nibble_within_subnode)) {
+            // this node is fully traversed
+            stack_.pop_back();
+            allow_root_to_child_nibble_within_subnode = false;
+            continue;
+        }
+
+        ++sn.nibble;
+
+        if (!sn.node) {
+            // we can't rely on the state flag, so search in the DB
+            consume_node(*key(), /*exact=*/false);
+            return;
+        }
+
+        for (; sn.nibble < 16; ++sn.nibble) {
+            if (sn.state_flag()) {
+                return;
+            }
+        }
+
+        // this node is fully traversed
+        stack_.pop_back();
+        allow_root_to_child_nibble_within_subnode = false;
+    }
 }
 
-std::optional<Bytes> StorageTrieCursor::key() const {
-    // TODO[Issue 179] implement
-    return std::nullopt;
+void TrieCursor::update_skip_state() {
+    const std::optional<Bytes> k{key()};
+    if (!k || changed_.contains(prefix_ + *k)) {
+        can_skip_state_ = false;
+    } else {
+        can_skip_state_ = stack_.back().hash_flag();
+    }
 }
 
-void StorageTrieCursor::next() {
-    // TODO[Issue 179] implement
+std::optional<Bytes> TrieCursor::key() const {
+    if (stack_.empty()) {
+        return std::nullopt;
+    }
+    return stack_.back().full_key();
+}
+
+const evmc::bytes32* TrieCursor::hash() const {
+    if (stack_.empty()) {
+        return nullptr;
+    }
+    return stack_.back().hash();
+}
+
+bool TrieCursor::children_are_in_trie() const {
+    if (stack_.empty()) {
+        return false;
+    }
+    return stack_.back().tree_flag();
+}
+
+std::optional<Bytes> TrieCursor::first_uncovered_prefix() const {
+    std::optional<Bytes> k{key()};
+    if (can_skip_state_ && k) {
+        k = increment_key(*k);
+    }
+    if (!k) {
+        return std::nullopt;
+    }
+    return pack_nibbles(*k);
+}
+
+Bytes TrieCursor::SubNode::full_key() const {
+    Bytes out{key};
+    if (nibble >= 0) {
+        out.push_back(static_cast<uint8_t>(nibble));
+    }
+    return out;
+}
+
+bool TrieCursor::SubNode::state_flag() const {
+    if (nibble < 0 || !node) {
+        return true;
+    }
+    return node->state_mask() & (1u << nibble);
+}
+
+bool TrieCursor::SubNode::tree_flag() const {
+    if (nibble < 0) {
+        return true;
+    }
+    if (!node) {
+        return false;
+    }
+    return node->tree_mask() & (1u << nibble);
 }
 
-bool StorageTrieCursor::can_skip_state() const {
-    // TODO[Issue 179] implement
-    return false;
+bool TrieCursor::SubNode::hash_flag() const {
+    if (!node) {
+        return false;
+    }
+    if (nibble < 0) {
+        return node->root_hash().has_value();
+    }
+    return node->hash_mask() & (1u << nibble);
+}
+
+const evmc::bytes32* TrieCursor::SubNode::hash() const {
+    if (!hash_flag()) {
+        return nullptr;
+    }
+    if (nibble < 0) {
+        return &*node->root_hash();
+    }
+    const uint16_t preceding_nibbles_mask{static_cast<uint16_t>((1u << nibble) - 1)};
+    const size_t index{std::bitset<16>(node->hash_mask() & preceding_nibbles_mask).count()};
+    return &node->hashes()[index];
 }
 
+AccountTrieCursor::AccountTrieCursor(lmdb::Transaction& txn, PrefixSet& changed)
+    : TrieCursor{txn.open(db::table::kTrieOfAccounts), changed} {
+    start(/*prefix=*/{});
+}
+
+StorageTrieCursor::StorageTrieCursor(lmdb::Transaction& txn, PrefixSet& changed)
+    : TrieCursor{txn.open(db::table::kTrieOfStorage), changed} {}
+
 DbTrieLoader::DbTrieLoader(lmdb::Transaction& txn, etl::Collector& account_collector, etl::Collector& storage_collector)
     : txn_{txn}, storage_collector_{storage_collector} {
     hb_.node_collector = [&account_collector](ByteView unpacked_key, const Node& node) {
@@ -89,101 +285,231 @@ DbTrieLoader::DbTrieLoader(lmdb::Transaction& txn, etl::Collector& account_colle
 // calculate_root algo:
 //  for iterateIHOfAccounts {
 //      if canSkipState
-//          goto use_account_trie
+//          use(AccTrie)
 //
 //      for iterateAccounts from prevIH to currentIH {
 //          use(account)
 //          for iterateIHOfStorage within accountWithIncarnation{
 //              if canSkipState
-//                  goto use_storage_trie
+//                  use(ihStorage)
 //
 //              for iterateStorage from prevIHOfStorage to currentIHOfStorage {
 //                  use(storage)
 //              }
-//            use_storage_trie:
-//              use(ihStorage)
 //          }
 //      }
-//    use_account_trie:
-//      use(AccTrie)
 //  }
-evmc::bytes32 DbTrieLoader::calculate_root() {
+evmc::bytes32 DbTrieLoader::calculate_root(PrefixSet& account_changes, PrefixSet& storage_changes) {
     auto acc_state{txn_.open(db::table::kHashedAccounts)};
     auto storage_state{txn_.open(db::table::kHashedStorage)};
 
-    StorageTrieCursor storage_trie{txn_};
+    StorageTrieCursor storage_trie{txn_, storage_changes};
 
-    for (AccountTrieCursor acc_trie{txn_};; acc_trie.next()) {
+    for (AccountTrieCursor acc_trie{txn_, account_changes};;) {
         if (acc_trie.can_skip_state()) {
-            goto use_account_trie;
+            hb_.add_branch_node(*acc_trie.key(), *acc_trie.hash(), acc_trie.children_are_in_trie());
+        }
+
+        const std::optional<Bytes> uncovered{acc_trie.first_uncovered_prefix()};
+        if (!uncovered) {
+            break;  // no more uncovered accounts
         }
 
-        for (auto a{acc_state->seek(acc_trie.first_uncovered_prefix())}; a; a = acc_state->get_next()) {
+        acc_trie.next();
+        const std::optional<Bytes> trie_key{acc_trie.key()};
+
+        for (auto a{acc_state->seek(*uncovered)}; a; a = acc_state->get_next()) {
             const Bytes unpacked_key{unpack_nibbles(a->key)};
-            if (acc_trie.key() && acc_trie.key() < unpacked_key) {
+            if (trie_key && *trie_key < unpacked_key) {
                 break;
             }
-            const auto [account, err]{decode_account_from_storage(a->value)};
-            if (err != rlp::DecodingResult::kOk) {
-                throw err;
+            add_account(*storage_state, &storage_trie, a->key, a->value);
+        }
+    }
+
+    return hb_.root_hash();
+}
+
+evmc::bytes32 DbTrieLoader::calculate_root_from_scratch() {
+    add_accounts_from_scratch(/*from=*/{}, /*to_first_byte=*/std::nullopt);
+    return hb_.root_hash();
+}
+
+Bytes DbTrieLoader::calculate_sub_trie(uint8_t nibble) {
+    assert(nibble < 0x10);
+    const Bytes from(1, static_cast<uint8_t>(nibble << 4));
+    const std::optional<uint8_t> to{nibble < 0xF ? std::optional<uint8_t>{(nibble + 1) << 4} : std::nullopt};
+    if (!add_accounts_from_scratch(from, to)) {
+        return {};
+    }
+    return hb_.finalize_as_root_child();
+}
+
+bool DbTrieLoader::add_accounts_from_scratch(ByteView from, std::optional<uint8_t> to_first_byte) {
+    auto acc_state{txn_.open(db::table::kHashedAccounts)};
+    auto storage_state{txn_.open(db::table::kHashedStorage)};
+
+    bool any{false};
+    for (auto a{acc_state->seek(from)}; a; a = acc_state->get_next()) {
+        if (to_first_byte && a->key[0] >= *to_first_byte) {
+            break;
+        }
+        add_account(*storage_state, /*storage_trie=*/nullptr, a->key, a->value);
+        any = true;
+    }
+    return any;
+}
+
+void DbTrieLoader::add_account(lmdb::Table& storage_state, StorageTrieCursor* storage_trie, ByteView packed_key,
+                               ByteView encoded_account) {
+    const auto [account, err]{decode_account_from_storage(encoded_account)};
+    if (err != rlp::DecodingResult::kOk) {
+        throw err;
+    }
+
+    evmc::bytes32 storage_root{kEmptyRoot};
+
+    // Trie nodes might be erased while the storage is hashed, so don't keep LMDB data around
+    const Bytes key{packed_key};
+
+    if (account.incarnation) {
+        const Bytes acc_with_inc{db::storage_prefix(key, account.incarnation)};
+        storage_root = calculate_storage_root(acc_with_inc, storage_trie, storage_state);
+    }
+
+    hb_.add(key, account.rlp(storage_root));
+}
+
+evmc::bytes32 DbTrieLoader::calculate_storage_root(ByteView key_with_inc, StorageTrieCursor* trie,
+                                                   lmdb::Table& state) {
+    HashBuilder hb;
+    hb.node_collector = [&](ByteView unpacked_key, const Node& node) {
+        etl::Entry e;
+        e.key = key_with_inc;
+        e.key.append(unpacked_key);
+        e.value = marshal_node(node);
+        storage_collector_.collect(e);
+    };
+
+    if (!trie) {
+        for (auto s{state.get(key_with_inc)}; s; s = state.get_next_dup()) {
+            rlp_.clear();
+            rlp::encode(rlp_, s->substr(kHashLength));
+            hb.add(s->substr(0, kHashLength), rlp_);
+        }
+        return hb.root_hash();
+    }
+
+    for (trie->seek_to_account(key_with_inc);;) {
+        if (trie->can_skip_state()) {
+            hb.add_branch_node(*trie->key(), *trie->hash(), trie->children_are_in_trie());
+        }
+
+        const std::optional<Bytes> uncovered{trie->first_uncovered_prefix()};
+        if (!uncovered) {
+            break;  // no more uncovered storage
+        }
+
+        trie->next();
+        const std::optional<Bytes> trie_key{trie->key()};
+
+        for (auto s{uncovered->empty() ? state.get(key_with_inc) : state.seek_dup(key_with_inc, *uncovered)}; s;
+             s = state.get_next_dup()) {
+            const ByteView packed_loc{s->substr(0, kHashLength)};
+            const ByteView value{s->substr(kHashLength)};
+            const Bytes unpacked_loc{unpack_nibbles(packed_loc)};
+            if (trie_key && *trie_key < unpacked_loc) {
+                break;
             }
 
-            evmc::bytes32 storage_root{kEmptyRoot};
+            rlp_.clear();
+            rlp::encode(rlp_, value);
+            hb.add(packed_loc, rlp_);
+        }
+    }
 
-            if (account.incarnation) {
-                const Bytes acc_with_inc{db::storage_prefix(a->key, account.incarnation)};
-
-                HashBuilder storage_hb;
-                storage_hb.node_collector = [&](ByteView unpacked_key, const Node& node) {
-                    etl::Entry e;
-                    e.key = acc_with_inc;
-                    e.key.append(unpacked_key);
-                    e.value = marshal_node(node);
-                    storage_collector_.collect(e);
-                };
-
-                for (storage_trie.seek_to_account(acc_with_inc);; storage_trie.next()) {
-                    if (storage_trie.can_skip_state()) {
-                        goto use_storage_trie;
-                    }
-
-                    for (auto s{storage_state->seek_dup(acc_with_inc, storage_trie.first_uncovered_prefix())}; s;
-                         s = storage_state->get_next_dup()) {
-                        const ByteView packed_loc{s->substr(0, kHashLength)};
-                        const ByteView value{s->substr(kHashLength)};
-                        const Bytes unpacked_loc{unpack_nibbles(packed_loc)};
-                        if (storage_trie.key() && storage_trie.key() < unpacked_loc) {
-                            break;
-                        }
-
-                        rlp_.clear();
-                        rlp::encode(rlp_, value);
-                        storage_hb.add(packed_loc, rlp_);
-                    }
-
-                use_storage_trie:
-                    if (!storage_trie.key()) {
-                        break;
-                    }
-
-                    // TODO[Issue 179] use storage trie
-                }
+    return hb.root_hash();
+}
+
+ParallelDbTrieLoader::ParallelDbTrieLoader(lmdb::Environment& env, const char* tmp_dir, size_t num_threads)
+    : env_{env}, num_threads_{std::clamp<size_t>(num_threads, 1, kNumShards)} {
+    for (auto& shard : shards_) {
+        shard = std::make_unique<Shard>(tmp_dir, etl::kOptimalBufferSize / kNumShards);
+    }
+}
 
-                storage_root = storage_hb.root_hash();
+evmc::bytes32 ParallelDbTrieLoader::calculate_root() {
+    {
+        // mdb_dbi_open must not be called concurrently from multiple transactions, so open the tables in advance:
+        // dbi handles of a committed transaction remain available and are merely looked up by the workers
+        auto txn{env_.begin_ro_transaction()};
+        std::optional<uint8_t> single_nibble;
+        {
+            auto accounts{txn->open(db::table::kHashedAccounts)};
+            txn->open(db::table::kHashedStorage);
+
+            const auto first{accounts->seek(ByteView{})};
+            if (!first) {
+                return kEmptyRoot;
+            }
+            const auto nibble{static_cast<uint8_t>(first->key[0] >> 4)};
+            if (nibble == 0xF || !accounts->seek(Bytes(1, static_cast<uint8_t>((nibble + 1) << 4)))) {
+                single_nibble = nibble;
             }
+        }
 
-            hb_.add(a->key, account.rlp(storage_root));
+        // The root is not a branch node then, so there's nothing to split
+        if (single_nibble) {
+            Shard& shard{*shards_[*single_nibble]};
+            DbTrieLoader loader{*txn, shard.account_collector, shard.storage_collector};
+            return loader.calculate_root_from_scratch();
         }
 
-    use_account_trie:
-        if (!acc_trie.key()) {
-            break;
+        lmdb::err_handler(txn->commit());
+    }
+
+    std::atomic<size_t> next_nibble{0};
+    auto work{[this, &next_nibble]() {
+        std::unique_ptr<lmdb::Transaction> txn{nullptr};
+        for (size_t nibble{next_nibble++}; nibble < kNumShards; nibble = next_nibble++) {
+            Shard& shard{*shards_[nibble]};
+            try {
+                if (!txn) {
+                    txn = env_.begin_ro_transaction();
+                }
+                DbTrieLoader loader{*txn, shard.account_collector, shard.storage_collector};
+                shard.child_ref = loader.calculate_sub_trie(static_cast<uint8_t>(nibble));
+            } catch (...) {
+                shard.exception = std::current_exception();
+            }
         }
+    }};
 
-        // TODO[Issue 179] use account trie
+    std::vector<std::thread> workers;
+    for (size_t i{0}; i < num_threads_; ++i) {
+        workers.emplace_back(work);
+    }
+    for (auto& worker : workers) {
+        worker.join();
     }
 
-    return hb_.root_hash();
+    std::array<Bytes, kNumShards> children;
+    for (size_t i{0}; i < kNumShards; ++i) {
+        if (shards_[i]->exception) {
+            std::rethrow_exception(shards_[i]->exception);
+        }
+        children[i] = std::move(shards_[i]->child_ref);
+    }
+    return HashBuilder::root_hash_of_branch(children);
+}
+
+void ParallelDbTrieLoader::load(lmdb::Transaction& txn) {
+    auto account_tbl{txn.open(db::table::kTrieOfAccounts)};
+    auto storage_tbl{txn.open(db::table::kTrieOfStorage)};
+    for (auto& shard : shards_) {
+        shard->account_collector.load(account_tbl.get());
+        shard->storage_collector.load(storage_tbl.get());
+    }
 }
 
 Bytes marshal_node(const Node& n) {
@@ -241,11 +567,32 @@ Node unmarshal_node(ByteView v) {
     return {state_mask, tree_mask, hash_mask, hashes, root_hash};
 }
 
-void regenerate_db_tries(lmdb::Transaction& txn, const char* tmp_dir, const evmc::bytes32* expected_root) {
+Bytes pack_nibbles(ByteView unpacked) {
+    Bytes out((unpacked.length() + 1) / 2, '\0');
+    for (size_t i{0}; i < unpacked.length(); ++i) {
+        out[i / 2] |= i % 2 ? unpacked[i] : unpacked[i] << 4;
+    }
+    return out;
+}
+
+std::optional<Bytes> increment_key(ByteView unpacked) {
+    Bytes out{unpacked};
+    for (size_t i{out.length()}; i > 0; --i) {
+        if (out[i - 1] < 0xF) {
+            ++out[i - 1];
+            out.resize(i);
+            return out;
+        }
+    }
+    return std::nullopt;
+}
+
+static void update_db_tries(lmdb::Transaction& txn, const char* tmp_dir, PrefixSet& account_changes,
+                            PrefixSet& storage_changes, const evmc::bytes32* expected_root) {
     etl::Collector account_collector{tmp_dir};
     etl::Collector storage_collector{tmp_dir};
     DbTrieLoader loader{txn, account_collector, storage_collector};
-    const evmc::bytes32 root{loader.calculate_root()};
+    const evmc::bytes32 root{loader.calculate_root(account_changes, storage_changes)};
     if (expected_root && root != *expected_root) {
         SILKWORM_LOG(LogLevel::Error) << "Wrong trie root: " << to_hex(root) << ", expected: " << to_hex(*expected_root)
                                       << "\n";
@@ -257,4 +604,75 @@ void regenerate_db_tries(lmdb::Transaction& txn, const char* tmp_dir, const evmc
     storage_collector.load(storage_tbl.get());
 }
 
+void regenerate_db_tries(lmdb::Transaction& txn, const char* tmp_dir, const evmc::bytes32* expected_root) {
+    txn.open(db::table::kTrieOfAccounts)->clear();
+    txn.open(db::table::kTrieOfStorage)->clear();
+    PrefixSet account_changes;
+    PrefixSet storage_changes;
+    update_db_tries(txn, tmp_dir, account_changes, storage_changes, expected_root);
+}
+
+// Erases the storage trie of an account that has been destructed, unless it's been recreated with the same incarnation
+static void erase_storage_trie(lmdb::Table& storage_trie, lmdb::Table& hashed_accounts, ByteView prefix) {
+    const ByteView hashed_address{prefix.substr(0, kHashLength)};
+    if (std::optional<ByteView> encoded{hashed_accounts.get(hashed_address)}; encoded) {
+        const auto [account, err]{decode_account_from_storage(*encoded)};
+        rlp::err_handler(err);
+        if (account.incarnation == boost::endian::load_big_u64(&prefix[kHashLength])) {
+            return;
+        }
+    }
+    for (auto e{storage_trie.seek(prefix)}; e && has_prefix(e->key, prefix); e = storage_trie.seek(prefix)) {
+        lmdb::err_handler(storage_trie.del_current());
+    }
+}
+
+void increment_db_tries(lmdb::Transaction& txn, const char* tmp_dir, uint64_t from,
+                        const evmc::bytes32* expected_root) {
+    PrefixSet account_changes;
+    PrefixSet storage_changes;
+    std::vector<Bytes> storage_prefixes_of_old_accounts;
+
+    auto account_changeset{txn.open(db::table::kPlainAccountChangeSet)};
+    for (auto e{account_changeset->seek(db::block_key(from + 1))}; e; e = account_changeset->get_next()) {
+        const ByteView address{e->value.substr(0, kAddressLength)};
+        const ethash::hash256 hashed_address{keccak256(address)};
+        account_changes.insert(unpack_nibbles(full_view(hashed_address.bytes)));
+
+        const ByteView encoded_account{e->value.substr(kAddressLength)};
+        if (!encoded_account.empty()) {
+            const auto [account, err]{decode_account_from_storage(encoded_account)};
+            rlp::err_handler(err);
+            if (account.incarnation) {
+                storage_prefixes_of_old_accounts.push_back(
+                    db::storage_prefix(full_view(hashed_address.bytes), account.incarnation));
+            }
+        }
+    }
+
+    auto storage_changeset{txn.open(db::table::kPlainStorageChangeSet)};
+    for (auto e{storage_changeset->seek(db::block_key(from + 1))}; e; e = storage_changeset->get_next()) {
+        // key is block number + address + incarnation, see db::storage_change_key
+        const ByteView address{e->key.substr(8, kAddressLength)};
+        const ethash::hash256 hashed_address{keccak256(address)};
+        const Bytes unpacked_address{unpack_nibbles(full_view(hashed_address.bytes))};
+        const uint64_t incarnation{boost::endian::load_big_u64(&e->key[8 + kAddressLength])};
+        const ethash::hash256 hashed_location{keccak256(e->value.substr(0, kHashLength))};
+
+        // The storage root is part of the account
+        account_changes.insert(unpacked_address);
+        Bytes key{db::storage_prefix(full_view(hashed_address.bytes), incarnation)};
+        key.append(unpack_nibbles(full_view(hashed_location.bytes)));
+        storage_changes.insert(key);
+    }
+
+    auto storage_trie{txn.open(db::table::kTrieOfStorage)};
+    auto hashed_accounts{txn.open(db::table::kHashedAccounts)};
+    for (const Bytes& prefix : storage_prefixes_of_old_accounts) {
+        erase_storage_trie(*storage_trie, *hashed_accounts, prefix);
+    }
+
+    update_db_tries(txn, tmp_dir, account_changes, storage_changes, expected_root);
+}
+
 }  // namespace silkworm::trie
@@ -62,6 +62,9 @@ the correct bit in tree_mask bitmap
 - Other records in trie_account and trie_storage must satisfy (tree_mask≠0 ∨ hash_mask≠0)
 */
 
+#include <array>
+#include <exception>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -73,40 +76,101 @@ the correct bit in tree_mask bitmap
 
 namespace silkworm::trie {
 
-// TG AccTrieCursor
-class AccountTrieCursor {
+// Set of (changed) keys supporting prefix queries, see TG RetainList
+class PrefixSet {
   public:
-    AccountTrieCursor(const AccountTrieCursor&) = delete;
-    AccountTrieCursor& operator=(const AccountTrieCursor&) = delete;
+    PrefixSet(const PrefixSet&) = delete;
+    PrefixSet& operator=(const PrefixSet&) = delete;
 
-    explicit AccountTrieCursor(lmdb::Transaction& txn);
+    PrefixSet() = default;
 
-    Bytes first_uncovered_prefix();
+    void insert(ByteView key);
 
-    std::optional<Bytes> key() const;
+    // Whether any of the inserted keys starts with the given prefix.
+    // Queries are fastest when made in the increasing order of prefixes.
+    bool contains(ByteView prefix);
 
-    void next();
+    size_t size() const { return keys_.size(); }
 
-    bool can_skip_state() const;
+  private:
+    void ensure_sorted();
+
+    std::vector<Bytes> keys_;
+    bool sorted_{true};
+    size_t index_{0};
 };
 
-// TG StorageTrieCursor
-class StorageTrieCursor {
+// Walks through a DB trie (trie_account or trie_storage) in the pre-order, stopping at every child of
+// the stored branch nodes. Nodes entered are erased from the DB as they are to be regenerated by the HashBuilder,
+// whereas sub-tries which have a stored hash and contain none of the changed keys are skipped over.
+// See TG AccTrieCursor & StorageTrieCursor.
+class TrieCursor {
   public:
-    StorageTrieCursor(const StorageTrieCursor&) = delete;
-    StorageTrieCursor& operator=(const StorageTrieCursor&) = delete;
+    TrieCursor(const TrieCursor&) = delete;
+    TrieCursor& operator=(const TrieCursor&) = delete;
 
-    explicit StorageTrieCursor(lmdb::Transaction& txn);
+    // Unpacked path of the current position relative to the cursor prefix; std::nullopt at the end of the trie
+    std::optional<Bytes> key() const;
 
-    Bytes seek_to_account(ByteView hashed_address_with_incarnation);
+    // Hash of the current sub-trie, if stored
+    const evmc::bytes32* hash() const;
 
-    Bytes first_uncovered_prefix();
+    // Whether the current sub-trie has nodes in the DB trie
+    bool children_are_in_trie() const;
 
-    std::optional<Bytes> key() const;
+    // Whether the current sub-trie can be replaced by its stored hash
+    bool can_skip_state() const { return can_skip_state_; }
+
+    // Packed lower bound of the state not covered by the DB trie so far; std::nullopt if there's none left
+    std::optional<Bytes> first_uncovered_prefix() const;
 
     void next();
 
-    bool can_skip_state() const;
+  protected:
+    TrieCursor(std::unique_ptr<lmdb::Table> table, PrefixSet& changed);
+
+    // Positions the cursor at the root of the trie stored under prefix
+    void start(ByteView prefix);
+
+  private:
+    struct SubNode {
+        Bytes key;
+        std::optional<Node> node;
+        int nibble{-1};  // -1 stands for the node itself
+
+        Bytes full_key() const;
+        bool state_flag() const;
+        bool tree_flag() const;
+        bool hash_flag() const;
+        const evmc::bytes32* hash() const;
+    };
+
+    void consume_node(ByteView to, bool exact);
+
+    void move_to_next_sibling(bool allow_root_to_child_nibble_within_subnode);
+
+    void update_skip_state();
+
+    std::unique_ptr<lmdb::Table> table_;
+    PrefixSet& changed_;
+    Bytes prefix_;
+    std::vector<SubNode> stack_;
+    bool can_skip_state_{false};
+};
+
+// TG AccTrieCursor
+class AccountTrieCursor : public TrieCursor {
+  public:
+    AccountTrieCursor(lmdb::Transaction& txn, PrefixSet& changed);
+};
+
+// TG StorageTrieCursor
+class StorageTrieCursor : public TrieCursor {
+  public:
+    StorageTrieCursor(lmdb::Transaction& txn, PrefixSet& changed);
+
+    // Hashed address + incarnation, see db::storage_prefix
+    void seek_to_account(ByteView hashed_address_with_incarnation) { start(hashed_address_with_incarnation); }
 };
 
 // TG FlatDBTrieLoader
@@ -117,15 +181,72 @@ class DbTrieLoader {
 
     DbTrieLoader(lmdb::Transaction& txn, etl::Collector& account_collector, etl::Collector& storage_collector);
 
-    evmc::bytes32 calculate_root();
+    // account_changes holds unpacked hashed addresses,
+    // while storage_changes holds packed hashed address + incarnation followed by unpacked hashed location.
+    // Nodes of the DB tries not skipped over are erased and collected anew.
+    evmc::bytes32 calculate_root(PrefixSet& account_changes, PrefixSet& storage_changes);
+
+    // The following ones hash the state from scratch: the DB tries are neither read nor erased,
+    // hence a read-only transaction suffices.
+
+    evmc::bytes32 calculate_root_from_scratch();
+
+    // Hashes the accounts whose hashed address starts with the given nibble as the sub-trie of a child of the
+    // root branch node and returns the child's node reference (see HashBuilder::finalize_as_root_child);
+    // empty if there are no such accounts.
+    Bytes calculate_sub_trie(uint8_t nibble);
 
   private:
+    // Adds all the accounts in [from, to) to hb_; returns whether there were any
+    bool add_accounts_from_scratch(ByteView from, std::optional<uint8_t> to_first_byte);
+
+    void add_account(lmdb::Table& storage_state, StorageTrieCursor* storage_trie, ByteView packed_key,
+                     ByteView encoded_account);
+
+    // Without a trie cursor the storage is hashed from scratch
+    evmc::bytes32 calculate_storage_root(ByteView key_with_inc, StorageTrieCursor* trie, lmdb::Table& state);
+
     lmdb::Transaction& txn_;
     HashBuilder hb_;
     etl::Collector& storage_collector_;
     Bytes rlp_;
 };
 
+// Regenerates the account trie from scratch splitting the work by the first nibble of the hashed addresses:
+// each of the (up to) 16 sub-tries is hashed by one of the worker threads within its own read-only transaction
+// and their node references are finally combined into the root branch node.
+// Only the state committed to the DB is visible to the workers.
+class ParallelDbTrieLoader {
+  public:
+    ParallelDbTrieLoader(const ParallelDbTrieLoader&) = delete;
+    ParallelDbTrieLoader& operator=(const ParallelDbTrieLoader&) = delete;
+
+    ParallelDbTrieLoader(lmdb::Environment& env, const char* tmp_dir, size_t num_threads);
+
+    // The calling thread must not hold a transaction of env, which would keep the workers' tables from being opened
+    evmc::bytes32 calculate_root();
+
+    // Writes the collected nodes into the (presumably cleared) DB tries
+    void load(lmdb::Transaction& txn);
+
+  private:
+    static constexpr size_t kNumShards{16};
+
+    struct Shard {
+        Shard(const char* tmp_dir, size_t optimal_size)
+            : account_collector{tmp_dir, optimal_size}, storage_collector{tmp_dir, optimal_size} {}
+
+        etl::Collector account_collector;
+        etl::Collector storage_collector;
+        Bytes child_ref;
+        std::exception_ptr exception;
+    };
+
+    lmdb::Environment& env_;
+    size_t num_threads_;
+    std::array<std::unique_ptr<Shard>, kNumShards> shards_;
+};
+
 class WrongRoot : public std::runtime_error {
   public:
     WrongRoot() : std::runtime_error{"wrong trie root"} {}
@@ -137,10 +258,22 @@ Bytes marshal_node(const Node& n);
 // TG UnmarshalTrieNode
 Node unmarshal_node(ByteView v);
 
+// TG CompressNibbles
+Bytes pack_nibbles(ByteView unpacked);
+
+// Smallest key greater than all the keys prefixed by unpacked; std::nullopt if there's none (e.g. 0xFF)
+std::optional<Bytes> increment_key(ByteView unpacked);
+
 // TG RegenerateIntermediateHashes
 // might throw WrongRoot
 void regenerate_db_tries(lmdb::Transaction& txn, const char* tmp_dir, const evmc::bytes32* expected_root = nullptr);
 
+// TG IncrementIntermediateHashes
+// Updates the DB tries after the state changes of blocks (from, ...] recorded in the change sets.
+// might throw WrongRoot
+void increment_db_tries(lmdb::Transaction& txn, const char* tmp_dir, uint64_t from,
+                        const evmc::bytes32* expected_root = nullptr);
+
 }  // namespace silkworm::trie
 
 #endif  // SILKWORM_TRIE_DB_TRIE_HPP_
@@ -17,6 +17,7 @@
 #include "db_trie.hpp"
 
 #include <bitset>
+#include <map>
 
 #include <boost/endian/conversion.hpp>
 #include <catch2/catch.hpp>
@@ -180,7 +181,9 @@ TEST_CASE("Layout of account trie") {
 
     REQUIRE(node2.hashes().size() == 1);
 
-    // TODO[Issue 179] check that there's nothing else in account_trie
+    size_t num_records{0};
+    REQUIRE(account_trie->get_rcount(&num_records) == MDB_SUCCESS);
+    CHECK(num_records == 2);
 
     // ----------------------------------------------------------------
     // Check storage trie
@@ -200,7 +203,308 @@ TEST_CASE("Layout of account trie") {
 
     REQUIRE(node3.hashes().size() == 1);
 
-    // TODO[Issue 179] check that there's nothing else in storage_trie
+    REQUIRE(storage_trie->get_rcount(&num_records) == MDB_SUCCESS);
+    CHECK(num_records == 1);
+
+    // ----------------------------------------------------------------
+    // Change an account & check the incremental update
+    // ----------------------------------------------------------------
+
+    const Account a4b{0, 5 * kEther};
+    hashed_accounts->put(full_view(key4), a4b.encode_for_storage());
+
+    HashBuilder hb2;
+    hb2.add(full_view(key1), a1.rlp(kEmptyRoot));
+    hb2.add(full_view(key2), a2.rlp(kEmptyRoot));
+    hb2.add(full_view(key3), a3.rlp(storage_root));
+    hb2.add(full_view(key4), a4b.rlp(kEmptyRoot));
+    hb2.add(full_view(key5), a5.rlp(kEmptyRoot));
+    hb2.add(full_view(key6), a6.rlp(kEmptyRoot));
+    const evmc::bytes32 expected_root2{hb2.root_hash()};
+
+    PrefixSet account_changes;
+    account_changes.insert(unpack_nibbles(full_view(key4)));
+    PrefixSet storage_changes;
+
+    etl::Collector account_collector{tmp_dir2.path()};
+    etl::Collector storage_collector{tmp_dir2.path()};
+    DbTrieLoader loader{*txn, account_collector, storage_collector};
+    CHECK(loader.calculate_root(account_changes, storage_changes) == expected_root2);
+
+    // Node 0B has been regenerated, while node 0B00 and the storage trie have been skipped over
+    CHECK(account_collector.size() == 1);
+    CHECK(storage_collector.size() == 0);
+    account_collector.load(account_trie.get());
+
+    const auto marshalled_node1b{account_trie->get(*from_hex("0B"))};
+    REQUIRE(marshalled_node1b);
+    const Node node1b{unmarshal_node(*marshalled_node1b)};
+    CHECK(node1b.state_mask() == node1.state_mask());
+    CHECK(node1b.tree_mask() == node1.tree_mask());
+    CHECK(node1b.hash_mask() == node1.hash_mask());
+    CHECK(node1b.hashes() == node1.hashes());
+
+    const auto marshalled_node2b{account_trie->get(*from_hex("0B00"))};
+    REQUIRE(marshalled_node2b);
+    CHECK(unmarshal_node(*marshalled_node2b) == node2);
+    REQUIRE(account_trie->get_rcount(&num_records) == MDB_SUCCESS);
+    CHECK(num_records == 2);
+    REQUIRE(storage_trie->get_rcount(&num_records) == MDB_SUCCESS);
+    CHECK(num_records == 1);
+}
+
+TEST_CASE("Incremental intermediate hashes") {
+    const TemporaryDirectory tmp_dir1;
+    const TemporaryDirectory tmp_dir2;
+
+    lmdb::DatabaseConfig db_config{tmp_dir1.path(), 32 * kMebi};
+    db_config.set_readonly(false);
+    auto env{lmdb::get_env(db_config)};
+    auto txn{env->begin_rw_transaction()};
+    db::table::create_all(*txn);
+
+    auto hashed_accounts{txn->open(db::table::kHashedAccounts)};
+    auto hashed_storage{txn->open(db::table::kHashedStorage)};
+    auto account_changes{txn->open(db::table::kPlainAccountChangeSet)};
+    auto storage_changes{txn->open(db::table::kPlainStorageChangeSet)};
+
+    // by hashed address
+    std::map<evmc::bytes32, Account> accounts;
+    std::map<evmc::bytes32, std::map<evmc::bytes32, Bytes>> storage;  // by hashed location
+
+    const auto hash{[](ByteView v) { return bit_cast<evmc_bytes32>(keccak256(v)); }};
+
+    const auto write_account{[&](const evmc::address& address, const Account& account) {
+        const evmc::bytes32 hashed{hash(full_view(address))};
+        accounts[hashed] = account;
+        hashed_accounts->put(full_view(hashed), account.encode_for_storage());
+    }};
+
+    const auto write_storage{[&](const evmc::address& address, const evmc::bytes32& location, ByteView value) {
+        const evmc::bytes32 hashed{hash(full_view(address))};
+        const evmc::bytes32 hashed_location{hash(full_view(location))};
+        const Bytes prefix{db::storage_prefix(full_view(hashed), accounts[hashed].incarnation)};
+        hashed_storage->del(prefix, full_view(hashed_location));
+        if (value.empty()) {
+            storage[hashed].erase(hashed_location);
+            return;
+        }
+        storage[hashed][hashed_location] = value;
+        Bytes data{full_view(hashed_location)};
+        data.append(value);
+        hashed_storage->put(prefix, data);
+    }};
+
+    const auto expected_root{[&]() {
+        HashBuilder hb;
+        for (const auto& [hashed, account] : accounts) {
+            HashBuilder storage_hb;
+            for (const auto& [hashed_location, value] : storage[hashed]) {
+                Bytes value_rlp;
+                rlp::encode(value_rlp, value);
+                storage_hb.add(full_view(hashed_location), value_rlp);
+            }
+            hb.add(full_view(hashed), account.rlp(storage_hb.root_hash()));
+        }
+        return hb.root_hash();
+    }};
+
+    const auto read_all{[](lmdb::Table& table) {
+        std::map<Bytes, Bytes> res;
+        for (auto e{table.seek({})}; e; e = table.get_next()) {
+            res.emplace(e->key, e->value);
+        }
+        return res;
+    }};
+
+    const auto address_of{[](uint8_t i) {
+        evmc::address address;
+        address.bytes[0] = i;
+        return address;
+    }};
+
+    const auto location_of{[](uint8_t i) {
+        evmc::bytes32 location;
+        location.bytes[31] = i;
+        return location;
+    }};
+
+    // Every tenth account is a contract with some storage
+    for (uint8_t i{0}; i < 200; ++i) {
+        write_account(address_of(i), Account{i, i * kGiga, kEmptyHash, i % 10 ? 0 : kDefaultIncarnation});
+        for (uint8_t j{0}; i % 10 == 0 && j < 50; ++j) {
+            write_storage(address_of(i), location_of(j), Bytes{i, j});
+        }
+    }
+
+    evmc::bytes32 root{expected_root()};
+    regenerate_db_tries(*txn, tmp_dir2.path(), &root);
+
+    auto account_trie{txn->open(db::table::kTrieOfAccounts)};
+    auto storage_trie{txn->open(db::table::kTrieOfStorage)};
+
+    SECTION("Changed accounts & storage") {
+        for (uint8_t i{0}; i < 200; i += 30) {
+            const evmc::address address{address_of(i)};
+            Account account{accounts[hash(full_view(address))]};
+            Bytes change{full_view(address)};
+            change.append(account.encode_for_storage());
+            account_changes->put(db::block_key(1), change);
+
+            ++account.balance;
+            write_account(address, account);
+
+            if (account.incarnation) {
+                Bytes storage_change{full_view(location_of(i))};
+                storage_change.append(Bytes{i, i});
+                storage_changes->put(db::storage_change_key(1, address, account.incarnation), storage_change);
+                write_storage(address, location_of(i), {});  // deleted
+            }
+        }
+
+        // A brand new account
+        const evmc::address address{0x000000000000000000000000000000000000fe12_address};
+        account_changes->put(db::block_key(1), full_view(address));
+        write_account(address, Account{});
+
+        root = expected_root();
+        increment_db_tries(*txn, tmp_dir2.path(), /*from=*/0, &root);
+    }
+
+    SECTION("Destructed contract") {
+        const evmc::address address{address_of(20)};
+        const evmc::bytes32 hashed{hash(full_view(address))};
+        const Bytes prefix{db::storage_prefix(full_view(hashed), kDefaultIncarnation)};
+        REQUIRE(storage_trie->get(prefix));
+
+        Bytes change{full_view(address)};
+        change.append(accounts[hashed].encode_for_storage());
+        account_changes->put(db::block_key(1), change);
+
+        hashed_accounts->del(full_view(hashed));
+        hashed_storage->del(prefix);
+        accounts.erase(hashed);
+        storage.erase(hashed);
+
+        root = expected_root();
+        increment_db_tries(*txn, tmp_dir2.path(), /*from=*/0, &root);
+
+        CHECK(!storage_trie->get(prefix));
+    }
+
+    // The DB tries must be the same as if they had been generated from scratch
+    const std::map<Bytes, Bytes> incremental_account_trie{read_all(*account_trie)};
+    const std::map<Bytes, Bytes> incremental_storage_trie{read_all(*storage_trie)};
+    CHECK(!incremental_storage_trie.empty());
+
+    regenerate_db_tries(*txn, tmp_dir2.path(), &root);
+    CHECK(read_all(*account_trie) == incremental_account_trie);
+    CHECK(read_all(*storage_trie) == incremental_storage_trie);
+}
+
+TEST_CASE("Parallel regeneration of intermediate hashes") {
+    const TemporaryDirectory tmp_dir1;
+    const TemporaryDirectory tmp_dir2;
+
+    lmdb::DatabaseConfig db_config{tmp_dir1.path(), 32 * kMebi};
+    db_config.set_readonly(false);
+    auto env{lmdb::get_env(db_config)};
+
+    size_t num_accounts{300};
+    uint8_t first_byte_mask{0xFF};
+    SECTION("Accounts in all sub-tries") {}
+    SECTION("Accounts in a single sub-trie") { first_byte_mask = 0x0F; }
+    SECTION("Single account") { num_accounts = 1; }
+    SECTION("No accounts") { num_accounts = 0; }
+
+    const auto hash{[](ByteView v) { return bit_cast<evmc_bytes32>(keccak256(v)); }};
+
+    // Every tenth account is a contract with some storage
+    {
+        auto txn{env->begin_rw_transaction()};
+        db::table::create_all(*txn);
+        auto hashed_accounts{txn->open(db::table::kHashedAccounts)};
+        auto hashed_storage{txn->open(db::table::kHashedStorage)};
+        for (size_t i{0}; i < num_accounts; ++i) {
+            evmc::bytes32 hashed{hash(Bytes{static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i)})};
+            hashed.bytes[0] &= first_byte_mask;
+            const Account account{i, i * kGiga, kEmptyHash, i % 10 ? 0 : kDefaultIncarnation};
+            hashed_accounts->put(full_view(hashed), account.encode_for_storage());
+            for (uint8_t j{0}; account.incarnation && j < 20; ++j) {
+                Bytes data{full_view(hash(Bytes{j}))};
+                data.push_back(static_cast<uint8_t>(j + 1));
+                hashed_storage->put(db::storage_prefix(full_view(hashed), account.incarnation), data);
+            }
+        }
+        lmdb::err_handler(txn->commit());
+    }
+
+    const auto read_all{[](lmdb::Table& table) {
+        std::map<Bytes, Bytes> res;
+        for (auto e{table.seek({})}; e; e = table.get_next()) {
+            res.emplace(e->key, e->value);
+        }
+        return res;
+    }};
+
+    // Sequential regeneration is the reference
+    evmc::bytes32 root;
+    std::map<Bytes, Bytes> account_trie;
+    std::map<Bytes, Bytes> storage_trie;
+    {
+        auto txn{env->begin_rw_transaction()};
+        regenerate_db_tries(*txn, tmp_dir2.path());
+        account_trie = read_all(*txn->open(db::table::kTrieOfAccounts));
+        storage_trie = read_all(*txn->open(db::table::kTrieOfStorage));
+
+        etl::Collector account_collector{tmp_dir2.path()};
+        etl::Collector storage_collector{tmp_dir2.path()};
+        root = DbTrieLoader{*txn, account_collector, storage_collector}.calculate_root_from_scratch();
+    }
+    CHECK((num_accounts || root == kEmptyRoot));
+    CHECK((num_accounts < 10 || !storage_trie.empty()));
+
+    for (size_t num_threads : {1, 4, 16}) {
+        ParallelDbTrieLoader loader{*env, tmp_dir2.path(), num_threads};
+        CHECK(loader.calculate_root() == root);
+
+        auto txn{env->begin_rw_transaction()};
+        loader.load(*txn);
+        CHECK(read_all(*txn->open(db::table::kTrieOfAccounts)) == account_trie);
+        CHECK(read_all(*txn->open(db::table::kTrieOfStorage)) == storage_trie);
+    }
+}
+
+TEST_CASE("Prefix set") {
+    PrefixSet ps;
+    CHECK(!ps.contains({}));
+    CHECK(!ps.contains(*from_hex("01")));
+
+    ps.insert(*from_hex("abcd"));
+    ps.insert(*from_hex("1234"));
+    ps.insert(*from_hex("2345"));
+    ps.insert(*from_hex("1234"));
+
+    CHECK(ps.contains({}));
+    CHECK(ps.contains(*from_hex("12")));
+    CHECK(!ps.contains(*from_hex("13")));
+    CHECK(ps.contains(*from_hex("2345")));
+    CHECK(!ps.contains(*from_hex("234567")));
+    CHECK(ps.contains(*from_hex("ab")));
+    CHECK(!ps.contains(*from_hex("ff")));
+
+    // queries in arbitrary order
+    CHECK(ps.contains(*from_hex("1234")));
+    CHECK(!ps.contains(*from_hex("00")));
+    CHECK(ps.contains(*from_hex("abcd")));
+}
+
+TEST_CASE("Key increment") {
+    CHECK(increment_key(*from_hex("")) == std::nullopt);
+    CHECK(increment_key(*from_hex("000f")) == *from_hex("01"));
+    CHECK(increment_key(*from_hex("0b03")) == *from_hex("0b04"));
+    CHECK(increment_key(*from_hex("0f0f")) == std::nullopt);
+    CHECK(pack_nibbles(*from_hex("0b0304")) == *from_hex("b340"));
 }
 
 }  // namespace silkworm::trie
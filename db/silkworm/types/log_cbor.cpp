@@ -16,9 +16,15 @@
 
 #include "log_cbor.hpp"
 
+#include <algorithm>
+#include <cstring>
+
+#include <cbor/decoder.h>
 #include <cbor/encoder.h>
 #include <cbor/output_dynamic.h>
 
+#include <silkworm/common/cast.hpp>
+
 namespace silkworm {
 
 Bytes cbor_encode(const std::vector<Log>& v) {
@@ -40,4 +46,99 @@ Bytes cbor_encode(const std::vector<Log>& v) {
     return Bytes{output.data(), output.size()};
 }
 
+namespace {
+
+    // Builds logs out of the events of the streaming decoder,
+    // i.e. [[address, [topic, ...], data], ...]
+    // Array sizes are untrusted: as each item takes at least one byte,
+    // no more than max_items are reserved for and truncated input just fails.
+    class LogListener : public cbor::listener {
+      public:
+        LogListener(std::vector<Log>& out, size_t max_items) : out_{out}, max_items_{max_items} {}
+
+        bool done() const { return state_ == State::kLog && remaining_logs_ == 0; }
+
+        void on_array(int size) override {
+            if (size < 0) {
+                fail();
+            } else if (state_ == State::kLogCount) {
+                remaining_logs_ = static_cast<size_t>(size);
+                out_.reserve(out_.size() + std::min(remaining_logs_, max_items_));
+                state_ = State::kLog;
+            } else if (state_ == State::kLog && size == 3 && remaining_logs_ > 0) {
+                out_.emplace_back();
+                --remaining_logs_;
+                state_ = State::kAddress;
+            } else if (state_ == State::kTopicCount) {
+                remaining_topics_ = static_cast<size_t>(size);
+                out_.back().topics.reserve(std::min(remaining_topics_, max_items_));
+                state_ = remaining_topics_ > 0 ? State::kTopic : State::kData;
+            } else {
+                fail();
+            }
+        }
+
+        void on_bytes(unsigned char* data, int size) override {
+            if (state_ == State::kAddress && size == kAddressLength) {
+                std::memcpy(out_.back().address.bytes, data, kAddressLength);
+                state_ = State::kTopicCount;
+            } else if (state_ == State::kTopic && size == kHashLength) {
+                std::memcpy(out_.back().topics.emplace_back().bytes, data, kHashLength);
+                if (--remaining_topics_ == 0) {
+                    state_ = State::kData;
+                }
+            } else if (state_ == State::kData && size >= 0) {
+                out_.back().data.assign(data, static_cast<size_t>(size));
+                state_ = State::kLog;
+            } else {
+                fail();
+            }
+        }
+
+        void on_integer(int) override { fail(); }
+        void on_string(std::string&) override { fail(); }
+        void on_map(int) override { fail(); }
+        void on_tag(unsigned int) override { fail(); }
+        void on_special(unsigned int) override { fail(); }
+        void on_bool(bool) override { fail(); }
+        void on_null() override { fail(); }
+        void on_undefined() override { fail(); }
+        void on_error(const char*) override { fail(); }
+        void on_extra_integer(unsigned long long, int) override { fail(); }
+        void on_extra_tag(unsigned long long) override { fail(); }
+        void on_extra_special(unsigned long long) override { fail(); }
+        void on_double(double) override { fail(); }
+        void on_float32(float) override { fail(); }
+
+      private:
+        enum class State { kLogCount, kLog, kAddress, kTopicCount, kTopic, kData, kFailed };
+
+        void fail() { state_ = State::kFailed; }
+
+        std::vector<Log>& out_;
+        const size_t max_items_;
+        State state_{State::kLogCount};
+        size_t remaining_logs_{0};
+        size_t remaining_topics_{0};
+    };
+
+}  // namespace
+
+bool cbor_decode(ByteView data, std::vector<Log>& out) {
+    if (data.empty()) {
+        return false;
+    }
+    const size_t size_before{out.size()};
+    LogListener listener{out, data.size()};
+    // cbor::input doesn't modify the data
+    cbor::input input{const_cast<uint8_t*>(data.data()), static_cast<int>(data.size())};
+    cbor::decoder decoder{input, listener};
+    decoder.run();
+    if (!listener.done()) {
+        out.resize(size_before);
+        return false;
+    }
+    return true;
+}
+
 }  // namespace silkworm
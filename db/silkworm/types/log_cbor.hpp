@@ -25,6 +25,10 @@ namespace silkworm {
 // See core/types/log.go
 Bytes cbor_encode(const std::vector<Log>& v);
 
+// Appends logs decoded from the TG storage encoding to out.
+// Returns false if data is not a well-formed CBOR array of logs.
+[[nodiscard]] bool cbor_decode(ByteView data, std::vector<Log>& out);
+
 }  // namespace silkworm
 
 #endif  // SILKWORM_TYPES_LOG_CBOR_H_
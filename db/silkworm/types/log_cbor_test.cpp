@@ -0,0 +1,68 @@
+/*
+   Copyright 2021 The Silkworm Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "log_cbor.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <silkworm/common/util.hpp>
+
+namespace silkworm {
+
+TEST_CASE("CBOR decoding of logs") {
+    const std::vector<Log> logs{
+        Log{
+            0xea674fdde714fd979de3edf0f56aa9716b898ec8_address,
+            {},
+            *from_hex("0x010043"),
+        },
+        Log{
+            0x44fd3ab8381cc3d14afa7c4af7fd13cdc65026e1_address,
+            {to_bytes32(*from_hex("dead")), to_bytes32(*from_hex("abba"))},
+            *from_hex("0xaabbff780043"),
+        },
+    };
+    const Bytes encoded{cbor_encode(logs)};
+
+    std::vector<Log> decoded;
+    REQUIRE(cbor_decode(encoded, decoded));
+    REQUIRE(decoded.size() == logs.size());
+    for (size_t i{0}; i < logs.size(); ++i) {
+        CHECK(decoded[i].address == logs[i].address);
+        CHECK(decoded[i].topics == logs[i].topics);
+        CHECK(decoded[i].data == logs[i].data);
+    }
+
+    SECTION("Truncated") {
+        decoded.clear();
+        CHECK(!cbor_decode(ByteView{encoded}.substr(0, encoded.size() - 1), decoded));
+        CHECK(decoded.empty());
+    }
+
+    SECTION("Untrusted array sizes") {
+        decoded = {};
+        // An array of 0x7fffffff logs with no log at all
+        CHECK(!cbor_decode(*from_hex("9a7fffffff"), decoded));
+        CHECK(decoded.empty());
+        CHECK(decoded.capacity() <= 5);
+
+        // A log claiming 0x7fffffff topics
+        CHECK(!cbor_decode(*from_hex("818354ea674fdde714fd979de3edf0f56aa9716b898ec89a7fffffff"), decoded));
+        CHECK(decoded.empty());
+    }
+}
+
+}  // namespace silkworm
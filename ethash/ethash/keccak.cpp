@@ -24,10 +24,19 @@ static inline ALWAYS_INLINE uint64_t load_le(const uint8_t* data) {
     return le::uint64(word);
 }
 
+// Vector words (see keccak256_lanes) are only passed to always inlined functions, never across an ABI boundary
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
 /// Rotates the bits of x left by the count value specified by s.
 /// The s must be in range <0, 64> exclusively, otherwise the result is undefined.
 /// https://blog.regehr.org/archives/1063
-static inline uint64_t rotl_64(uint64_t x, unsigned s) { return (x << s) | (x >> (-s & 63)); }
+/// The W may also be a vector of 64-bit words, every lane then being rotated by s.
+template <typename W>
+static inline ALWAYS_INLINE W rotl_64(W x, unsigned s) {
+    return (x << s) | (x >> (-s & 63));
+}
 
 constexpr uint64_t round_constants[24] = {  //
     0x0000000000000001, 0x0000000000008082, 0x800000000000808a, 0x8000000080008000, 0x000000000000808b,
@@ -42,26 +51,29 @@ constexpr uint64_t round_constants[24] = {  //
 /// The size of the state is also 1600 bit what gives 25 64-bit words.
 ///
 /// @param state  The state of 25 64-bit words on which the permutation is to be performed.
+///               The W may also be a vector type, lane i of every word then making up the state
+///               of an independent permutation (see keccak256_many).
 ///
 /// The implementation based on:
 /// - "simple" implementation by Ronny Van Keer, included in "Reference and optimized code in C",
 ///   https://keccak.team/archives.html, CC0-1.0 / Public Domain.
-static inline ALWAYS_INLINE void keccakf1600_implementation(uint64_t state[25]) {
-    uint64_t Aba, Abe, Abi, Abo, Abu;
-    uint64_t Aga, Age, Agi, Ago, Agu;
-    uint64_t Aka, Ake, Aki, Ako, Aku;
-    uint64_t Ama, Ame, Ami, Amo, Amu;
-    uint64_t Asa, Ase, Asi, Aso, Asu;
+template <typename W>
+static inline ALWAYS_INLINE void keccakf1600_implementation(W state[25]) {
+    W Aba, Abe, Abi, Abo, Abu;
+    W Aga, Age, Agi, Ago, Agu;
+    W Aka, Ake, Aki, Ako, Aku;
+    W Ama, Ame, Ami, Amo, Amu;
+    W Asa, Ase, Asi, Aso, Asu;
 
-    uint64_t Eba, Ebe, Ebi, Ebo, Ebu;
-    uint64_t Ega, Ege, Egi, Ego, Egu;
-    uint64_t Eka, Eke, Eki, Eko, Eku;
-    uint64_t Ema, Eme, Emi, Emo, Emu;
-    uint64_t Esa, Ese, Esi, Eso, Esu;
+    W Eba, Ebe, Ebi, Ebo, Ebu;
+    W Ega, Ege, Egi, Ego, Egu;
+    W Eka, Eke, Eki, Eko, Eku;
+    W Ema, Eme, Emi, Emo, Emu;
+    W Esa, Ese, Esi, Eso, Esu;
 
-    uint64_t Ba, Be, Bi, Bo, Bu;
+    W Ba, Be, Bi, Bo, Bu;
 
-    uint64_t Da, De, Di, Do, Du;
+    W Da, De, Di, Do, Du;
 
     Aba = state[0];
     Abe = state[1];
@@ -262,11 +274,98 @@ static void keccakf1600_generic(uint64_t state[25]) { keccakf1600_implementation
 /// selected during runtime initialization.
 static void (*keccakf1600_best)(uint64_t[25]) = keccakf1600_generic;
 
+static void keccak256_many_generic(hash256* out, const uint8_t* const* inputs, const size_t* input_sizes,
+                                   size_t count) {
+    for (size_t i{0}; i < count; ++i) {
+        out[i] = keccak256(inputs[i], input_sizes[i]);
+    }
+}
+
+/// The pointer to the best keccak256_many implementation,
+/// selected during runtime initialization.
+static void (*keccak256_many_best)(hash256*, const uint8_t* const*, const size_t*, size_t) = keccak256_many_generic;
+
 #if defined(__x86_64__) && __has_attribute(target)
 __attribute__((target("bmi,bmi2"))) static void keccakf1600_bmi(uint64_t state[25]) {
     keccakf1600_implementation(state);
 }
 
+/// Vectors of 64-bit words, one word per lane.
+typedef uint64_t uint64x4 __attribute__((vector_size(32)));
+typedef uint64_t uint64x8 __attribute__((vector_size(64)));
+
+/// Keccak-256 of Lanes inputs at once, lane i of the state words carrying the permutation of input i.
+///
+/// The lanes are absorbed in lockstep: the state of a lane whose input is exhausted keeps on being permuted
+/// along with the others, its hash having been squeezed out right after the permutation of its padded block.
+/// Inputs of similar sizes thus make the best use of the lanes.
+template <typename W, size_t Lanes>
+static inline ALWAYS_INLINE void keccak256_lanes(hash256* out, const uint8_t* const* inputs,
+                                                 const size_t* input_sizes) {
+    static constexpr size_t word64_size{sizeof(uint64_t)};
+    static constexpr size_t block_size{(1600 - 256 * 2) / 8};
+    static constexpr size_t block_word64s{block_size / word64_size};
+
+    // Index of the padded (last) block of each lane
+    size_t last_block[Lanes];
+    size_t num_blocks{0};
+    for (size_t lane{0}; lane < Lanes; ++lane) {
+        last_block[lane] = input_sizes[lane] / block_size;
+        if (last_block[lane] >= num_blocks) num_blocks = last_block[lane] + 1;
+    }
+
+    W state[25]{};
+    for (size_t b{0}; b < num_blocks; ++b) {
+        // Block words transposed to lanes, zero for the lanes already squeezed
+        uint64_t words[block_word64s][Lanes]{};
+        for (size_t lane{0}; lane < Lanes; ++lane) {
+            if (b < last_block[lane]) {
+                const uint8_t* block{inputs[lane] + b * block_size};
+                for (size_t i{0}; i < block_word64s; ++i) words[i][lane] = load_le(block + i * word64_size);
+            } else if (b == last_block[lane]) {
+                uint8_t padded[block_size]{};
+                const size_t remaining{input_sizes[lane] - b * block_size};
+                if (remaining) __builtin_memcpy(padded, inputs[lane] + b * block_size, remaining);
+                padded[remaining] = 0x01;
+                padded[block_size - 1] |= 0x80;
+                for (size_t i{0}; i < block_word64s; ++i) words[i][lane] = load_le(padded + i * word64_size);
+            }
+        }
+        for (size_t i{0}; i < block_word64s; ++i) {
+            W word;
+            __builtin_memcpy(&word, words[i], sizeof(word));
+            state[i] ^= word;
+        }
+
+        keccakf1600_implementation(state);
+
+        for (size_t lane{0}; lane < Lanes; ++lane) {
+            if (b != last_block[lane]) continue;
+            for (size_t i{0}; i < 4; ++i) out[lane].word64s[i] = le::uint64(state[i][lane]);
+        }
+    }
+}
+
+template <typename W, size_t Lanes>
+static inline ALWAYS_INLINE void keccak256_many_lanes(hash256* out, const uint8_t* const* inputs,
+                                                      const size_t* input_sizes, size_t count) {
+    size_t i{0};
+    for (; i + Lanes <= count; i += Lanes) {
+        keccak256_lanes<W, Lanes>(out + i, inputs + i, input_sizes + i);
+    }
+    keccak256_many_generic(out + i, inputs + i, input_sizes + i, count - i);
+}
+
+__attribute__((target("avx2"))) static void keccak256_many_avx2(hash256* out, const uint8_t* const* inputs,
+                                                                 const size_t* input_sizes, size_t count) {
+    keccak256_many_lanes<uint64x4, 4>(out, inputs, input_sizes, count);
+}
+
+__attribute__((target("avx512f"))) static void keccak256_many_avx512(hash256* out, const uint8_t* const* inputs,
+                                                                     const size_t* input_sizes, size_t count) {
+    keccak256_many_lanes<uint64x8, 8>(out, inputs, input_sizes, count);
+}
+
 __attribute__((constructor)) static void select_keccakf1600_implementation() {
     // Init CPU information.
     // This is needed on macOS because of the bug: https://bugs.llvm.org/show_bug.cgi?id=48459.
@@ -275,6 +374,11 @@ __attribute__((constructor)) static void select_keccakf1600_implementation() {
     // Check if both BMI and BMI2 are supported. Some CPUs like Intel E5-2697 v2 incorrectly
     // report BMI2 but not BMI being available.
     if (__builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2")) keccakf1600_best = keccakf1600_bmi;
+
+    if (__builtin_cpu_supports("avx512f"))
+        keccak256_many_best = keccak256_many_avx512;
+    else if (__builtin_cpu_supports("avx2"))
+        keccak256_many_best = keccak256_many_avx2;
 }
 #endif
 
@@ -332,6 +436,10 @@ hash256 keccak256(const uint8_t* input, size_t input_size) {
 
 hash256 keccak256(const hash256& input) { return keccak256(input.bytes, sizeof(input)); }
 
+void keccak256_many(hash256* out, const uint8_t* const* inputs, const size_t* input_sizes, size_t count) {
+    keccak256_many_best(out, inputs, input_sizes, count);
+}
+
 hash512 keccak512(const uint8_t* input, size_t input_size) {
     hash512 out{};
     keccak(out.word64s, 512, input, input_size);
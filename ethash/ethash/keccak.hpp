@@ -19,6 +19,11 @@ namespace ethash {
 
 hash256 keccak256(const uint8_t* input, size_t input_size);
 hash256 keccak256(const hash256& input);
+
+/// Computes out[i] = keccak256(inputs[i], input_sizes[i]) for the count inputs, hashing several of them
+/// at once in the SIMD lanes (AVX2 or AVX-512) of CPUs supporting it.
+void keccak256_many(hash256* out, const uint8_t* const* inputs, const size_t* input_sizes, size_t count);
+
 hash512 keccak512(const uint8_t* input, size_t input_size);
 hash512 keccak512(const hash512& input);
 
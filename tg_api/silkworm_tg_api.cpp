@@ -16,7 +16,10 @@
 
 #include "silkworm_tg_api.h"
 
+#include <algorithm>
 #include <cassert>
+#include <exception>
+#include <thread>
 
 #include <gsl/gsl_util>
 
@@ -25,12 +28,66 @@
 #include <silkworm/common/magic_enum.hpp>
 #include <silkworm/db/access_layer.hpp>
 #include <silkworm/db/buffer.hpp>
+#include <silkworm/db/prefetcher.hpp>
+#include <silkworm/db/senders.hpp>
+#include <silkworm/db/state_cache.hpp>
 #include <silkworm/execution/execution.hpp>
 
+namespace {
+
+// Plain state cache surviving across batches, i.e. calls to silkworm_execute_blocks
+// Capacities may be changed through silkworm_set_state_cache_capacity
+std::unique_ptr<silkworm::db::StateCache>& state_cache_instance() {
+    static std::unique_ptr<silkworm::db::StateCache> cache;
+    return cache;
+}
+
+silkworm::db::StateCache& state_cache() {
+    static constexpr size_t kDefaultMaxAccounts{1'000'000};
+    static constexpr size_t kDefaultMaxStorageSlots{4'000'000};
+    std::unique_ptr<silkworm::db::StateCache>& cache{state_cache_instance()};
+    if (!cache) {
+        cache = std::make_unique<silkworm::db::StateCache>(kDefaultMaxAccounts, kDefaultMaxStorageSlots);
+    }
+    return *cache;
+}
+
+// EVM analyses surviving across batches, i.e. calls to silkworm_execute_blocks
+silkworm::AnalysisCache& analysis_cache() {
+    static silkworm::AnalysisCache cache;
+    return cache;
+}
+
+}  // namespace
+
+SILKWORM_EXPORT SilkwormStatusCode silkworm_set_state_cache_capacity(uint64_t max_accounts,
+                                                                     uint64_t max_storage_slots,
+                                                                     uint64_t num_shards) SILKWORM_NOEXCEPT {
+    using namespace silkworm;
+    try {
+        state_cache_instance().reset();  // release the memory of the previous one first
+        state_cache_instance() = std::make_unique<db::StateCache>(
+            max_accounts, max_storage_slots, num_shards ? num_shards : db::StateCache::kDefaultNumShards);
+        return SilkwormStatusCode::kSilkwormSuccess;
+    } catch (...) {
+        SILKWORM_LOG(LogLevel::Error) << "Unable to allocate state cache" << std::endl;
+        return SilkwormStatusCode::kSilkwormUnknownError;
+    }
+}
+
 SILKWORM_EXPORT SilkwormStatusCode silkworm_execute_blocks(MDB_txn* mdb_txn, uint64_t chain_id, uint64_t start_block,
                                                            uint64_t max_block, uint64_t batch_size, bool write_receipts,
                                                            uint64_t* last_executed_block,
                                                            int* lmdb_error_code) SILKWORM_NOEXCEPT {
+    return silkworm_execute_blocks_ex(mdb_txn, chain_id, start_block, max_block, batch_size, write_receipts,
+                                      last_executed_block, lmdb_error_code, /*prefetch_depth=*/0);
+}
+
+SILKWORM_EXPORT SilkwormStatusCode silkworm_execute_blocks_ex(MDB_txn* mdb_txn, uint64_t chain_id, uint64_t start_block,
+                                                              uint64_t max_block, uint64_t batch_size,
+                                                              bool write_receipts, uint64_t* last_executed_block,
+                                                              int* lmdb_error_code,
+                                                              uint64_t prefetch_depth) SILKWORM_NOEXCEPT {
     assert(mdb_txn);
 
     using namespace silkworm;
@@ -45,7 +102,7 @@ SILKWORM_EXPORT SilkwormStatusCode silkworm_execute_blocks(MDB_txn* mdb_txn, uin
 
     try {
         lmdb::Transaction txn{/*parent=*/nullptr, mdb_txn, /*flags=*/0};
-        auto cleanup{gsl::finally([&txn] { *txn.handle() = nullptr; })};  // avoid aborting mdb_txn
+        auto cleanup{gsl::finally([&txn] { txn.release(); })};  // close cursors but avoid aborting mdb_txn
 
         if (write_receipts && (!db::migration_happened(txn, "receipts_cbor_encode") ||
                                !db::migration_happened(txn, "receipts_store_logs_separately"))) {
@@ -66,17 +123,47 @@ SILKWORM_EXPORT SilkwormStatusCode silkworm_execute_blocks(MDB_txn* mdb_txn, uin
             return SilkwormStatusCode::kSilkwormIncompatibleDbFormat;
         }
 
-        db::Buffer buffer{&txn};
-        AnalysisCache analysis_cache;
+        db::StateCache& cache{state_cache()};
+        auto clear_cache_on_error{gsl::finally([&cache] {
+            if (std::uncaught_exceptions()) {
+                cache.clear();  // might have been partially updated
+            }
+        })};
+
+        db::Buffer buffer{&txn, /*historical_block=*/std::nullopt, &cache};
+        IntraBlockState state{buffer};
         ExecutionStatePool state_pool;
 
+        std::optional<db::BlockPrefetcher> prefetcher;
+        if (prefetch_depth) {
+            prefetcher.emplace(txn, start_block, max_block, prefetch_depth);
+        }
+
+        std::optional<uint64_t> last_block_num;
+        evmc::bytes32 last_block_hash{};
         for (; block_num <= max_block; ++block_num) {
-            std::optional<BlockWithHash> bh{db::read_block(txn, block_num, /*read_senders=*/true)};
+            std::optional<BlockWithHash> bh;
+            if (prefetcher) {
+                // Prefetched blocks come from last committed state : make sure it's still canonical
+                bh = prefetcher->next();
+                if (bh && db::read_canonical_hash(txn, block_num) != bh->hash) {
+                    bh.reset();
+                }
+            }
+            if (!bh) {
+                bh = db::read_block(txn, block_num, /*read_senders=*/true);
+            }
             if (!bh) {
                 return SilkwormStatusCode::kSilkwormBlockNotFound;
             }
 
-            auto [receipts, err]{execute_block(bh->block, buffer, *config, &analysis_cache, &state_pool)};
+            // Cached state is stale unless we're resuming right where the previous batch ended
+            // (i.e. no unwind nor aborted transaction happened in between)
+            if (block_num == start_block && !cache.extends(bh->block.header)) {
+                cache.clear();
+            }
+
+            auto [receipts, err]{execute_block(bh->block, state, *config, &analysis_cache(), &state_pool)};
             if (err != ValidationResult::kOk) {
                 SILKWORM_LOG(LogLevel::Error)
                     << "Validation error " << static_cast<int>(err) << " at block " << block_num << std::endl;
@@ -95,13 +182,22 @@ SILKWORM_EXPORT SilkwormStatusCode silkworm_execute_blocks(MDB_txn* mdb_txn, uin
                 SILKWORM_LOG(LogLevel::Info) << "Blocks <= " << block_num << " executed" << std::endl;
             }
 
+            last_block_num = block_num;
+            last_block_hash = bh->hash;
             if (buffer.current_batch_size() >= batch_size) {
-                buffer.write_to_db();
-                return SilkwormStatusCode::kSilkwormSuccess;
+                break;
             }
         };
 
         buffer.write_to_db();
+        if (last_block_num) {
+            cache.set_block(*last_block_num, last_block_hash);
+        }
+
+        const db::StateCache::Stats stats{cache.stats()};
+        SILKWORM_LOG(LogLevel::Debug) << "State cache accounts hits/misses " << stats.account_hits << "/"
+                                      << stats.account_misses << " storage hits/misses " << stats.storage_hits << "/"
+                                      << stats.storage_misses << std::endl;
         return SilkwormStatusCode::kSilkwormSuccess;
 
     } catch (const lmdb::exception& e) {
@@ -121,3 +217,60 @@ SILKWORM_EXPORT SilkwormStatusCode silkworm_execute_blocks(MDB_txn* mdb_txn, uin
         return SilkwormStatusCode::kSilkwormUnknownError;
     }
 }
+
+SILKWORM_EXPORT SilkwormStatusCode silkworm_recover_senders(MDB_txn* mdb_txn, uint64_t chain_id, uint64_t start_block,
+                                                            uint64_t max_block, uint64_t num_threads,
+                                                            uint64_t* last_block,
+                                                            int* lmdb_error_code) SILKWORM_NOEXCEPT {
+    assert(mdb_txn);
+
+    using namespace silkworm;
+
+    const ChainConfig* config{lookup_chain_config(chain_id)};
+    if (!config) {
+        SILKWORM_LOG(LogLevel::Error) << "Unsupported chain ID " << chain_id << std::endl;
+        return SilkwormStatusCode::kSilkwormUnknownChainId;
+    }
+
+    static constexpr size_t kBatchSize{100'000};  // transactions
+    if (!num_threads) {
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    try {
+        lmdb::Transaction txn{/*parent=*/nullptr, mdb_txn, /*flags=*/0};
+        auto cleanup{gsl::finally([&txn] { txn.release(); })};  // close cursors but avoid aborting mdb_txn
+
+        // https://github.com/ledgerwatch/turbo-geth/pull/1358
+        if (!db::migration_happened(txn, "tx_table_4")) {
+            SILKWORM_LOG(LogLevel::Error) << "Legacy stored transactions are not supported\n";
+            return SilkwormStatusCode::kSilkwormIncompatibleDbFormat;
+        }
+
+        db::SenderRecoverer recoverer{kBatchSize, num_threads};
+        std::optional<uint64_t> last_processed{db::recover_senders(txn, *config, start_block, max_block, recoverer)};
+        if (last_processed && last_block) {
+            *last_block = *last_processed;
+        }
+        if (!last_processed || *last_processed < max_block) {
+            return SilkwormStatusCode::kSilkwormBlockNotFound;
+        }
+        return SilkwormStatusCode::kSilkwormSuccess;
+
+    } catch (const lmdb::exception& e) {
+        if (lmdb_error_code) {
+            *lmdb_error_code = e.err();
+        }
+        SILKWORM_LOG(LogLevel::Error) << "LMDB error " << e.what() << std::endl;
+        return SilkwormStatusCode::kSilkwormLmdbError;
+    } catch (const db::SenderRecoveryError& ex) {
+        SILKWORM_LOG(LogLevel::Error) << ex.what() << std::endl;
+        return SilkwormStatusCode::kSilkwormInvalidBlock;
+    } catch (const rlp::DecodingError& ex) {
+        SILKWORM_LOG(LogLevel::Error) << ex.what() << std::endl;
+        return SilkwormStatusCode::kSilkwormDecodingError;
+    } catch (...) {
+        SILKWORM_LOG(LogLevel::Error) << "Unkown error recovering senders" << std::endl;
+        return SilkwormStatusCode::kSilkwormUnknownError;
+    }
+}
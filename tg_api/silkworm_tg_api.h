@@ -52,6 +52,21 @@ enum SilkwormStatusCode {
     kSilkwormUnknownError = -1
 };
 
+/** @brief Replaces the process-wide plain state cache used by silkworm_execute_blocks with an empty one.
+ *
+ * Hit/miss counters of the cache are logged (at debug level) after each batch, telling whether it's worth resizing.
+ * Must not be called concurrently with silkworm_execute_blocks.
+ *
+ * @param[in] max_accounts Capacity in number of accounts.
+ * @param[in] max_storage_slots Capacity in number of storage slots.
+ * @param[in] num_shards Number of independently locked shards (rounded up to a power of 2). Pass 0 for the default.
+ *
+ * @return kSilkwormSuccess(=0) on success, kSilkwormUnknownError if the cache could not be allocated.
+ */
+SILKWORM_EXPORT SilkwormStatusCode silkworm_set_state_cache_capacity(uint64_t max_accounts,
+                                                                     uint64_t max_storage_slots,
+                                                                     uint64_t num_shards) SILKWORM_NOEXCEPT;
+
 /** @brief Executes a batch of Ethereum blocks and writes resulting changes into the database.
  *
  * @param[in] txn Valid read-write LMDB transaction. Must not be NULL.
@@ -72,12 +87,50 @@ enum SilkwormStatusCode {
  * @return A non-zero error value on failure and kSilkwormSuccess(=0) on success.
  * kSilkwormBlockNotFound is probably OK: it simply means that the execution reached the end of the chain
  * (blocks up to and incl. last_executed_block were still executed).
+ *
+ * @note EVM code analyses and plain state values are cached in process-wide caches surviving across calls,
+ * hence this function must not be called concurrently.
  */
 SILKWORM_EXPORT SilkwormStatusCode silkworm_execute_blocks(MDB_txn* txn, uint64_t chain_id, uint64_t start_block,
                                                            uint64_t max_block, uint64_t batch_size, bool write_receipts,
                                                            uint64_t* last_executed_block,
                                                            int* lmdb_error_code) SILKWORM_NOEXCEPT;
 
+/** @brief Same as silkworm_execute_blocks, which reads blocks synchronously, with further options.
+ *
+ * @param[in] prefetch_depth How many blocks to read and decode ahead of execution on a separate thread.
+ * Pass 0 to read blocks synchronously.
+ */
+SILKWORM_EXPORT SilkwormStatusCode silkworm_execute_blocks_ex(MDB_txn* txn, uint64_t chain_id, uint64_t start_block,
+                                                              uint64_t max_block, uint64_t batch_size,
+                                                              bool write_receipts, uint64_t* last_executed_block,
+                                                              int* lmdb_error_code,
+                                                              uint64_t prefetch_depth) SILKWORM_NOEXCEPT;
+
+/** @brief Recovers the senders of the transactions of a range of canonical blocks and writes them into txSenders.
+ *
+ * @param[in] txn Valid read-write LMDB transaction. Must not be NULL.
+ * This function does not commit nor abort the transaction.
+ * @param[in] chain_id EIP-155 chain ID. kSilkwormUnknownChainId is returned in case of an unknown or unsupported chain.
+ * @param[in] start_block The block height to start the recovery from.
+ * @param[in] max_block Do not recover after this block.
+ * @param[in] num_threads How many threads to recover senders with. Pass 0 to use all the hardware threads.
+ *
+ * @param[out] last_block The height of the last block whose senders were written.
+ * Not written to if no blocks were processed, otherwise *last_block ≤ max_block.
+ * @param[out] lmdb_error_code If an LMDB error occurs (this function returns kSilkwormLmdbError)
+ * and lmdb_error_code isn't NULL, it's populated with the relevant LMDB error code.
+ *
+ * @return A non-zero error value on failure and kSilkwormSuccess(=0) on success.
+ * kSilkwormBlockNotFound means that the recovery reached the end of the chain before max_block
+ * (senders of blocks up to and incl. last_block were still written).
+ * kSilkwormInvalidBlock is returned if any transaction signature is invalid.
+ */
+SILKWORM_EXPORT SilkwormStatusCode silkworm_recover_senders(MDB_txn* txn, uint64_t chain_id, uint64_t start_block,
+                                                            uint64_t max_block, uint64_t num_threads,
+                                                            uint64_t* last_block,
+                                                            int* lmdb_error_code) SILKWORM_NOEXCEPT;
+
 #if __cplusplus
 }
 #endif